@@ -10,62 +10,156 @@ struct Light
   float quadratic_attenuation;
   float cone_angle;
   vec3 cone_direction;
-  float quantization_bandwidth;
   int number_quantized_bands;
 };
 
-const int MAX_LIGHTS = 8;
-
 in vec2 uv;
 flat in uint unit;
 in vec3 surface_pos;
 
 layout(location = 0)out vec4 fragColor;
 
+//Samplers the variant binds, see ShaderManager::getVariant
+//The light grid and accumulation buffer take four of the 16 samplers, the lightmap another one
+#ifndef TILESET_COUNT
+#ifdef LIGHTMAP
+#define TILESET_COUNT 11
+#else
+#define TILESET_COUNT 12
+#endif
+#endif
+#if defined(LIGHTMAP) && TILESET_COUNT > 11
+#error "A lightmapped variant has room for 11 tilesets"
+#endif
+
 uniform sampler2D tileset0;
+#if TILESET_COUNT > 1
 uniform sampler2D tileset1;
+#endif
+#if TILESET_COUNT > 2
 uniform sampler2D tileset2;
+#endif
+#if TILESET_COUNT > 3
 uniform sampler2D tileset3;
+#endif
+#if TILESET_COUNT > 4
 uniform sampler2D tileset4;
+#endif
+#if TILESET_COUNT > 5
 uniform sampler2D tileset5;
+#endif
+#if TILESET_COUNT > 6
 uniform sampler2D tileset6;
+#endif
+#if TILESET_COUNT > 7
 uniform sampler2D tileset7;
+#endif
+#if TILESET_COUNT > 8
 uniform sampler2D tileset8;
+#endif
+#if TILESET_COUNT > 9
 uniform sampler2D tileset9;
+#endif
+#if TILESET_COUNT > 10
 uniform sampler2D tileset10;
+#endif
+#if TILESET_COUNT > 11
 uniform sampler2D tileset11;
-
-uniform int num_lights;
-uniform Light lights[MAX_LIGHTS];
+#endif
+
+//Light grid, see Graphics::LightGrid for the layout
+uniform samplerBuffer light_data;
+uniform usamplerBuffer light_cells;
+uniform usamplerBuffer light_indices;
+//Lights added up by the deferred pass, see Graphics::LightAccumulationBuffer
+uniform sampler2D light_accumulation;
+#ifdef LIGHTMAP
+//Baked static lights
+uniform sampler2D lightmap;
+uniform vec4 lightmap_bounds;
+#endif
 
 uniform vec3 ambient_color;    //ambient RGB
 uniform float ambient_intensity;
 
 vec4 selectTexel(uint unit) {
-  if(unit == 0u)
-    return texture(tileset0, uv);
+#if TILESET_COUNT > 1
   if(unit == 1u)
     return texture(tileset1, uv);
+#endif
+#if TILESET_COUNT > 2
   if(unit == 2u)
     return texture(tileset2, uv);
+#endif
+#if TILESET_COUNT > 3
   if(unit == 3u)
     return texture(tileset3, uv);
+#endif
+#if TILESET_COUNT > 4
   if(unit == 4u)
     return texture(tileset4, uv);
+#endif
+#if TILESET_COUNT > 5
   if(unit == 5u)
     return texture(tileset5, uv);
+#endif
+#if TILESET_COUNT > 6
   if(unit == 6u)
     return texture(tileset6, uv);
+#endif
+#if TILESET_COUNT > 7
   if(unit == 7u)
     return texture(tileset7, uv);
+#endif
+#if TILESET_COUNT > 8
   if(unit == 8u)
     return texture(tileset8, uv);
+#endif
+#if TILESET_COUNT > 9
   if(unit == 9u)
     return texture(tileset9, uv);
+#endif
+#if TILESET_COUNT > 10
   if(unit == 10u)
     return texture(tileset10, uv);
+#endif
+#if TILESET_COUNT > 11
   if(unit == 11u)
     return texture(tileset11, uv);
+#endif
+  //Unit 0, and units past the count
+  return texture(tileset0, uv);
+}
+
+Light fetchLight(int index) {
+  int base = 3 + index * 4;
+  vec4 position_intensity = texelFetch(light_data, base);
+  vec4 color_linear = texelFetch(light_data, base + 1);
+  vec4 quadratic_cone_bands = texelFetch(light_data, base + 2);
+  vec4 cone_direction = texelFetch(light_data, base + 3);
+
+  Light light;
+  light.position = position_intensity.xyz;
+  light.intensity = position_intensity.w;
+  light.color = color_linear.rgb;
+  light.linear_attenuation = color_linear.w;
+  light.quadratic_attenuation = quadratic_cone_bands.x;
+  light.cone_angle = quadratic_cone_bands.y;
+  light.number_quantized_bands = int(quadratic_cone_bands.z);
+  light.cone_direction = cone_direction.xyz;
+  return light;
+}
+
+//(offset, count) into light_indices for the cell holding a world position
+uvec2 lightCell(vec2 position) {
+  vec4 grid = texelFetch(light_data, 0);
+  ivec2 grid_size = ivec2(texelFetch(light_data, 1).xy);
+
+  ivec2 cell = ivec2(floor((position - grid.xy) / grid.z));
+  int cell_index = grid_size.x * grid_size.y;
+  if(all(greaterThanEqual(cell, ivec2(0))) && all(lessThan(cell, grid_size)))
+    cell_index = cell.y * grid_size.x + cell.x;
+  return texelFetch(light_cells, cell_index).rg;
 }
 
 vec3 applyLight(Light light, vec3 surface_color, vec3 normal, vec3 surface_pos) {
@@ -74,18 +168,22 @@ vec3 applyLight(Light light, vec3 surface_color, vec3 normal, vec3 surface_pos)
 
   float attenuation = 1.0 / ( 1.0 + (light.linear_attenuation * distance_to_light) + (light.quadratic_attenuation * distance_to_light * distance_to_light));
 
-  //cone restrictions (affects attenuation)
-  float light_to_surface_angle = degrees(acos(dot(-surface_to_light, normalize(light.cone_direction))));
-  if(light_to_surface_angle > light.cone_angle){
-    attenuation = 0.0;
+  //cone restrictions (affects attenuation), point lights use a full circle
+  if(light.cone_angle < 360.0) {
+    float light_to_surface_angle = degrees(acos(dot(-surface_to_light, normalize(light.cone_direction))));
+    if(light_to_surface_angle > light.cone_angle){
+      attenuation = 0.0;
+    }
   }
 
   //diffuse
   float diffuse_coefficient = max(0.0, dot(normal, surface_to_light));
+#ifdef QUANTIZED_BANDS
   //Should we quantize?
   if(light.number_quantized_bands > 0 && diffuse_coefficient > 0.0) {
     diffuse_coefficient = floor(diffuse_coefficient * float(light.number_quantized_bands + 1.0)) / float(light.number_quantized_bands + 1.0);
   }
+#endif
 
   vec3 diffuse = diffuse_coefficient * light.color * light.intensity;
 
@@ -98,8 +196,11 @@ vec3 applyLight(Light light, vec3 surface_color, vec3 normal, vec3 surface_pos)
 void main()
 {
   vec4 texel = selectTexel(unit);
+  //Opaque tiles never discard so early depth testing stays on
+#ifndef ALPHA_OPAQUE
   if(texel.a < 0.1)
     discard;
+#endif
 
   vec3 normal = vec3(0.0, 0.0, 1.0);
 
@@ -109,9 +210,24 @@ void main()
   vec3 ambient = ambient_color.rgb * ambient_intensity * texel.rgb;
 
 
-  for(int i = 0; i < num_lights; i++) {
-    final_color += applyLight(lights[i], texel.rgb, normal, surface_pos);
+  //The deferred pass covered a world rectangle, an empty one means lighting is forward
+  vec4 accumulation_bounds = texelFetch(light_data, 2);
+  if(accumulation_bounds.z > 0.0) {
+    vec2 accumulation_uv = (surface_pos.xy - accumulation_bounds.xy) / accumulation_bounds.zw;
+    final_color = texel.rgb * texture(light_accumulation, accumulation_uv).rgb;
   }
+  else {
+    uvec2 cell = lightCell(surface_pos.xy);
+    for(uint i = 0u; i < cell.y; i++) {
+      int light_index = int(texelFetch(light_indices, int(cell.x + i)).r);
+      final_color += applyLight(fetchLight(light_index), texel.rgb, normal, surface_pos);
+    }
+  }
+
+#ifdef LIGHTMAP
+  vec2 lightmap_uv = (surface_pos.xy - lightmap_bounds.xy) / lightmap_bounds.zw;
+  final_color += texel.rgb * texture(lightmap, lightmap_uv).rgb;
+#endif
 
   fragColor = vec4(clamp(final_color + ambient, vec3(0.0), vec3(1.0)), texel.a);
 }
\ No newline at end of file
@@ -1,7 +1,12 @@
 #version 330 core
 precision highp float;
 
+#ifdef TILE_VERTEX
+//Map tiles in 1/16 tiles, see Graphics::TilePosition2s
+layout(location = 0)in vec2 tile_vert;
+#else
 layout(location = 0)in vec3 vert;
+#endif
 layout(location = 1)in vec2 tex;
 layout(location = 2)in uint texture_unit;
 
@@ -15,6 +20,9 @@ uniform mat4 view;
 
 void main()
 {
+#ifdef TILE_VERTEX
+  vec3 vert = vec3(tile_vert / 16.0, 0.0);
+#endif
   gl_Position = (projection * view * transform) * vec4(vert, 1.0);
   surface_pos = (transform * vec4(vert, 1.0)).xyz;
   uv = tex;
@@ -0,0 +1,16 @@
+#version 330 core
+precision highp float;
+
+in vec2 uv;
+layout(location = 0)out vec4 fragColor;
+
+//Premultiplied alpha, see Graphics::LayerCache
+uniform sampler2D layer_cache;
+
+void main()
+{
+  vec4 texel = texture(layer_cache, uv);
+  if(texel.a < 0.1)
+    discard;
+  fragColor = texel;
+}
@@ -0,0 +1,21 @@
+#version 330 core
+precision highp float;
+
+layout(location = 0)in vec3 vert;
+layout(location = 1)in vec2 tex;
+
+out vec2 uv;
+
+uniform mat4 transform;
+uniform mat4 projection;
+uniform mat4 view;
+//The cached area in tiles
+uniform vec2 extent;
+//Where the cached area starts in the wrapping cache texture
+uniform vec2 texture_offset;
+
+void main()
+{
+  gl_Position = (projection * view * transform) * vec4(vert.xy * extent, vert.z, 1.0);
+  uv = tex + texture_offset;
+}
@@ -0,0 +1,42 @@
+#version 330 core
+precision highp float;
+
+in vec2 surface_pos;
+flat in int light_index;
+
+layout(location = 0)out vec4 fragColor;
+
+uniform samplerBuffer light_data;
+
+void main()
+{
+  int base = 3 + light_index * 4;
+  vec4 position_intensity = texelFetch(light_data, base);
+  vec4 color_linear = texelFetch(light_data, base + 1);
+  vec4 quadratic_cone_bands = texelFetch(light_data, base + 2);
+  vec3 cone_direction = texelFetch(light_data, base + 3).xyz;
+
+  vec3 light_pos = position_intensity.xyz;
+  vec3 surface_to_light = normalize(vec3(light_pos.xy - surface_pos, light_pos.z));
+  float distance_to_light = length(vec3(light_pos.xy - surface_pos, light_pos.z));
+
+  float attenuation = 1.0 / ( 1.0 + (color_linear.w * distance_to_light) + (quadratic_cone_bands.x * distance_to_light * distance_to_light));
+
+  //cone restrictions (affects attenuation), point lights use a full circle
+  if(quadratic_cone_bands.y < 360.0) {
+    float light_to_surface_angle = degrees(acos(dot(-surface_to_light, normalize(cone_direction))));
+    if(light_to_surface_angle > quadratic_cone_bands.y){
+      attenuation = 0.0;
+    }
+  }
+
+  //diffuse against a flat surface facing the camera
+  float diffuse_coefficient = max(0.0, surface_to_light.z);
+  int number_quantized_bands = int(quadratic_cone_bands.z);
+  if(number_quantized_bands > 0 && diffuse_coefficient > 0.0) {
+    diffuse_coefficient = floor(diffuse_coefficient * float(number_quantized_bands + 1.0)) / float(number_quantized_bands + 1.0);
+  }
+
+  vec3 intensity = attenuation * diffuse_coefficient * color_linear.rgb * position_intensity.w;
+  fragColor = vec4(clamp(intensity, vec3(0.0), vec3(1.0)), 1.0);
+}
@@ -0,0 +1,28 @@
+#version 330 core
+precision highp float;
+
+out vec2 surface_pos;
+flat out int light_index;
+
+//Light grid, see Graphics::LightGrid for the layout
+uniform samplerBuffer light_data;
+//The world rectangle the buffer covers (x, y, width, height)
+uniform vec4 bounds;
+
+void main()
+{
+  int base = 3 + gl_InstanceID * 4;
+  vec2 light_pos = texelFetch(light_data, base).xy;
+  float radius = texelFetch(light_data, base + 3).w;
+
+  //Triangle strip corners from the vertex id
+  vec2 corner = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1));
+  //Lights that never fall off cover the whole buffer
+  if(radius < 0.0)
+    surface_pos = bounds.xy + corner * bounds.zw;
+  else
+    surface_pos = light_pos + (corner * 2.0 - 1.0) * radius;
+
+  light_index = gl_InstanceID;
+  gl_Position = vec4((surface_pos - bounds.xy) / bounds.zw * 2.0 - 1.0, 0.0, 1.0);
+}
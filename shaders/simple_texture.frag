@@ -5,52 +5,102 @@ in vec2 uv;
 flat in int unit;
 layout(location = 0)out vec4 fragColor;
 
+//Samplers the variant binds, see ShaderManager::getVariant
+#ifndef TILESET_COUNT
+#define TILESET_COUNT 12
+#endif
+
 uniform sampler2D tileset0;
+#if TILESET_COUNT > 1
 uniform sampler2D tileset1;
+#endif
+#if TILESET_COUNT > 2
 uniform sampler2D tileset2;
+#endif
+#if TILESET_COUNT > 3
 uniform sampler2D tileset3;
+#endif
+#if TILESET_COUNT > 4
 uniform sampler2D tileset4;
+#endif
+#if TILESET_COUNT > 5
 uniform sampler2D tileset5;
+#endif
+#if TILESET_COUNT > 6
 uniform sampler2D tileset6;
+#endif
+#if TILESET_COUNT > 7
 uniform sampler2D tileset7;
+#endif
+#if TILESET_COUNT > 8
 uniform sampler2D tileset8;
+#endif
+#if TILESET_COUNT > 9
 uniform sampler2D tileset9;
+#endif
+#if TILESET_COUNT > 10
 uniform sampler2D tileset10;
+#endif
+#if TILESET_COUNT > 11
 uniform sampler2D tileset11;
+#endif
 
 vec4 selectTexel(int unit) {
-  if(unit == 0)
-    return texture(tileset0, uv);
-  else if(unit == 1)
+#if TILESET_COUNT > 1
+  if(unit == 1)
     return texture(tileset1, uv);
-  else if(unit == 2)
+#endif
+#if TILESET_COUNT > 2
+  if(unit == 2)
     return texture(tileset2, uv);
-  else if(unit == 3)
+#endif
+#if TILESET_COUNT > 3
+  if(unit == 3)
     return texture(tileset3, uv);
-  else if(unit == 4)
+#endif
+#if TILESET_COUNT > 4
+  if(unit == 4)
     return texture(tileset4, uv);
-  else if(unit == 5)
+#endif
+#if TILESET_COUNT > 5
+  if(unit == 5)
     return texture(tileset5, uv);
-  else if(unit == 6)
+#endif
+#if TILESET_COUNT > 6
+  if(unit == 6)
     return texture(tileset6, uv);
-  else if(unit == 7)
+#endif
+#if TILESET_COUNT > 7
+  if(unit == 7)
     return texture(tileset7, uv);
-  else if(unit == 8)
+#endif
+#if TILESET_COUNT > 8
+  if(unit == 8)
     return texture(tileset8, uv);
-  else if(unit == 9)
+#endif
+#if TILESET_COUNT > 9
+  if(unit == 9)
     return texture(tileset9, uv);
-  else if(unit == 10)
+#endif
+#if TILESET_COUNT > 10
+  if(unit == 10)
     return texture(tileset10, uv);
-  else if(unit == 11)
+#endif
+#if TILESET_COUNT > 11
+  if(unit == 11)
     return texture(tileset11, uv);
-  else
-    return vec4(1.0, 1.0, 1.0, 1.0);
+#endif
+  //Unit 0, and units past the count
+  return texture(tileset0, uv);
 }
 
 void main()
 {
   vec4 texel = selectTexel(unit); 
+  //Opaque tiles never discard so early depth testing stays on
+#ifndef ALPHA_OPAQUE
   if(texel.a < 0.1)
     discard;
+#endif
   fragColor = texel;
 }
\ No newline at end of file
@@ -1,9 +1,16 @@
 #version 330 core
 precision highp float;
 
+#ifdef TILE_VERTEX
+//Map tiles in 1/16 tiles with an 8 bit unit, see Graphics::TilePosition2s
+layout(location = 0)in vec2 tile_vert;
+layout(location = 1)in vec2 tex;
+layout(location = 2)in uint tex_unit;
+#else
 layout(location = 0)in vec3 vert;
 layout(location = 1)in vec2 tex;
 layout(location = 2)in int tex_unit;
+#endif
 
 out vec2 uv;
 flat out int unit;
@@ -14,7 +21,12 @@ uniform mat4 view;
 
 void main()
 {
+#ifdef TILE_VERTEX
+  vec3 vert = vec3(tile_vert / 16.0, 0.0);
+  unit = int(tex_unit);
+#else
+  unit = tex_unit;
+#endif
   gl_Position = (projection * view * transform) * vec4(vert, 1.0);
   uv = tex;
-  unit = tex_unit;
 }
\ No newline at end of file
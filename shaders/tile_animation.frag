@@ -5,44 +5,93 @@ in vec2 uv;
 flat in uint unit;
 layout(location = 0)out vec4 fragColor;
 
+//Samplers the variant binds, see ShaderManager::getVariant
+#ifndef TILESET_COUNT
+#define TILESET_COUNT 12
+#endif
+
 uniform sampler2D tileset0;
+#if TILESET_COUNT > 1
 uniform sampler2D tileset1;
+#endif
+#if TILESET_COUNT > 2
 uniform sampler2D tileset2;
+#endif
+#if TILESET_COUNT > 3
 uniform sampler2D tileset3;
+#endif
+#if TILESET_COUNT > 4
 uniform sampler2D tileset4;
+#endif
+#if TILESET_COUNT > 5
 uniform sampler2D tileset5;
+#endif
+#if TILESET_COUNT > 6
 uniform sampler2D tileset6;
+#endif
+#if TILESET_COUNT > 7
 uniform sampler2D tileset7;
+#endif
+#if TILESET_COUNT > 8
 uniform sampler2D tileset8;
+#endif
+#if TILESET_COUNT > 9
 uniform sampler2D tileset9;
+#endif
+#if TILESET_COUNT > 10
 uniform sampler2D tileset10;
+#endif
+#if TILESET_COUNT > 11
 uniform sampler2D tileset11;
+#endif
 
 vec4 selectTexel(uint unit) {
-  if(unit == 0u)
-    return texture(tileset0, uv);
+#if TILESET_COUNT > 1
   if(unit == 1u)
     return texture(tileset1, uv);
+#endif
+#if TILESET_COUNT > 2
   if(unit == 2u)
     return texture(tileset2, uv);
+#endif
+#if TILESET_COUNT > 3
   if(unit == 3u)
     return texture(tileset3, uv);
+#endif
+#if TILESET_COUNT > 4
   if(unit == 4u)
     return texture(tileset4, uv);
+#endif
+#if TILESET_COUNT > 5
   if(unit == 5u)
     return texture(tileset5, uv);
+#endif
+#if TILESET_COUNT > 6
   if(unit == 6u)
     return texture(tileset6, uv);
+#endif
+#if TILESET_COUNT > 7
   if(unit == 7u)
     return texture(tileset7, uv);
+#endif
+#if TILESET_COUNT > 8
   if(unit == 8u)
     return texture(tileset8, uv);
+#endif
+#if TILESET_COUNT > 9
   if(unit == 9u)
     return texture(tileset9, uv);
+#endif
+#if TILESET_COUNT > 10
   if(unit == 10u)
     return texture(tileset10, uv);
+#endif
+#if TILESET_COUNT > 11
   if(unit == 11u)
     return texture(tileset11, uv);
+#endif
+  //Unit 0, and units past the count
+  return texture(tileset0, uv);
 }
 
 void main()
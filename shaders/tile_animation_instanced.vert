@@ -0,0 +1,53 @@
+#version 330 core
+precision highp float;
+
+layout(location = 0)in vec3 vert;
+layout(location = 1)in vec2 tex;
+layout(location = 2)in uint texture_unit;
+layout(location = 4)in vec3 instance_offset;
+//With GPU_ANIMATION x holds the row of the frame table this instance plays
+layout(location = 5)in ivec2 instance_tile_coord;
+
+out vec2 uv;
+flat out uint unit;
+
+uniform mat4 transform;
+uniform mat4 projection;
+uniform mat4 view;
+uniform vec2 tile_coord_multiplier;
+
+#ifdef GPU_ANIMATION
+uniform isampler2D frame_table;
+uniform float animation_time;
+
+ivec2 selectFrame(int animation) {
+  //(frame count, total duration)
+  ivec4 header = texelFetch(frame_table, ivec2(0, animation), 0);
+  ivec2 tile_coord = texelFetch(frame_table, ivec2(1, animation), 0).xy;
+  if(header.y <= 0)
+    return tile_coord;
+
+  int time = int(mod(animation_time, float(header.y)));
+  for(int i = 1; i <= header.x; i++) {
+    //(tile x, tile y, start time, duration)
+    ivec4 frame = texelFetch(frame_table, ivec2(i, animation), 0);
+    if(time >= frame.z && time < frame.z + frame.w) {
+      tile_coord = frame.xy;
+      break;
+    }
+  }
+  return tile_coord;
+}
+#endif
+
+void main()
+{
+  gl_Position = (projection * view * transform) * vec4(vert + instance_offset, 1.0);
+
+#ifdef GPU_ANIMATION
+  uv = tex * tile_coord_multiplier + vec2(selectFrame(instance_tile_coord.x)) * tile_coord_multiplier;
+#else
+  uv = tex * tile_coord_multiplier + vec2(instance_tile_coord) * tile_coord_multiplier;
+#endif
+  unit = texture_unit;
+}
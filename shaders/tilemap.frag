@@ -0,0 +1,96 @@
+#version 330 core
+precision highp float;
+
+in vec2 map_uv;
+layout(location = 0)out vec4 fragColor;
+
+//(tile x, tile y, tileset unit + 1, flip bits) per cell, unit 0 means the cell is empty
+uniform usampler2D tile_map;
+uniform vec2 tile_uv_size[12];
+
+uniform sampler2D tileset0;
+uniform sampler2D tileset1;
+uniform sampler2D tileset2;
+uniform sampler2D tileset3;
+uniform sampler2D tileset4;
+uniform sampler2D tileset5;
+uniform sampler2D tileset6;
+uniform sampler2D tileset7;
+uniform sampler2D tileset8;
+uniform sampler2D tileset9;
+uniform sampler2D tileset10;
+uniform sampler2D tileset11;
+
+const uint FLIP_HORIZONTAL = 1u;
+const uint FLIP_VERTICAL = 2u;
+const uint FLIP_DIAGONAL = 4u;
+
+//Same reflections and rotations as SceneGenerator::generateTextureCoords, around the cell center
+vec2 applyFlip(vec2 local, uint flip) {
+  bool diagonal = (flip & FLIP_DIAGONAL) != 0u;
+  bool horizontal = (flip & FLIP_HORIZONTAL) != 0u;
+  bool vertical = (flip & FLIP_VERTICAL) != 0u;
+
+  if(diagonal && horizontal && vertical)
+    return local * mat2(0.0, 1.0, 1.0, 0.0);
+  if(diagonal && horizontal)
+    return local * mat2(0.0, -1.0, 1.0, 0.0);
+  if(diagonal && vertical)
+    return local * mat2(0.0, 1.0, -1.0, 0.0);
+  if(horizontal && vertical)
+    return local * mat2(-1.0, 0.0, 0.0, -1.0);
+  if(diagonal)
+    return (local * mat2(0.0, -1.0, 1.0, 0.0)) * mat2(1.0, 0.0, 0.0, -1.0);
+  if(vertical)
+    return local * mat2(1.0, 0.0, 0.0, -1.0);
+  if(horizontal)
+    return local * mat2(-1.0, 0.0, 0.0, 1.0);
+  return local;
+}
+
+//Always sample the top level, the cell seams would otherwise select a tiny mip
+vec4 selectTexel(uint unit, vec2 uv) {
+  if(unit == 0u)
+    return textureLod(tileset0, uv, 0.0);
+  if(unit == 1u)
+    return textureLod(tileset1, uv, 0.0);
+  if(unit == 2u)
+    return textureLod(tileset2, uv, 0.0);
+  if(unit == 3u)
+    return textureLod(tileset3, uv, 0.0);
+  if(unit == 4u)
+    return textureLod(tileset4, uv, 0.0);
+  if(unit == 5u)
+    return textureLod(tileset5, uv, 0.0);
+  if(unit == 6u)
+    return textureLod(tileset6, uv, 0.0);
+  if(unit == 7u)
+    return textureLod(tileset7, uv, 0.0);
+  if(unit == 8u)
+    return textureLod(tileset8, uv, 0.0);
+  if(unit == 9u)
+    return textureLod(tileset9, uv, 0.0);
+  if(unit == 10u)
+    return textureLod(tileset10, uv, 0.0);
+  return textureLod(tileset11, uv, 0.0);
+}
+
+void main()
+{
+  ivec2 map_size = textureSize(tile_map, 0);
+  vec2 cell_position = map_uv * vec2(map_size);
+  ivec2 cell = clamp(ivec2(floor(cell_position)), ivec2(0), map_size - ivec2(1));
+
+  uvec4 tile = texelFetch(tile_map, cell, 0);
+  if(tile.z == 0u)
+    discard;
+
+  uint unit = tile.z - 1u;
+  vec2 local = applyFlip(fract(cell_position) - vec2(0.5), tile.w) + vec2(0.5);
+  vec2 uv = (vec2(tile.xy) + local) * tile_uv_size[unit];
+
+  vec4 texel = selectTexel(unit, uv);
+  if(texel.a < 0.1)
+    discard;
+  fragColor = texel;
+}
\ No newline at end of file
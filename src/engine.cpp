@@ -47,11 +47,16 @@ std::map<std::shared_ptr<Game::Scene>, bool> Engine::getScenes() const noexcept
 void Engine::activateScene(const std::string& name) {
   auto scene = findSceneByName(name);
 
-  if(scene != nullptr) {
+  if(scene != nullptr && scenes[scene] == false) {
     scenes[scene] = true;
+    //Loads textures evicted while the scene was inactive before anything draws with them
+    texture_manager->activateScene(name);
     component_manager->addComponents(scene->getComponents());
     for(auto c : scene->getComponents()) {
       c->onStart();
+      auto light = std::dynamic_pointer_cast<Graphics::Light>(c);
+      if(light != nullptr)
+        graphics_system->addLight(light);
     }
   }
 }
@@ -62,6 +67,12 @@ void Engine::deactivateScene(const std::string& name) {
   if(scene != nullptr && scenes[scene] == true) {
     scenes[scene] = false;
     component_manager->removeComponents(scene->getComponents());
+    for(auto c : scene->getComponents()) {
+      auto light = std::dynamic_pointer_cast<Graphics::Light>(c);
+      if(light != nullptr)
+        graphics_system->removeLight(light);
+    }
+    texture_manager->deactivateScene(name);
   }
 }
 
@@ -106,12 +117,15 @@ void Engine::setup(const std::string config_path) {
   //Initialize graphics system
   graphics_system->initialize(config_manager->getInt("screen_width"), config_manager->getInt("screen_height"), config_manager->getString("window_title"), config_manager->getBool("fullscreen"), Graphics::WindowExitFunctor());
   scripting_system->addGlobalObject<Graphics::GraphicsSystem>(graphics_system, "graphics_system");
+  shader_manager->setProgramCachePath(config_manager->getString("shader_cache_location"));
+  texture_manager->setBudget((size_t)config_manager->getUnsignedInt("vram_budget_mb") * 1024 * 1024);
   scripting_system->addGlobalObject<Graphics::ShaderManager>(shader_manager, "shader_manager");
   scripting_system->addGlobalObject<Graphics::TextureManager>(texture_manager, "texture_manager");
   scripting_system->addGlobalObject<Sound::SoundSystem>(sound_system, "sound_system");
 
   //Initialize font generator
   font_generator = std::make_shared<Graphics::UI::FontGenerator>(config_manager->getString("fonts_location"), config_manager->getInt("pixels_per_unit"));
+  font_generator->setGlyphCachePath(config_manager->getString("glyph_cache_location"));
 
   scripting_system->addGlobalObject<Graphics::UI::FontGenerator>(font_generator, "font_generator");
 
@@ -126,6 +140,8 @@ void Engine::setup(const std::string config_path) {
   scripting_system->addGlobalObject<Graphics::Camera>(camera_component, "camera");
 
   component_manager->addComponent(camera_component);
+  graphics_system->setCamera(camera_component);
+  graphics_system->setLightingMode(Graphics::GraphicsSystem::stringToLightingMode(config_manager->getString("lighting_mode")));
   //Initialize input system
   input_system = std::make_shared<Input::InputSystem>(graphics_system->getWindow(), viewport_tile_width, viewport_tile_height, camera_component->getTransform()->getAbsoluteTransformationMatrix(), camera_component->getProjectionMatrix());
   scripting_system->addGlobalObject<Input::InputSystem>(input_system, "input_system");
@@ -151,6 +167,7 @@ void Engine::mainLoop() {
     graphics_system->startFrame();
     component_manager->onUpdate(delta);
     graphics_system->stopFrame();
+    shader_manager->savePendingPrograms();
     sound_system->update(delta);
     input_system->pollForInput();
     scripting_system->update(delta);
@@ -1,6 +1,7 @@
 #ifndef ENTITY_H
 #define ENTITY_H
 
+#include <list>
 #include <vector>
 #include <memory>
 #include "component.h"
@@ -39,6 +40,25 @@ class [[scriptable]] Entity  : public std::enable_shared_from_this<Entity>  {
      * @return     The components.
      */
     [[scriptable]] std::list<std::shared_ptr<Component>>& getComponents() noexcept;
+    /**
+     * @brief      Gets the first component of a type.
+     *
+     * @detail     Components look their siblings up once in onStart and keep the reference,
+     * instead of talking to them through events every frame.
+     *
+     * @tparam     T     The component type
+     *
+     * @return     The component, nullptr if the entity has none of that type.
+     */
+    template<typename T>
+    std::shared_ptr<T> getComponent() const noexcept {
+      for(auto& component : components) {
+        auto casted = std::dynamic_pointer_cast<T>(component);
+        if(casted != nullptr)
+          return casted;
+      }
+      return nullptr;
+    }
     /**
      * @brief      Gets the transform.
      *
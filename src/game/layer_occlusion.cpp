@@ -0,0 +1,51 @@
+#include <easylogging++.h>
+#include <algorithm>
+#include "layer_occlusion.h"
+
+namespace Game {
+  void LayerOcclusion::addLayer(const unsigned int layer, std::shared_ptr<Entity> entity, const bool visible) {
+    layers[layer] = entity;
+    visible_layers[layer] = visible;
+    entity->setActive(visible);
+    refresh();
+  }
+
+  void LayerOcclusion::addOccludedGroup(const unsigned int layer, const std::vector<unsigned int>& occluders, std::shared_ptr<Entity> entity) {
+    groups.push_back(OccludedGroup{layer, occluders, entity});
+    entity->setActive(false);
+    refresh();
+  }
+
+  void LayerOcclusion::setLayerVisible(const unsigned int layer, const bool visible) {
+    auto layer_entity = layers.find(layer);
+    if(layer_entity == layers.end()) {
+      LOG(WARNING)<<"Layer: "<<layer<<" does not exist and can't be toggled";
+      return;
+    }
+
+    visible_layers[layer] = visible;
+    layer_entity->second->setActive(visible);
+    refresh();
+  }
+
+  bool LayerOcclusion::isLayerVisible(const unsigned int layer) const noexcept {
+    auto visible = visible_layers.find(layer);
+    return visible != visible_layers.end() && visible->second;
+  }
+
+  unsigned int LayerOcclusion::getOccludedGroupCount() const noexcept {
+    return groups.size();
+  }
+
+  void LayerOcclusion::refresh() noexcept {
+    for(auto& group : groups) {
+      //Tiles show through once every layer covering them is hidden
+      auto covered = std::any_of(group.occluders.begin(), group.occluders.end(), [this](const unsigned int occluder) {
+        return isLayerVisible(occluder);
+      });
+      auto active = isLayerVisible(group.layer) && !covered;
+      if(group.entity->isActive() != active)
+        group.entity->setActive(active);
+    }
+  }
+}
@@ -0,0 +1,73 @@
+#ifndef LAYER_OCCLUSION_H
+#define LAYER_OCCLUSION_H
+#include <map>
+#include <memory>
+#include <vector>
+#include "../entity.h"
+
+namespace Game {
+  /**
+   * @brief      Tracks map layer visibility and the tiles hidden under opaque tiles of higher layers.
+   *
+   * @detail     The scene generator leaves tiles covered by opaque tiles of higher layers out of
+   * their layer's patches. They're kept in groups of the same layer and the same covering layers
+   * instead, and a group is only active while its own layer is visible and all of its covering
+   * layers are hidden.
+   */
+  class [[scriptable]] LayerOcclusion {
+    private:
+      struct OccludedGroup {
+        unsigned int layer;
+        std::vector<unsigned int> occluders;
+        std::shared_ptr<Entity> entity;
+      };
+
+      std::map<unsigned int, std::shared_ptr<Entity>> layers;
+      std::map<unsigned int, bool> visible_layers;
+      std::vector<OccludedGroup> groups;
+
+      void refresh() noexcept;
+
+    public:
+      /**
+       * @brief      Adds a layer.
+       *
+       * @param[in]  layer    The layer number
+       * @param[in]  entity   The layer entity
+       * @param[in]  visible  True if the layer starts visible
+       */
+      void addLayer(const unsigned int layer, std::shared_ptr<Entity> entity, const bool visible);
+      /**
+       * @brief      Adds a group of tiles hidden by higher layers.
+       *
+       * @param[in]  layer      The layer number the tiles belong to
+       * @param[in]  occluders  The layer numbers covering the tiles
+       * @param[in]  entity     The entity holding the tiles
+       */
+      void addOccludedGroup(const unsigned int layer, const std::vector<unsigned int>& occluders, std::shared_ptr<Entity> entity);
+
+      /**
+       * @brief      Shows or hides a layer, and the tiles under it.
+       *
+       * @param[in]  layer    The layer number
+       * @param[in]  visible  True to show the layer
+       */
+      [[scriptable]] void setLayerVisible(const unsigned int layer, const bool visible);
+      /**
+       * @brief      Determines if a layer is visible.
+       *
+       * @param[in]  layer  The layer number
+       *
+       * @return     True if visible, False otherwise or if there is no such layer.
+       */
+      [[scriptable]] bool isLayerVisible(const unsigned int layer) const noexcept;
+      /**
+       * @brief      Gets the number of occluded tile groups.
+       *
+       * @return     The number of groups.
+       */
+      [[scriptable]] unsigned int getOccludedGroupCount() const noexcept;
+  };
+}
+
+#endif
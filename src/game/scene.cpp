@@ -36,6 +36,14 @@ namespace Game {
     return this->collision_data;
   }
 
+  void Scene::setLayerOcclusion(std::shared_ptr<LayerOcclusion> layer_occlusion) noexcept {
+    this->layer_occlusion = layer_occlusion;
+  }
+
+  std::shared_ptr<LayerOcclusion> Scene::getLayerOcclusion() const noexcept {
+    return this->layer_occlusion;
+  }
+
   void Scene::addEntity(std::shared_ptr<Entity> entity) noexcept {
     this->entities.push_back(entity);
     this->transform->addChild(entity->getTransform());
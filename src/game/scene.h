@@ -6,6 +6,7 @@
 #include "../transform.h"
 #include "../component.h"
 #include "../entity.h"
+#include "layer_occlusion.h"
 
 namespace Game {
   /**
@@ -18,6 +19,7 @@ namespace Game {
       std::vector<std::shared_ptr<Entity>> entities;
       std::string name;
       std::shared_ptr<Physics::CollisionData> collision_data;
+      std::shared_ptr<LayerOcclusion> layer_occlusion;
 
     public:
       Scene() = delete;
@@ -70,6 +72,18 @@ namespace Game {
        * @return     The collision data.
        */
       [[scriptable]] std::shared_ptr<Physics::CollisionData> getCollisionData() const noexcept;
+      /**
+       * @brief      Sets the layer occlusion.
+       *
+       * @param[in]  layer_occlusion  The layer occlusion of the map layers
+       */
+      [[scriptable]] void setLayerOcclusion(std::shared_ptr<LayerOcclusion> layer_occlusion) noexcept;
+      /**
+       * @brief      Gets the layer occlusion.
+       *
+       * @return     The layer occlusion, nullptr if the scene has no map layers.
+       */
+      [[scriptable]] std::shared_ptr<LayerOcclusion> getLayerOcclusion() const noexcept;
       /**
        * @brief      Adds an entity.
        *
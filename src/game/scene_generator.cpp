@@ -8,16 +8,27 @@
 #include <algorithm>
 #include <sstream>
 #include <functional>
+#include <limits>
+#include <set>
+#include <stdexcept>
+#include <tuple>
 #include <tmx/Tmx.h>
 #include "scene_generator.h"
 #include "graphics/renderable.h"
 #include "transform.h"
 #include "exceptions/invalid_filename_exception.h"
 #include "graphics/light.h"
+#include "graphics/lightmap.h"
+#include "graphics/instanced_renderable.h"
+#include "graphics/instanced_tile_animator.h"
+#include "graphics/tilemap_renderable.h"
+#include "graphics/layer_cache.h"
+#include "graphics/patch_batch.h"
+#include "graphics/gpu_resource.h"
 #include "utility/utility_functions.h"
 
 namespace Game {
-  SceneGenerator::SceneGenerator(const Map& animation_index, std::shared_ptr<Graphics::TextureManager> texture_manager, std::shared_ptr<Graphics::ShaderManager> shader_manager, const unsigned int ui_z_slots) : texture_manager(texture_manager), shader_manager(shader_manager), ui_z_slots(ui_z_slots) {
+  SceneGenerator::SceneGenerator(const Map& animation_index, std::shared_ptr<Graphics::TextureManager> texture_manager, std::shared_ptr<Graphics::ShaderManager> shader_manager, const unsigned int ui_z_slots) : texture_manager(texture_manager), shader_manager(shader_manager), ui_z_slots(ui_z_slots), gpu_tile_animation(false), tilemap_layers(false) {
     dynamic_animations = createAnimationsFromAnimationMap(animation_index);
   }
 
@@ -93,7 +104,7 @@ namespace Game {
     return -((float)total_layers - (float)layer_index + ui_z_slots);
   }
 
-  std::shared_ptr<Graphics::BaseTexture> SceneGenerator::textureFromTileset(const Tmx::Tileset* tileset, const std::string& path) {
+  std::string SceneGenerator::imagePathFromTileset(const Tmx::Tileset* tileset, const std::string& path) {
     //Get out of the map directory
     auto pos = path.find_last_of("/");
     auto new_path = path.substr(0, pos);
@@ -105,8 +116,10 @@ namespace Game {
     auto source = tileset_image->GetSource();
     //add path to the image source
     source.erase(0, 2);
-    source = new_path + source;
+    return new_path + source;
+  }
 
+  std::shared_ptr<Graphics::BaseTexture> SceneGenerator::loadSceneTexture(const std::string& source) {
     auto texture_name = Graphics::TextureManager::getNameFromPath(source);
 
     if(!texture_manager.lock()->textureExists(texture_name)) {
@@ -115,9 +128,30 @@ namespace Game {
       }
     }
 
+    //The scene being generated owns the registry, its textures can be evicted while it's inactive
+    texture_manager.lock()->addSceneTexture(Graphics::GPUResourceRegistry::getOwner(), texture_name);
     return (*texture_manager.lock())[texture_name];
   }
 
+  std::shared_ptr<Graphics::BaseTexture> SceneGenerator::textureFromTileset(const Tmx::Tileset* tileset, const std::string& path) {
+    auto source = imagePathFromTileset(tileset, path);
+
+    return loadSceneTexture(source);
+  }
+
+  std::shared_ptr<Graphics::TilesetAlpha> SceneGenerator::alphaFromTileset(const Tmx::Tileset* tileset, const std::string& path) {
+    auto source = imagePathFromTileset(tileset, path);
+
+    //Classified once per image, a failed load is remembered as nullptr too
+    auto found = tileset_alphas.find(source);
+    if(found != tileset_alphas.end())
+      return found->second;
+
+    auto tileset_alpha = Graphics::TilesetAlpha::load(source, tileset->GetTileWidth(), tileset->GetTileHeight());
+    tileset_alphas[source] = tileset_alpha;
+    return tileset_alpha;
+  }
+
   std::shared_ptr<Graphics::BaseTexture> SceneGenerator::normalTextureFromTileset(const Tmx::Tileset* tileset, const std::string& path) {
     //Get out of the map directory
     auto pos = path.find_last_of("/");
@@ -137,15 +171,7 @@ namespace Game {
     source.insert(extension_pos, "-Normal");
     source = new_path + source;
 
-    auto texture_name = Graphics::TextureManager::getNameFromPath(source);
-
-    if(!texture_manager.lock()->textureExists(texture_name)) {
-      if(!texture_manager.lock()->loadTexture(source)) {
-        throw Exceptions::InvalidFilenameException(source);
-      }
-    }
-
-    return (*texture_manager.lock())[texture_name];
+    return loadSceneTexture(source);
   }
 
   std::shared_ptr<Graphics::BaseTexture> SceneGenerator::displacementTextureFromTileset(const Tmx::Tileset* tileset, const std::string& path) {
@@ -167,15 +193,7 @@ namespace Game {
     source.insert(extension_pos, "-Displacement");
     source = new_path + source;
 
-    auto texture_name = Graphics::TextureManager::getNameFromPath(source);
-
-    if(!texture_manager.lock()->textureExists(texture_name)) {
-      if(!texture_manager.lock()->loadTexture(source)) {
-        throw Exceptions::InvalidFilenameException(source);
-      }
-    }
-
-    return (*texture_manager.lock())[texture_name];
+    return loadSceneTexture(source);
   }
 
   std::vector<glm::vec2> SceneGenerator::generateTextureCoords(const Tmx::TileLayer* layer, const unsigned int x_pos, const unsigned int y_pos, const unsigned int texture_width, const unsigned int texture_height, const unsigned int tile_width, const unsigned int tile_height) {
@@ -275,10 +293,24 @@ namespace Game {
 
   std::shared_ptr<Scene> SceneGenerator::createSceneFromMap(const unsigned int patch_width_tiles, const unsigned int patch_height_tiles, const Map& map) {
     auto scene = std::make_shared<Scene>(getStrippedMapName(map.getPath()));
+    //Everything uploaded for the map is counted against the scene
+    Graphics::GPUResourceOwnerScope owner(scene->getName());
+
+    //Static lights are baked once instead of staying live
+    std::vector<std::shared_ptr<Graphics::Light>> static_lights;
+    auto lights = createLightsFromMap(map, static_lights);
+
+    auto map_offset = glm::vec2(-map.getImpl()->GetWidth() / 2.0, -map.getImpl()->GetHeight() / 2.0);
+    auto lightmap_bounds = glm::vec4(map_offset, map.getImpl()->GetWidth(), map.getImpl()->GetHeight());
+    std::shared_ptr<Graphics::BaseTexture> lightmap = nullptr;
+    auto lighted = map.getImpl()->GetProperties().HasProperty("Lighted") && map.getImpl()->GetProperties().GetStringProperty("Lighted") == "True";
+    if(lighted && !static_lights.empty())
+      lightmap = bakeLightmap(map, static_lights);
 
-    auto map_renderables = createRenderablesFromMap(patch_width_tiles, patch_height_tiles, map);
+    auto map_renderables = createRenderablesFromMap(patch_width_tiles, patch_height_tiles, map, lightmap, lightmap_bounds);
 
     scene->addEntities(map_renderables.entities);
+    scene->setLayerOcclusion(map_renderables.layer_occlusion);
 
     for(auto placeholder : map_renderables.dynamic_animations) {
       auto new_entity = dynamic_animations[placeholder.sprite_name].entity;
@@ -294,15 +326,13 @@ namespace Game {
 
     scene->addEntities(static_animations);
 
-    auto lights = createLightsFromMap(map);
-
     scene->addComponents(lights);
 
     auto collision_data = createCollisionDataFromMap(map);
 
     scene->addComponent(collision_data);
 
-    scene->getTransform()->translate(glm::vec2(-map.getImpl()->GetWidth() / 2.0, -map.getImpl()->GetHeight() / 2.0));
+    scene->getTransform()->translate(map_offset);
 
     return scene;
   }
@@ -351,7 +381,7 @@ namespace Game {
     return collision_data;
   }
 
-  std::vector<std::shared_ptr<Component>> SceneGenerator::createLightsFromMap(const Map& map) {
+  std::vector<std::shared_ptr<Component>> SceneGenerator::createLightsFromMap(const Map& map, std::vector<std::shared_ptr<Graphics::Light>>& static_lights) {
     std::vector<std::shared_ptr<Component>> lights;
     std::vector<Tmx::Object*> light_map_objects;
     for(auto group : map.getImpl()->GetObjectGroups()) {
@@ -387,6 +417,9 @@ namespace Game {
       if(map_light->GetProperties().HasProperty("ConeDirection")) {
         new_light->setConeDirection(Utility::stringToVec3(map_light->GetProperties().GetStringProperty("ConeDirection")));
       }
+      if(map_light->GetProperties().HasProperty("QuantizedBands")) {
+        new_light->setNumberOfQuantizedBands(map_light->GetProperties().GetIntProperty("QuantizedBands"));
+      }
 
       new_light->setTransform(std::make_shared<Transform>());
       //Subtract y from height to flip the y coords. Tiled and I do it mirrored.
@@ -394,12 +427,45 @@ namespace Game {
       if(map_light->GetProperties().HasProperty("ZPosition")) {
         new_light->getTransform()->translate(glm::vec3(0.0f, 0.0f, map_light->GetProperties().GetFloatProperty("ZPosition")));
       }
-      lights.push_back(new_light);
+
+      if(map_light->GetProperties().HasProperty("Dynamic") && map_light->GetProperties().GetStringProperty("Dynamic") == "True")
+        lights.push_back(new_light);
+      else
+        static_lights.push_back(new_light);
     }
     return lights;
   }
 
+  bool SceneGenerator::castsQuantizedBands(const Map& map) {
+    //Lights added later by scripts can't be seen here, the map has to ask for bands up front
+    if(map.getImpl()->GetProperties().HasProperty("QuantizedBands") && map.getImpl()->GetProperties().GetStringProperty("QuantizedBands") == "True")
+      return true;
+
+    for(auto group : map.getImpl()->GetObjectGroups()) {
+      for(auto object : group->GetObjects()) {
+        auto& properties = object->GetProperties();
+        if(properties.HasProperty("Type") && properties.GetStringProperty("Type") == "Light" && properties.HasProperty("QuantizedBands") && properties.GetIntProperty("QuantizedBands") > 0)
+          return true;
+      }
+    }
+    return false;
+  }
+
+  std::shared_ptr<Graphics::BaseTexture> SceneGenerator::bakeLightmap(const Map& map, const std::vector<std::shared_ptr<Graphics::Light>>& static_lights) {
+    //Baked in map coordinates, the same ones the lights are placed in
+    Graphics::Lightmap lightmap(map.getImpl()->GetWidth() * LIGHTMAP_TEXELS_PER_TILE, map.getImpl()->GetHeight() * LIGHTMAP_TEXELS_PER_TILE, glm::vec4(0.0, 0.0, map.getImpl()->GetWidth(), map.getImpl()->GetHeight()));
+    lightmap.bake(static_lights);
+    return lightmap.createTexture();
+  }
+
   std::vector<std::shared_ptr<Entity>> SceneGenerator::createStaticallyAnimatedTilesFromMap(const Map& map) {
+    struct AnimatedTileBatch {
+      std::shared_ptr<Graphics::InstancedRenderable> renderable;
+      std::shared_ptr<Graphics::InstancedTileAnimator> animator;
+      //tile id to animation index in the animator
+      std::map<int, unsigned int> animation_indices;
+    };
+
     std::vector<std::shared_ptr<Entity>> animations;
     auto layers = map.getImpl()->GetTileLayers();
     auto tilesets = map.getImpl()->GetTilesets();
@@ -407,62 +473,345 @@ namespace Game {
     unsigned int layer_index = 0;
 
     for(auto layer : layers) {
+      //One instanced batch per tileset on this layer, keyed by tileset index
+      std::map<int, AnimatedTileBatch> batches;
+
       for(int y = 0; y < layer->GetHeight(); y++) {
         for(int x = 0; x < layer->GetWidth(); x++) {
-          if(layer->GetTileTilesetIndex(x, y) >= 0) {
-            auto tileset = tilesets[layer->GetTileTilesetIndex(x, y)];
+          auto tileset_index = layer->GetTileTilesetIndex(x, y);
+          if(tileset_index >= 0) {
+            auto tileset = tilesets[tileset_index];
 
-            auto tile = tileset->GetTile(layer->GetTileId(x, y));
-            auto texture = textureFromTileset(tileset, path);
-            unsigned int unit = 0;
+            auto tile_id = layer->GetTileId(x, y);
+            auto tile = tileset->GetTile(tile_id);
 
             if(tile != nullptr && tile->IsAnimated() && (!tile->GetProperties().HasProperty("AnimatedSprite") || tile->GetProperties().GetStringProperty("AnimatedSprite") == "False")) {
-              auto renderable = Graphics::Renderable::create(generateBasisTile(map.getImpl()->GetTileWidth(), map.getImpl()->GetTileHeight(), tileset->GetTileWidth(), tileset->GetTileHeight(), 0, 0));
-              auto animator = Graphics::TileAnimator<SpriteMovementMotor::SpriteState>::create(texture->getWidth(), texture->getHeight(), tileset->GetTileWidth(), tileset->GetTileHeight());
-
-              auto frames = tile->GetFrames();
+              auto texture = textureFromTileset(tileset, path);
+
+              if(batches.count(tileset_index) == 0) {
+                AnimatedTileBatch batch;
+                unsigned int unit = 0;
+
+                batch.renderable = Graphics::InstancedRenderable::create(generateBasisTile(map.getImpl()->GetTileWidth(), map.getImpl()->GetTileHeight(), tileset->GetTileWidth(), tileset->GetTileHeight(), 0, 0));
+                batch.renderable->addTexture(unit, "tileset0", texture);
+                //A batch only ever binds its own tileset
+                batch.renderable->setShader(shader_manager.lock()->getVariant("tile_animation_instanced", gpu_tile_animation ? "TILESET_COUNT=1 GPU_ANIMATION" : "TILESET_COUNT=1"));
+                batch.animator = Graphics::InstancedTileAnimator::create(batch.renderable, texture->getWidth(), texture->getHeight(), tileset->GetTileWidth(), tileset->GetTileHeight(), gpu_tile_animation);
+                //Frames picked on the CPU rewrite the instances every few frames
+                if(!gpu_tile_animation)
+                  batch.renderable->setStreamingBuffer(streaming_buffer);
+
+                batches[tileset_index] = batch;
+              }
 
-              renderable->addTexture(unit, "tileset0", texture);
+              auto& batch = batches[tileset_index];
 
-              for(auto frame : frames) {
-                auto id = frame.GetTileID();
-                auto duration = frame.GetDuration();
+              //Every cell showing the same animated tile shares one animation
+              if(batch.animation_indices.count(tile_id) == 0) {
+                std::vector<std::pair<glm::ivec2, unsigned int>> frames;
 
                 int width_in_tiles = texture->getWidth() / tileset->GetTileWidth();
                 int height_in_tiles = texture->getHeight() / tileset->GetTileHeight();
 
-                int x_pos = id % width_in_tiles;
-                int y_pos = height_in_tiles - 1 - id / width_in_tiles;
+                for(auto frame : tile->GetFrames()) {
+                  auto id = frame.GetTileID();
 
-                animator->addFrameBack((SpriteMovementMotor::SpriteState)0, glm::ivec2(x_pos, y_pos), duration, true);
-              }
+                  int x_pos = id % width_in_tiles;
+                  int y_pos = height_in_tiles - 1 - id / width_in_tiles;
 
-              renderable->setShader((*shader_manager.lock())["tile_animation"]);
+                  frames.push_back(std::pair<glm::ivec2, unsigned int>(glm::ivec2(x_pos, y_pos), frame.GetDuration()));
+                }
 
-              //subtract y from layer height, and then subtract an additional 1 to normalize it to 0
-              std::shared_ptr<Entity> entity = std::make_shared<Entity>();
-              entity->addComponent(renderable);
-              entity->addComponent(animator);
-
-              entity->getTransform()->translate(glm::vec3((float)x, layer->GetHeight() - (float)y - 1.0, calculateZ(layer_index, layers.size())));
-              if(layer->IsVisible())
-                entity->setActive(true);
-              else {
-                entity->setActive(false);
+                batch.animation_indices[tile_id] = batch.animator->addAnimation(frames);
               }
-              animations.push_back(entity);
+
+              //subtract y from layer height, and then subtract an additional 1 to normalize it to 0
+              batch.animator->addInstance(batch.animation_indices[tile_id], glm::vec3((float)x, layer->GetHeight() - (float)y - 1.0, 0.0));
             }
           }
         }
       }
+
+      //Batches live on separate entities, so each animator only talks to its own renderable
+      for(auto& batch : batches) {
+        std::shared_ptr<Entity> entity = std::make_shared<Entity>();
+        entity->addComponent(batch.second.renderable);
+        entity->addComponent(batch.second.animator);
+
+        entity->getTransform()->translate(glm::vec3(0.0, 0.0, calculateZ(layer_index, layers.size())));
+        if(layer->IsVisible())
+          entity->setActive(true);
+        else {
+          entity->setActive(false);
+        }
+        animations.push_back(entity);
+      }
       layer_index++;
     }
 
     return animations;
   }
 
-  SceneGenerator::MapRenderables SceneGenerator::createRenderablesFromMap(const unsigned int patch_width_tiles, const unsigned int patch_height_tiles, const Map& map) {
+  SceneGenerator::AnimationPlaceholder SceneGenerator::createAnimationPlaceholder(const Tmx::Tile* tile, const int x_pos, const int y_pos, const float z_order) {
+    AnimationPlaceholder placeholder;
+    placeholder.sprite_name = tile->GetProperties().GetStringProperty("CharacterName");
+    placeholder.default_animation = transformStateStringToEnum(tile->GetProperties().GetStringProperty("DefaultAnimation"));
+    placeholder.x_pos = x_pos;
+    placeholder.y_pos = y_pos;
+    placeholder.z_order = z_order;
+    return placeholder;
+  }
+
+  bool SceneGenerator::canRenderLayerAsTilemap(const Tmx::TileLayer* layer, const Map& map) {
+    //The tile map shader does no lighting
+    if(map.getImpl()->GetProperties().HasProperty("Lighted") && map.getImpl()->GetProperties().GetStringProperty("Lighted") == "True")
+      return false;
+
+    auto tilesets = map.getImpl()->GetTilesets();
+    std::set<int> used_tilesets;
+
+    for(int y = 0; y < layer->GetHeight(); y++) {
+      for(int x = 0; x < layer->GetWidth(); x++) {
+        auto tileset_index = layer->GetTileTilesetIndex(x, y);
+        if(tileset_index < 0 || used_tilesets.count(tileset_index) > 0)
+          continue;
+
+        //Tiles bigger than a map cell spill into their neighbours, which a single texel per cell can't express
+        auto tileset = tilesets[tileset_index];
+        if(tileset->GetTileWidth() != map.getImpl()->GetTileWidth() || tileset->GetTileHeight() != map.getImpl()->GetTileHeight())
+          return false;
+
+        used_tilesets.insert(tileset_index);
+      }
+    }
+
+    return used_tilesets.size() <= Graphics::TilemapRenderable::TILE_MAP_UNIT;
+  }
+
+  std::shared_ptr<Graphics::TilemapRenderable> SceneGenerator::createTilemapFromLayer(const Tmx::TileLayer* layer, const unsigned int layer_index, const unsigned int total_layers, const Map& map, std::vector<AnimationPlaceholder>& dynamic_animations) {
+    auto tilesets = map.getImpl()->GetTilesets();
+    auto path = map.getImpl()->GetFilepath();
+    unsigned int width = layer->GetWidth();
+    unsigned int height = layer->GetHeight();
+
+    auto renderable = Graphics::TilemapRenderable::create(width, height);
+    std::vector<unsigned short> cells(width * height * 4, 0);
+    //tileset index to texture unit
+    std::map<int, unsigned int> tileset_units;
+
+    for(int y = 0; y < height; y++) {
+      for(int x = 0; x < width; x++) {
+        auto tileset_index = layer->GetTileTilesetIndex(x, y);
+        if(tileset_index < 0)
+          continue;
+
+        auto opengl_y = height - y - 1;
+        auto tileset = tilesets[tileset_index];
+        auto id = layer->GetTileId(x, y);
+        auto tile = tileset->GetTile(id);
+
+        //Animated sprites and animated tiles are drawn by their own components, leave the cell empty
+        if(tile != nullptr && tile->GetProperties().GetStringProperty("AnimatedSprite") == "True") {
+          dynamic_animations.push_back(createAnimationPlaceholder(tile, x, opengl_y, calculateZ(layer_index, total_layers)));
+          continue;
+        }
+        else if(tile != nullptr && tile->IsAnimated()) {
+          continue;
+        }
+
+        auto texture = textureFromTileset(tileset, path);
+        if(tileset_units.count(tileset_index) == 0) {
+          unsigned int unit = tileset_units.size();
+          tileset_units[tileset_index] = unit;
+          renderable->addTileset(unit, texture, tileset->GetTileWidth(), tileset->GetTileHeight());
+        }
+
+        int width_in_tiles = texture->getWidth() / tileset->GetTileWidth();
+        int height_in_tiles = texture->getHeight() / tileset->GetTileHeight();
+
+        unsigned short flip_bits = 0;
+        if(layer->IsTileFlippedHorizontally(x, y))
+          flip_bits |= Graphics::TilemapRenderable::FLIP_HORIZONTAL;
+        if(layer->IsTileFlippedVertically(x, y))
+          flip_bits |= Graphics::TilemapRenderable::FLIP_VERTICAL;
+        if(layer->IsTileFlippedDiagonally(x, y))
+          flip_bits |= Graphics::TilemapRenderable::FLIP_DIAGONAL;
+
+        auto cell = (opengl_y * width + x) * 4;
+        cells[cell] = id % width_in_tiles;
+        cells[cell + 1] = height_in_tiles - 1 - id / width_in_tiles;
+        cells[cell + 2] = tileset_units[tileset_index] + 1;
+        cells[cell + 3] = flip_bits;
+      }
+    }
+
+    auto tile_map = std::make_shared<Graphics::BaseTexture>(GL_TEXTURE_2D);
+    tile_map->loadFromData(width, height, GL_RGBA16UI, GL_RGBA_INTEGER, GL_UNSIGNED_SHORT, &cells[0]);
+    renderable->setTileMap(tile_map);
+    renderable->setShader((*shader_manager.lock())["tilemap"]);
+
+    return renderable;
+  }
+
+  std::vector<bool> SceneGenerator::createOccluderMask(const Tmx::TileLayer* layer, const Map& map) {
+    auto width = map.getImpl()->GetWidth();
+    auto height = map.getImpl()->GetHeight();
+    auto tilesets = map.getImpl()->GetTilesets();
+    auto path = map.getImpl()->GetFilepath();
+    std::vector<bool> mask(width * height, false);
+
+    //A see-through layer hides nothing
+    if(layer->GetOpacity() < 1.0f)
+      return mask;
+
+    for(int y = 0; y < height; y++) {
+      for(int x = 0; x < width; x++) {
+        auto tileset_index = layer->GetTileTilesetIndex(x, y);
+        if(tileset_index < 0)
+          continue;
+
+        //Only tiles exactly covering their cell, that never change, can hide the tiles under them
+        auto tileset = tilesets[tileset_index];
+        if(tileset->GetTileWidth() != map.getImpl()->GetTileWidth() || tileset->GetTileHeight() != map.getImpl()->GetTileHeight())
+          continue;
+        auto tile = tileset->GetTile(layer->GetTileId(x, y));
+        if(tile != nullptr && (tile->IsAnimated() || tile->GetProperties().GetStringProperty("AnimatedSprite") == "True"))
+          continue;
+
+        auto tileset_alpha = alphaFromTileset(tileset, path);
+        mask[y * width + x] = tileset_alpha != nullptr && tileset_alpha->getAlphaMode(layer->GetTileId(x, y)) == Graphics::Renderable::AlphaMode::OPAQUE;
+      }
+    }
+    return mask;
+  }
+
+  SceneGenerator::PatchGeometry& SceneGenerator::patchForTileset(std::vector<PatchGeometry>& patches, const Tmx::Tileset* tileset, const unsigned int max_textures, const Map& map) {
+    auto texture = textureFromTileset(tileset, map.getImpl()->GetFilepath());
+
+    //A patch already binding the tileset, or else the first one with a sampler left
+    for(auto& patch : patches) {
+      if(std::find(patch.textures.begin(), patch.textures.end(), texture) != patch.textures.end())
+        return patch;
+    }
+    for(auto& patch : patches) {
+      if(patch.textures.size() < max_textures)
+        return patch;
+    }
+    patches.emplace_back();
+    return patches.back();
+  }
+
+  void SceneGenerator::addTileToPatch(PatchGeometry& patch, const Tmx::TileLayer* layer, const Tmx::Tileset* tileset, const unsigned int map_x, const unsigned int map_y, const Map& map) {
+    auto path = map.getImpl()->GetFilepath();
+    auto opengl_map_y = map.getImpl()->GetHeight() - map_y - 1;
+
+    //Generate Vertex Coords
+    auto vertex_coords = generateVertexCoords(map.getImpl()->GetTileWidth(), map.getImpl()->GetTileHeight(), tileset->GetTileWidth(), tileset->GetTileHeight(), map_x, opengl_map_y);
+
+    //Generate Textures
+    auto next_texture = textureFromTileset(tileset, path);
+    int texture_unit;
+
+    //See if texture already exists on patch
+    auto found_texture = std::find(patch.textures.begin(), patch.textures.end(), next_texture);
+
+    //If it doesn't exist, grab the current number of patch textures for the new texture unit and add the next texture
+    if(found_texture == patch.textures.end()) {
+      texture_unit = patch.textures.size();
+      patch.textures.push_back(next_texture);
+
+      //Set the appropriate sampler name for this tileset
+      std::stringstream sampler_name;
+      sampler_name << "tileset" << texture_unit;
+      patch.texture_names[texture_unit] = sampler_name.str();
+    }
+    //If it does exist, calculate the texture unit
+    else {
+      texture_unit = (int)(found_texture - patch.textures.begin());
+    }
+
+    //Generate Texture Coords
+    auto tex_coords = generateTextureCoords(layer, map_x, map_y, next_texture->getWidth(), next_texture->getHeight(), tileset->GetTileWidth(), tileset->GetTileHeight());
+
+    //The six vertices are two triangles sharing the bottom left and top right corners, a quad only needs four
+    for(auto corner : {0, 1, 2, 5}) {
+      auto position = glm::round(glm::vec2(vertex_coords[corner]) * (float)Graphics::TilePosition2s::subdivisions);
+      if(glm::any(glm::greaterThan(glm::abs(position), glm::vec2(std::numeric_limits<short>::max()))))
+        throw std::out_of_range("Map is too large for tile vertices");
+      auto uv = glm::round(glm::clamp(tex_coords[corner], glm::vec2(0.0), glm::vec2(1.0)) * (float)std::numeric_limits<unsigned short>::max());
+      patch.vertices.addVertex(glm::i16vec2(position), glm::u16vec2(uv), (unsigned char)texture_unit);
+    }
+  }
+
+  std::shared_ptr<Graphics::Renderable> SceneGenerator::createPatchRenderable(PatchGeometry& patch, const Graphics::Renderable::AlphaMode alpha_mode, const Map& map, std::shared_ptr<Graphics::BaseTexture> lightmap, const glm::vec4& lightmap_bounds) {
+    //Create renderable and populate it with data, arena pages share one set of quad indices
+    std::shared_ptr<Graphics::Renderable> renderable;
+    if(geometry_arena != nullptr) {
+      renderable = std::make_shared<Graphics::Renderable>(geometry_arena->allocateQuads(patch.vertices));
+    }
+    else {
+      patch.vertices.addIndices(Graphics::BaseVertexLayout::quadIndices(patch.vertices.getVertexCount() / 4));
+      renderable = Graphics::Renderable::create(patch.vertices);
+    }
+    setupPatchRenderable(renderable, patch, alpha_mode, map, lightmap, lightmap_bounds);
+    return renderable;
+  }
+
+  void SceneGenerator::setupPatchRenderable(std::shared_ptr<Graphics::Renderable> renderable, const PatchGeometry& patch, const Graphics::Renderable::AlphaMode alpha_mode, const Map& map, std::shared_ptr<Graphics::BaseTexture> lightmap, const glm::vec4& lightmap_bounds) {
+    renderable->setAlphaMode(alpha_mode);
+    renderable->setMaterial(patchMaterial(patch, alpha_mode, map, lightmap, lightmap_bounds));
+  }
+
+  std::shared_ptr<Graphics::Material> SceneGenerator::patchMaterial(const PatchGeometry& patch, const Graphics::Renderable::AlphaMode alpha_mode, const Map& map, std::shared_ptr<Graphics::BaseTexture> lightmap, const glm::vec4& lightmap_bounds) {
+    //Tiles use the compact vertex variant with only the samplers the patch binds, opaque tiles the one without discard
+    std::stringstream defines;
+    defines << "TILE_VERTEX TILESET_COUNT=" << std::max<size_t>(patch.textures.size(), 1);
+    if(alpha_mode == Graphics::Renderable::AlphaMode::OPAQUE)
+      defines << " ALPHA_OPAQUE";
+
+    //Check if this map is lighted
+    auto lighted = map.getImpl()->GetProperties().HasProperty("Lighted") && map.getImpl()->GetProperties().GetStringProperty("Lighted") == "True";
+    std::shared_ptr<Graphics::Shader> shader;
+    if(lighted) {
+      if(lightmap != nullptr)
+        defines << " LIGHTMAP";
+      if(castsQuantizedBands(map))
+        defines << " QUANTIZED_BANDS";
+      shader = shader_manager.lock()->getVariant("diffuse_lighting", defines.str());
+    }
+    //If it isn't, it just needs a simple texturing shader
+    else {
+      shader = shader_manager.lock()->getVariant("simple_texture", defines.str());
+    }
+
+    //Patches of this map drawn with the same shader and textures share one material
+    auto& material = patch_materials[std::make_pair(shader, patch.textures)];
+    if(material == nullptr) {
+      material = Graphics::Material::create();
+      material->setShader(shader);
+      for(unsigned int texture_index = 0; texture_index < patch.textures.size(); texture_index++) {
+        material->addTexture(texture_index, patch.texture_names.at(texture_index), patch.textures[texture_index]);
+      }
+
+      //If it is lighted, set the ambient color and intensity, and set it to react to lights
+      if(lighted) {
+        material->setLightReactive(true);
+        if(map.getImpl()->GetProperties().HasProperty("AmbientColor"))
+          material->setAmbientLight(Utility::stringToVec3(map.getImpl()->GetProperties().GetStringProperty("AmbientColor")) / glm::vec3(256.0, 256.0, 256.0));
+        if(map.getImpl()->GetProperties().HasProperty("AmbientIntensity"))
+          material->setAmbientIntensity(map.getImpl()->GetProperties().GetFloatProperty("AmbientIntensity"));
+        if(lightmap != nullptr)
+          material->setLightmap(lightmap, lightmap_bounds);
+      }
+    }
+    return material;
+  }
+
+  SceneGenerator::MapRenderables SceneGenerator::createRenderablesFromMap(const unsigned int patch_width_tiles, const unsigned int patch_height_tiles, const Map& map, std::shared_ptr<Graphics::BaseTexture> lightmap, const glm::vec4& lightmap_bounds) {
     MapRenderables renderables;
+    //Ambient light and lightmaps differ between maps
+    patch_materials.clear();
+    renderables.layer_occlusion = std::make_shared<LayerOcclusion>();
     auto layers = map.getImpl()->GetTileLayers();
     auto tilesets = map.getImpl()->GetTilesets();
     auto path = map.getImpl()->GetFilepath();
@@ -472,143 +821,152 @@ namespace Game {
 
     unsigned int total_layers = layers.size();
     unsigned int layer_index = 0;
+    auto lighted = map.getImpl()->GetProperties().HasProperty("Lighted") && map.getImpl()->GetProperties().GetStringProperty("Lighted") == "True";
+    auto max_patch_textures = lighted && lightmap != nullptr ? MAX_PATCH_TEXTURES - 1 : MAX_PATCH_TEXTURES;
+
+    //Cells each layer covers with opaque tiles, the tiles under them are only drawn while the layer is hidden
+    std::vector<std::vector<bool>> occluder_masks;
+    for(auto layer : layers) {
+      occluder_masks.push_back(createOccluderMask(layer, map));
+    }
 
     for(auto layer : layers) {
       auto layer_entity = std::make_shared<Entity>();
       layer_entity->setActive(true);
 
-      for(unsigned int patch_y = 0; patch_y < height_in_patches; patch_y++) {
-        for(unsigned int patch_x = 0; patch_x < width_in_patches; patch_x++) {
-          std::vector<glm::vec3> patch_vertices;
-          std::vector<glm::vec2> patch_texture_coords;
-          std::vector<int> patch_texture_units;
-          std::vector<std::shared_ptr<Graphics::BaseTexture>> patch_textures;
-          std::map<int, std::string> patch_texture_names;
+      //Entities for the tiles of this layer hidden by higher layers, by the layers hiding them
+      std::map<std::vector<unsigned int>, std::shared_ptr<Entity>> occluded_entities;
+      //Patch batches by entity, alpha mode and material
+      std::map<std::tuple<std::shared_ptr<Entity>, unsigned int, std::shared_ptr<Graphics::Material>>, std::shared_ptr<Graphics::PatchBatch>> batches;
 
+      //Layers that fit in a tile map texture are drawn as a single quad
+      if(tilemap_layers && canRenderLayerAsTilemap(layer, map)) {
+        layer_entity->addComponent(createTilemapFromLayer(layer, layer_index, total_layers, map, renderables.dynamic_animations));
+      }
+      else {
+        //Static layers of unlit maps look the same every frame, they can be drawn once into a cache following the camera
+        std::shared_ptr<Graphics::LayerCache> layer_cache = nullptr;
+        if(layer_cache_camera != nullptr && !lighted) {
+          layer_cache = Graphics::LayerCache::create(layer_cache_camera, map.getImpl()->GetTileWidth(), map.getImpl()->GetTileHeight());
+          layer_cache->setShader((*shader_manager.lock())["layer_cache"]);
+          layer_entity->addComponent(layer_cache);
+        }
 
-          for(unsigned int tile_y = 0; tile_y < patch_height_tiles; tile_y++) {
-            for(unsigned int tile_x = 0; tile_x < patch_width_tiles; tile_x++) {
+        for(unsigned int patch_y = 0; patch_y < height_in_patches; patch_y++) {
+          for(unsigned int patch_x = 0; patch_x < width_in_patches; patch_x++) {
+            //Tiles are split by the layers hiding them, then by alpha mode, opaque ones draw without discard or blending,
+            //then into as many patches as it takes to stay within the samplers of the shader
+            std::map<std::vector<unsigned int>, std::array<std::vector<PatchGeometry>, 3>> patches;
 
-              //Get the actual map-tile coord for calculations
-              auto map_x = patch_x * patch_width_tiles + tile_x;
-              auto map_y = patch_y * patch_height_tiles + tile_y;
-              auto opengl_map_y = map.getImpl()->GetHeight() - map_y - 1;
+            for(unsigned int tile_y = 0; tile_y < patch_height_tiles; tile_y++) {
+              for(unsigned int tile_x = 0; tile_x < patch_width_tiles; tile_x++) {
 
+                //Get the actual map-tile coord for calculations
+                auto map_x = patch_x * patch_width_tiles + tile_x;
+                auto map_y = patch_y * patch_height_tiles + tile_y;
+                auto opengl_map_y = map.getImpl()->GetHeight() - map_y - 1;
 
-              //If the generated map tile coord is out of bounds for the map, discard this iteration
-              //This will happen if ASSERT(map.getWidth() % patch_width_tiles != 0 || map.getHeight() % patch_height_tiles != 0]
-              if(map_x >= map.getImpl()->GetWidth() || map_y >= map.getImpl()->GetHeight())
-                continue;
 
-              //Retrieve tileset and tile from layer
-              auto tileset_index = layer->GetTileTilesetIndex(map_x, map_y);
+                //If the generated map tile coord is out of bounds for the map, discard this iteration
+                //This will happen if ASSERT(map.getWidth() % patch_width_tiles != 0 || map.getHeight() % patch_height_tiles != 0]
+                if(map_x >= map.getImpl()->GetWidth() || map_y >= map.getImpl()->GetHeight())
+                  continue;
 
-              //If there is no tile here on this layer, discard this iteration
-              if(tileset_index < 0) {
-                continue;
-              }
+                //Retrieve tileset and tile from layer
+                auto tileset_index = layer->GetTileTilesetIndex(map_x, map_y);
 
-              auto tileset = tilesets[tileset_index];
-              auto tile = tileset->GetTile(layer->GetTileId(map_x, map_y));
+                //If there is no tile here on this layer, discard this iteration
+                if(tileset_index < 0) {
+                  continue;
+                }
 
+                auto tileset = tilesets[tileset_index];
+                auto tile = tileset->GetTile(layer->GetTileId(map_x, map_y));
 
-              //Check if this tile has an animated sprite on it, in which case this is taken care of elsewhere, discard this iteration
-              if(tile != nullptr && tile->GetProperties().GetStringProperty("AnimatedSprite") == "True") {
-                AnimationPlaceholder placeholder;
-                placeholder.sprite_name = tile->GetProperties().GetStringProperty("CharacterName");
-                placeholder.default_animation = transformStateStringToEnum(tile->GetProperties().GetStringProperty("DefaultAnimation"));
-                placeholder.x_pos = map_x;
-                placeholder.y_pos = opengl_map_y;
-                placeholder.z_order = calculateZ(layer_index, total_layers);
-                renderables.dynamic_animations.push_back(placeholder);
-              }
-              else if(tile != nullptr && tile->IsAnimated()) {
-                continue;
-              }
-              else if(!tile || (tile != nullptr && !tile->IsAnimated())) {
-                //Generate Vertex Coords
-                auto vertex_coords = generateVertexCoords(map.getImpl()->GetTileWidth(), map.getImpl()->GetTileHeight(), tileset->GetTileWidth(), tileset->GetTileHeight(), map_x, opengl_map_y);
-                patch_vertices.insert(patch_vertices.end(), vertex_coords.begin(), vertex_coords.end());
-
-                //Generate Textures
-                auto next_texture = textureFromTileset(tileset, path);
-                int texture_unit;
-
-                //See if texture already exists on patch
-                auto found_texture = std::find(patch_textures.begin(), patch_textures.end(), next_texture);
-
-                //If it doesn't exist, grab the current number of patch textures for the new texture unit and add the next texture
-                if(found_texture == patch_textures.end()) {
-                  texture_unit = patch_textures.size();
-                  patch_textures.push_back(next_texture);
-
-                  //Set the appropriate sampler name for this tileset
-                  std::stringstream sampler_name;
-                  sampler_name << "tileset" << texture_unit;
-                  patch_texture_names[texture_unit] = sampler_name.str();
+
+                //Check if this tile has an animated sprite on it, in which case this is taken care of elsewhere, discard this iteration
+                if(tile != nullptr && tile->GetProperties().GetStringProperty("AnimatedSprite") == "True") {
+                  renderables.dynamic_animations.push_back(createAnimationPlaceholder(tile, map_x, opengl_map_y, calculateZ(layer_index, total_layers)));
                 }
-                //If it does exist, calculate the texture unit
-                else {
-                  texture_unit = (int)(found_texture - patch_textures.begin());
+                else if(tile != nullptr && tile->IsAnimated()) {
+                  continue;
                 }
-
-                //Generate Texture Unit Vector
-                for(int i = 0; i < 6; i++) {
-                  patch_texture_units.push_back(texture_unit);
+                else if(!tile || (tile != nullptr && !tile->IsAnimated())) {
+                  auto tileset_alpha = alphaFromTileset(tileset, path);
+                  auto alpha_mode = tileset_alpha != nullptr ? tileset_alpha->getAlphaMode(layer->GetTileId(map_x, map_y)) : Graphics::Renderable::AlphaMode::TRANSLUCENT;
+
+                  //Higher layers covering this cell, a cached layer costs the same with its hidden tiles.
+                  //Tiles of another size than the cells reach past the one cell checked, so they're never hidden
+                  auto cell_sized = tileset->GetTileWidth() == map.getImpl()->GetTileWidth() && tileset->GetTileHeight() == map.getImpl()->GetTileHeight();
+                  std::vector<unsigned int> occluders;
+                  for(unsigned int above = layer_index + 1; above < total_layers && layer_cache == nullptr && cell_sized; above++) {
+                    if(occluder_masks[above][map_y * map.getImpl()->GetWidth() + map_x])
+                      occluders.push_back(above);
+                  }
+
+                  auto& patch = patchForTileset(patches[occluders][alpha_mode], tileset, max_patch_textures, map);
+                  addTileToPatch(patch, layer, tileset, map_x, map_y, map);
                 }
-
-                //Generate Texture Coords
-                auto tex_coords = generateTextureCoords(layer, map_x, map_y, next_texture->getWidth(), next_texture->getHeight(), tileset->GetTileWidth(), tileset->GetTileHeight());
-                patch_texture_coords.insert(patch_texture_coords.end(), tex_coords.begin(), tex_coords.end());
-
               }
             }
-          }
 
-          //If this patch is actually supposed to exist
-          if(patch_vertices.size() > 0 && patch_texture_coords.size() > 0 && patch_texture_units.size() > 0) {
-            //Create vertex data
-            Graphics::VertexData patch_vertex_data(GL_TRIANGLES);
-            patch_vertex_data.addVec(Graphics::VertexData::DATA_TYPE::GEOMETRY, patch_vertices);
-            patch_vertex_data.addVec(Graphics::VertexData::DATA_TYPE::TEX_COORDS, patch_texture_coords);
-            patch_vertex_data.addVec(Graphics::VertexData::DATA_TYPE::TEXTURE_UNIT, patch_texture_units);
-
-            //Create renderable and populate it with data
-            auto renderable = Graphics::Renderable::create(patch_vertex_data);
-            for(auto texture_index = 0; texture_index < patch_textures.size(); texture_index++) {
-              renderable->addTexture(texture_index, patch_texture_names[texture_index], patch_textures[texture_index]);
-            }
+            for(auto& occluded_patches : patches) {
+              //Visible tiles go on the layer, hidden ones on an entity shared with the tiles hidden by the same layers
+              auto entity = layer_entity;
+              if(!occluded_patches.first.empty()) {
+                auto& occluded_entity = occluded_entities[occluded_patches.first];
+                if(occluded_entity == nullptr)
+                  occluded_entity = std::make_shared<Entity>();
+                entity = occluded_entity;
+              }
 
-            //Check if this map is lighted
-            //If it is, give the renderable a diffuse shader, set it's ambient color and intensity, and set it to react to lights
-            if(map.getImpl()->GetProperties().HasProperty("Lighted") && map.getImpl()->GetProperties().GetStringProperty("Lighted") == "True") {
-              renderable->setShader((*shader_manager.lock())["diffuse_lighting"]);
-              renderable->setLightReactive(true);
-              if(map.getImpl()->GetProperties().HasProperty("AmbientColor"))
-                renderable->setAmbientLight(Utility::stringToVec3(map.getImpl()->GetProperties().GetStringProperty("AmbientColor")) / glm::vec3(256.0, 256.0, 256.0));
-              if(map.getImpl()->GetProperties().HasProperty("AmbientIntensity"))
-                renderable->setAmbientIntensity(map.getImpl()->GetProperties().GetFloatProperty("AmbientIntensity"));
-            }
-            //If it isn't, it just needs a simple texturing shader
-            else {
-              renderable->setShader((*shader_manager.lock())["simple_texture"]);
+              for(unsigned int alpha_mode = 0; alpha_mode < 3; alpha_mode++) {
+                for(auto& patch : occluded_patches.second[alpha_mode]) {
+                  //If this patch is actually supposed to exist
+                  if(patch.vertices.getVertexCount() > 0) {
+                    if(layer_cache != nullptr) {
+                      auto renderable = createPatchRenderable(patch, (Graphics::Renderable::AlphaMode)alpha_mode, map, lightmap, lightmap_bounds);
+                      auto record = renderable->getVertexRecord();
+                      layer_cache->addSource(renderable, glm::vec4(glm::vec2(record.getLow()), glm::vec2(record.getHigh() - record.getLow())));
+                    }
+                    else if(geometry_arena != nullptr) {
+                      //Patches of an entity with the same material and alpha mode draw in one call while they share a page
+                      auto geometry = geometry_arena->allocateQuads(patch.vertices);
+                      auto material = patchMaterial(patch, (Graphics::Renderable::AlphaMode)alpha_mode, map, lightmap, lightmap_bounds);
+                      auto& batch = batches[std::make_tuple(entity, alpha_mode, material)];
+                      if(batch == nullptr || !batch->canAddPatch(geometry)) {
+                        batch = std::make_shared<Graphics::PatchBatch>(geometry);
+                        batch->setAlphaMode((Graphics::Renderable::AlphaMode)alpha_mode);
+                        batch->setMaterial(material);
+                        batch->setCamera(patch_camera);
+                        entity->addComponent(batch);
+                      }
+                      else {
+                        batch->addPatch(geometry);
+                      }
+                    }
+                    else {
+                      entity->addComponent(createPatchRenderable(patch, (Graphics::Renderable::AlphaMode)alpha_mode, map, lightmap, lightmap_bounds));
+                    }
+                  }
+                }
+              }
             }
-
-            layer_entity->addComponent(renderable);
-
           }
         }
-        if(layer->IsVisible()) {
-          layer_entity->setActive(true);
-        }
-        else {
-          layer_entity->setActive(false);
-        }
       }
 
+      renderables.layer_occlusion->addLayer(layer_index, layer_entity, layer->IsVisible());
+
       layer_entity->getTransform()->translate(glm::vec3(0.0, 0.0, calculateZ(layer_index, total_layers)));
-      layer_index++;
       renderables.entities.push_back(layer_entity);
+
+      for(auto& occluded_entity : occluded_entities) {
+        occluded_entity.second->getTransform()->translate(glm::vec3(0.0, 0.0, calculateZ(layer_index, total_layers)));
+        renderables.layer_occlusion->addOccludedGroup(layer_index, occluded_entity.first, occluded_entity.second);
+        renderables.entities.push_back(occluded_entity.second);
+      }
+      layer_index++;
     }
     return renderables;
   }
@@ -631,7 +989,7 @@ namespace Game {
             unsigned int unit = 0;
 
             renderable->addTexture(unit, "tileset0", texture);
-            renderable->setShader((*shader_manager.lock())["tile_animation"]);
+            renderable->setShader(shader_manager.lock()->getVariant("tile_animation", "TILESET_COUNT=1"));
 
             anim.entity = std::make_shared<Entity>();
             anim.entity->addComponent(renderable);
@@ -670,4 +1028,40 @@ namespace Game {
     return stripped_name;
   }
 
+  void SceneGenerator::setGPUTileAnimation(const bool gpu_evaluated) noexcept {
+    gpu_tile_animation = gpu_evaluated;
+  }
+
+  bool SceneGenerator::isGPUTileAnimation() const noexcept {
+    return gpu_tile_animation;
+  }
+
+  void SceneGenerator::setTilemapLayers(const bool tilemap_layers) noexcept {
+    this->tilemap_layers = tilemap_layers;
+  }
+
+  bool SceneGenerator::isTilemapLayers() const noexcept {
+    return tilemap_layers;
+  }
+
+  void SceneGenerator::setLayerCache(std::shared_ptr<Graphics::Camera> camera) noexcept {
+    layer_cache_camera = camera;
+  }
+
+  bool SceneGenerator::isLayerCache() const noexcept {
+    return layer_cache_camera != nullptr;
+  }
+
+  void SceneGenerator::setGeometryArena(std::shared_ptr<Graphics::GeometryArena> arena) noexcept {
+    geometry_arena = arena;
+  }
+
+  void SceneGenerator::setPatchCamera(std::shared_ptr<Graphics::Camera> camera) noexcept {
+    patch_camera = camera;
+  }
+
+  void SceneGenerator::setStreamingBuffer(std::shared_ptr<Graphics::StreamingBuffer> streaming_buffer) noexcept {
+    this->streaming_buffer = streaming_buffer;
+  }
+
 }
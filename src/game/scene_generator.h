@@ -1,16 +1,26 @@
 #ifndef SCENE_GENERATOR_H
 #define SCENE_GENERATOR_H
+#include <array>
 #include <memory>
 #include <map>
 #include "../physics/collision_data.h"
 #include "../graphics/vertex_data.h"
+#include "../graphics/vertex_layout.h"
 #include "../graphics/texture_manager.h"
 #include "../graphics/shader_manager.h"
 #include "../graphics/renderable.h"
+#include "../graphics/material.h"
+#include "../graphics/tilemap_renderable.h"
+#include "../graphics/camera.h"
+#include "../graphics/geometry_arena.h"
+#include "../graphics/streaming_buffer.h"
+#include "../graphics/light.h"
+#include "../graphics/tileset_alpha.h"
 #include "../graphics/tile_animator.hpp"
 #include "../component_manager.h"
 #include "../entity.h"
 #include "scene.h"
+#include "layer_occlusion.h"
 #include "map.h"
 #include "sprite_movement.h"
 
@@ -29,6 +39,14 @@ namespace Game {
       struct MapRenderables {
         std::vector<std::shared_ptr<Entity>> entities;
         std::vector<AnimationPlaceholder> dynamic_animations;
+        std::shared_ptr<LayerOcclusion> layer_occlusion;
+      };
+
+      struct PatchGeometry {
+        //Four vertices per tile, drawn with shared quad indices
+        Graphics::VertexLayout<Graphics::TilePosition2s, Graphics::UV2us, Graphics::Unit1ub> vertices;
+        std::vector<std::shared_ptr<Graphics::BaseTexture>> textures;
+        std::map<int, std::string> texture_names;
       };
 
       struct DynamicAnimation {
@@ -39,22 +57,51 @@ namespace Game {
       std::weak_ptr<Graphics::TextureManager> texture_manager;
       std::weak_ptr<Graphics::ShaderManager> shader_manager;
       std::map<std::string, DynamicAnimation> dynamic_animations;
+      //Tileset image path to its tiles' alpha modes
+      std::map<std::string, std::shared_ptr<Graphics::TilesetAlpha>> tileset_alphas;
 
       unsigned int ui_z_slots;
+      bool gpu_tile_animation;
+      bool tilemap_layers;
+      std::shared_ptr<Graphics::Camera> layer_cache_camera;
+      std::shared_ptr<Graphics::GeometryArena> geometry_arena;
+      std::shared_ptr<Graphics::Camera> patch_camera;
+      std::shared_ptr<Graphics::StreamingBuffer> streaming_buffer;
+      //Materials of the map being generated, by shader and textures
+      std::map<std::pair<std::shared_ptr<Graphics::Shader>, std::vector<std::shared_ptr<Graphics::BaseTexture>>>, std::shared_ptr<Graphics::Material>> patch_materials;
+
+      static const unsigned int LIGHTMAP_TEXELS_PER_TILE = 4;
+      //Tileset samplers a patch can bind, the lit shader needs one more for a lightmap, see diffuse_lighting.frag
+      static const unsigned int MAX_PATCH_TEXTURES = 12;
 
       Graphics::VertexData generateBasisCube();
       Graphics::VertexData generateBasisTile(const unsigned int base_width, const unsigned int base_height, const unsigned int current_width, const unsigned int current_height, const unsigned int x_pos = 0, const unsigned int y_pos = 0,  const unsigned int offset_x = 0, const unsigned int offset_y = 0);
+      std::string imagePathFromTileset(const Tmx::Tileset* tileset, const std::string& path);
+      std::shared_ptr<Graphics::BaseTexture> loadSceneTexture(const std::string& source);
       std::shared_ptr<Graphics::BaseTexture> textureFromTileset(const Tmx::Tileset* tileset, const std::string& path);
+      std::shared_ptr<Graphics::TilesetAlpha> alphaFromTileset(const Tmx::Tileset* tileset, const std::string& path);
       std::shared_ptr<Graphics::BaseTexture> normalTextureFromTileset(const Tmx::Tileset* tileset, const std::string& path);
       std::shared_ptr<Graphics::BaseTexture> displacementTextureFromTileset(const Tmx::Tileset* tileset, const std::string& path);
       std::vector<glm::vec2> generateTextureCoords(const Tmx::TileLayer* layer, const unsigned int x_pos, const unsigned int y_pos, const unsigned int texture_width, const unsigned int texture_height, const unsigned int tile_width, const unsigned int tile_height);
       std::vector<glm::vec3> generateVertexCoords(const unsigned int base_width, const unsigned int base_height, const unsigned int current_width, const unsigned int current_height, const unsigned int x_pos = 0, const unsigned int y_pos = 0, const unsigned int offset_x = 0, const unsigned int offset_y = 0);
 
 
-      MapRenderables createRenderablesFromMap(const unsigned int patch_width_tiles, const unsigned int patch_height_tiles, const Map& map);
+      AnimationPlaceholder createAnimationPlaceholder(const Tmx::Tile* tile, const int x_pos, const int y_pos, const float z_order);
+      bool canRenderLayerAsTilemap(const Tmx::TileLayer* layer, const Map& map);
+      std::shared_ptr<Graphics::TilemapRenderable> createTilemapFromLayer(const Tmx::TileLayer* layer, const unsigned int layer_index, const unsigned int total_layers, const Map& map, std::vector<AnimationPlaceholder>& dynamic_animations);
+
+      std::vector<bool> createOccluderMask(const Tmx::TileLayer* layer, const Map& map);
+      PatchGeometry& patchForTileset(std::vector<PatchGeometry>& patches, const Tmx::Tileset* tileset, const unsigned int max_textures, const Map& map);
+      void addTileToPatch(PatchGeometry& patch, const Tmx::TileLayer* layer, const Tmx::Tileset* tileset, const unsigned int map_x, const unsigned int map_y, const Map& map);
+      std::shared_ptr<Graphics::Renderable> createPatchRenderable(PatchGeometry& patch, const Graphics::Renderable::AlphaMode alpha_mode, const Map& map, std::shared_ptr<Graphics::BaseTexture> lightmap, const glm::vec4& lightmap_bounds);
+      std::shared_ptr<Graphics::Material> patchMaterial(const PatchGeometry& patch, const Graphics::Renderable::AlphaMode alpha_mode, const Map& map, std::shared_ptr<Graphics::BaseTexture> lightmap, const glm::vec4& lightmap_bounds);
+      void setupPatchRenderable(std::shared_ptr<Graphics::Renderable> renderable, const PatchGeometry& patch, const Graphics::Renderable::AlphaMode alpha_mode, const Map& map, std::shared_ptr<Graphics::BaseTexture> lightmap, const glm::vec4& lightmap_bounds);
+      MapRenderables createRenderablesFromMap(const unsigned int patch_width_tiles, const unsigned int patch_height_tiles, const Map& map, std::shared_ptr<Graphics::BaseTexture> lightmap, const glm::vec4& lightmap_bounds);
       std::vector<std::shared_ptr<Entity>> createStaticallyAnimatedTilesFromMap(const Map& map);
       std::map<std::string, DynamicAnimation> createAnimationsFromAnimationMap(const Map& map);
-      std::vector<std::shared_ptr<Component>> createLightsFromMap(const Map& map);
+      std::vector<std::shared_ptr<Component>> createLightsFromMap(const Map& map, std::vector<std::shared_ptr<Graphics::Light>>& static_lights);
+      bool castsQuantizedBands(const Map& map);
+      std::shared_ptr<Graphics::BaseTexture> bakeLightmap(const Map& map, const std::vector<std::shared_ptr<Graphics::Light>>& static_lights);
       std::shared_ptr<Physics::CollisionData> createCollisionDataFromMap(const Map& map);
 
       SpriteMovementMotor::SpriteState transformStateStringToEnum(const std::string& state);
@@ -122,6 +169,64 @@ namespace Game {
        * @return     The stripped map name.
        */
       [[scriptable]] std::string getStrippedMapName(const std::string path);
+
+      /**
+       * @brief      Sets if statically animated tiles pick their frames on the GPU
+       *
+       * @param[in]  gpu_evaluated  True if frames should be picked by the shader from a frame table
+       */
+      [[scriptable]] void setGPUTileAnimation(const bool gpu_evaluated) noexcept;
+      /**
+       * @brief      Determines if statically animated tiles pick their frames on the GPU
+       *
+       * @return     True if gpu evaluated, False otherwise.
+       */
+      [[scriptable]] bool isGPUTileAnimation() const noexcept;
+
+      /**
+       * @brief      Sets if static layers of unlit maps are drawn from a tile map texture instead of patches
+       *
+       * @param[in]  tilemap_layers  True to draw eligible layers as a single tile map quad
+       */
+      [[scriptable]] void setTilemapLayers(const bool tilemap_layers) noexcept;
+      /**
+       * @brief      Determines if static layers are drawn from a tile map texture
+       *
+       * @return     True if tile map layers are used, False otherwise.
+       */
+      [[scriptable]] bool isTilemapLayers() const noexcept;
+
+      /**
+       * @brief      Sets if static layers of unlit maps are drawn from a cache that follows the camera
+       *
+       * @param[in]  camera  The camera the caches follow, nullptr to draw the layers' patches directly
+       */
+      [[scriptable]] void setLayerCache(std::shared_ptr<Graphics::Camera> camera) noexcept;
+      /**
+       * @brief      Determines if static layers are drawn from a cache
+       *
+       * @return     True if layers are cached, False otherwise.
+       */
+      [[scriptable]] bool isLayerCache() const noexcept;
+
+      /**
+       * @brief      Sets the arena map patches upload their vertices to
+       *
+       * @param[in]  arena  The geometry arena, nullptr to give every patch its own buffers
+       */
+      [[scriptable]] void setGeometryArena(std::shared_ptr<Graphics::GeometryArena> arena) noexcept;
+      /**
+       * @brief      Sets the camera batched map patches are culled against, patches are only batched with a geometry arena
+       *
+       * @param[in]  camera  The camera, nullptr to draw every patch
+       */
+      [[scriptable]] void setPatchCamera(std::shared_ptr<Graphics::Camera> camera) noexcept;
+      /**
+       * @brief      Sets the buffer the instances of tiles animated on the CPU are streamed through
+       *
+       * @param[in]  streaming_buffer  The streaming buffer, nullptr to keep them in each renderable's instance buffer
+       */
+      [[scriptable]] void setStreamingBuffer(std::shared_ptr<Graphics::StreamingBuffer> streaming_buffer) noexcept;
   };
 }
 
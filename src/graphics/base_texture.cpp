@@ -5,12 +5,24 @@
 #include "exceptions/texture_not_loaded_exception.h"
 
 namespace Graphics {
-  BaseTexture::BaseTexture(const GLenum texture_type) : texture_object(0), texture_type(texture_type), loaded(false), width(0), height(0)   {
+  BaseTexture::BaseTexture(const GLenum texture_type) : texture(nullptr), texture_type(texture_type), loaded(false), width(0), height(0), last_used_frame(0)   {
 
   }
 
-  BaseTexture::~BaseTexture() {
-    glDeleteTextures(1, &texture_object);
+  size_t BaseTexture::bytesPerTexel(const GLenum internal_format) noexcept {
+    switch(internal_format) {
+      case GL_R8:
+        return 1;
+      case GL_RGB8:
+        return 3;
+      case GL_RGBA16F:
+        return 8;
+      case GL_RGBA32I:
+      case GL_RGBA32F:
+        return 16;
+      default:
+        return 4;
+    }
   }
 
   unsigned int BaseTexture::getWidth() const noexcept {
@@ -29,14 +41,17 @@ namespace Graphics {
     ilOriginFunc(IL_ORIGIN_LOWER_LEFT);
     auto success = ilLoadImage((const ILstring)filename.c_str());
     if(success) {
-      glGenTextures(1, &texture_object);
-      glBindTexture(texture_type, texture_object);
+      //Loading again replaces the old texture, it's deleted once nothing else holds it
+      texture = GPUResourceRegistry::create(GPUResourceType::TEXTURE);
+      glBindTexture(texture_type, texture->getObject());
       width = ilGetInteger(IL_IMAGE_WIDTH);
       height = ilGetInteger(IL_IMAGE_HEIGHT);
 
       if(ilGetInteger(IL_IMAGE_FORMAT) == IL_RGBA) {
         glTexImage2D(texture_type, 0, GL_RGBA8, width, height, 0, ilGetInteger(IL_IMAGE_FORMAT), ilGetInteger(IL_IMAGE_TYPE), ilGetData());
         glGenerateMipmap(texture_type);
+        //Mipmaps add a third
+        texture->setBytes(width * height * bytesPerTexel(GL_RGBA8) * 4 / 3);
         glTexParameteri(texture_type, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
         glTexParameteri(texture_type, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
         glTexParameteri(texture_type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -44,12 +59,14 @@ namespace Graphics {
       }
       else if(ilGetInteger(IL_IMAGE_FORMAT) == IL_LUMINANCE) {
         glTexImage2D(texture_type, 0, GL_R32F, width, height, 0, GL_RED, ilGetInteger(IL_IMAGE_TYPE), ilGetData());
+        texture->setBytes(width * height * bytesPerTexel(GL_R32F));
         glTexParameteri(texture_type, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(texture_type, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
       }
       else {
         glTexImage2D(texture_type, 0, GL_RGB8, width, height, 0, ilGetInteger(IL_IMAGE_FORMAT), ilGetInteger(IL_IMAGE_TYPE), ilGetData());
         glGenerateMipmap(texture_type);
+        texture->setBytes(width * height * bytesPerTexel(GL_RGB8) * 4 / 3);
         glTexParameteri(texture_type, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
         glTexParameteri(texture_type, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
         glTexParameteri(texture_type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -57,6 +74,7 @@ namespace Graphics {
       }
       glBindTexture(texture_type, 0);
       loaded = true;
+      path = filename;
       LOG(INFO)<<"Texture file: "<<filename<<" loaded!";
     }
     else {
@@ -66,19 +84,79 @@ namespace Graphics {
     return success;
   }
 
+  bool BaseTexture::loadFromData(const unsigned int width, const unsigned int height, const GLenum internal_format, const GLenum format, const GLenum type, const void* data) {
+    if(texture == nullptr)
+      texture = GPUResourceRegistry::create(GPUResourceType::TEXTURE);
+    glBindTexture(texture_type, texture->getObject());
+    this->width = width;
+    this->height = height;
+    texture->setBytes(width * height * bytesPerTexel(internal_format));
+    path.clear();
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(texture_type, 0, internal_format, width, height, 0, format, type, data);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(texture_type, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(texture_type, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(texture_type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(texture_type, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(texture_type, 0);
+
+    loaded = true;
+    return true;
+  }
+
   void BaseTexture::bind(const unsigned int texture_unit) {
     if(!loaded)
       throw Exceptions::TextureNotLoadedException();
 
+    //Loading an evicted texture again unbinds it from the active unit, that has to be this one
     glActiveTexture(GL_TEXTURE0 + texture_unit);
-    glBindTexture(texture_type, texture_object);
+    if(!makeResident())
+      throw Exceptions::TextureNotLoadedException();
+
+    last_used_frame = GPUResourceRegistry::getFrame();
+    glBindTexture(texture_type, texture->getObject());
   }
 
   unsigned int BaseTexture::getTextureObject() const noexcept {
-    return texture_object;
+    return texture != nullptr ? texture->getObject() : 0;
   }
 
 
+  bool BaseTexture::isResident() const noexcept {
+    return texture != nullptr;
+  }
+
+  bool BaseTexture::isEvictable() const noexcept {
+    return texture != nullptr && !path.empty();
+  }
+
+  bool BaseTexture::evict() noexcept {
+    if(!isEvictable())
+      return false;
+    //Deleted at the end of the frame, in case it's bound right now
+    texture.reset();
+    return true;
+  }
+
+  bool BaseTexture::makeResident() {
+    if(texture != nullptr)
+      return true;
+    if(path.empty())
+      return false;
+    LOG(INFO)<<"Texture: "<<getName()<<" was evicted, loading it again";
+    return load(path);
+  }
+
+  unsigned long long BaseTexture::getLastUsedFrame() const noexcept {
+    return last_used_frame;
+  }
+
+  size_t BaseTexture::getBytes() const noexcept {
+    return texture != nullptr ? texture->getBytes() : 0;
+  }
+
   bool BaseTexture::isLoaded() const noexcept {
     return loaded;
   }
@@ -94,7 +172,7 @@ namespace Graphics {
   std::string BaseTexture::to_string() const noexcept {
     std::stringstream str;
 
-    str << "Texture: "<<getName()<<" Width: "<<getWidth()<<" Height: "<<getHeight()<<" Loaded: "<<isLoaded();
+    str << "Texture: "<<getName()<<" Width: "<<getWidth()<<" Height: "<<getHeight()<<" Loaded: "<<isLoaded()<<" Resident: "<<isResident();
     return str.str();
   }
 }
@@ -7,18 +7,28 @@
 #include <glad/glad.h>
 #endif
 #include <string>
+#include "gpu_resource.h"
+
 namespace Graphics {
   /**
    * @brief      Class for base texture.
+   *
+   * @detail     A texture loaded from a file can be evicted from GPU memory, it's loaded from the
+   * file again the next time it's bound or made resident.
    */
   class [[scriptable]] BaseTexture {
     private:
-      unsigned int texture_object;
+      std::shared_ptr<GPUResource> texture;
       GLenum texture_type;
       bool loaded;
       unsigned int width;
       unsigned int height;
       std::string name;
+      //Empty for textures loaded from data, those can't be evicted
+      std::string path;
+      unsigned long long last_used_frame;
+
+      static size_t bytesPerTexel(const GLenum internal_format) noexcept;
     public:
       BaseTexture() = delete;
 
@@ -28,10 +38,6 @@ namespace Graphics {
        * @param[in]  texture_type  The open gl texture type
        */
       [[scriptable]] BaseTexture(const GLenum texture_type);
-      /**
-       * @brief      Destroys the object.
-       */
-      ~BaseTexture();
 
       /**
        * @brief      Gets the width.
@@ -54,6 +60,19 @@ namespace Graphics {
        * @return     True on success
        */
       [[scriptable]] virtual bool load(const std::string& filename);
+      /**
+       * @brief      Loads the texture from raw pixel data, without mipmaps and with nearest filtering
+       *
+       * @param[in]  width            The width
+       * @param[in]  height           The height
+       * @param[in]  internal_format  The opengl internal format
+       * @param[in]  format           The format of the pixel data
+       * @param[in]  type             The type of the pixel data
+       * @param[in]  data             The pixel data
+       *
+       * @return     True on success
+       */
+      virtual bool loadFromData(const unsigned int width, const unsigned int height, const GLenum internal_format, const GLenum format, const GLenum type, const void* data);
       /**
        * @brief      Binds texture to opengl on the texture unit.
        *
@@ -93,6 +112,43 @@ namespace Graphics {
        * @return     The texture object.
        */
       virtual unsigned int getTextureObject() const noexcept;
+
+      /**
+       * @brief      Determines if the texture is in GPU memory.
+       *
+       * @return     True if resident, False if evicted.
+       */
+      [[scriptable]] bool isResident() const noexcept;
+      /**
+       * @brief      Determines if the texture can be evicted.
+       *
+       * @return     True if it was loaded from a file and is resident, False otherwise.
+       */
+      [[scriptable]] bool isEvictable() const noexcept;
+      /**
+       * @brief      Frees the GPU memory of the texture, keeping what's needed to load it again.
+       *
+       * @return     True if evicted, False if the texture isn't evictable.
+       */
+      [[scriptable]] bool evict() noexcept;
+      /**
+       * @brief      Loads an evicted texture from its file again.
+       *
+       * @return     True if resident afterwards
+       */
+      [[scriptable]] bool makeResident();
+      /**
+       * @brief      Gets the frame the texture was last bound on.
+       *
+       * @return     The frame, counted by GPUResourceRegistry.
+       */
+      [[scriptable]] unsigned long long getLastUsedFrame() const noexcept;
+      /**
+       * @brief      Gets the GPU memory the texture takes up.
+       *
+       * @return     The bytes, 0 when evicted.
+       */
+      [[scriptable]] size_t getBytes() const noexcept;
   };
 }
 
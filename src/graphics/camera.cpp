@@ -28,7 +28,7 @@ namespace Graphics {
     projection_matrix = glm::ortho(viewport_width / -2.0f, viewport_width / 2.0f, viewport_height / -2.0f, viewport_height / 2.0f, near, far);
     shader_manager->setUniformForAllPrograms<glm::mat4>("projection", projection_matrix);
 
-    shader_manager->setUniformForAllPrograms<glm::mat4>("view", negateTransformForScreen(getTransform()).getAbsoluteTransformationMatrix());
+    shader_manager->setUniformForAllPrograms<glm::mat4>("view", getViewMatrix());
     last_projection_matrix = projection_matrix;
     last_transform = *getTransform();
     target_position = glm::vec2(getTransform()->getLocalTranslation());
@@ -71,7 +71,7 @@ namespace Graphics {
     }
 
     if(last_transform != *getTransform()) {
-      shader_manager->setUniformForAllPrograms<glm::mat4>("view", negateTransformForScreen(getTransform()).getAbsoluteTransformationMatrix());
+      shader_manager->setUniformForAllPrograms<glm::mat4>("view", getViewMatrix());
       last_transform = *getTransform();
     }
     return true;
@@ -223,6 +223,10 @@ namespace Graphics {
     return projection_matrix;
   }
 
+  glm::mat4 Camera::getViewMatrix() const noexcept {
+    return negateTransformForScreen(getTransform()).getAbsoluteTransformationMatrix();
+  }
+
   unsigned long long Camera::getValueForSorting() const noexcept {
     return getId();
   }
@@ -242,7 +246,7 @@ namespace Graphics {
            camera_bound_top >= translation.y;
   }
 
-  Transform Camera::negateTransformForScreen(std::shared_ptr<Transform> trans) {
+  Transform Camera::negateTransformForScreen(std::shared_ptr<Transform> trans) const {
     //Gotta do this to make the camera move the opposite the renderables
     Transform negated_for_screen = *trans;
     negated_for_screen.translate(glm::vec3(-2.0, -2.0, 1.0) * negated_for_screen.getAbsoluteTranslation());
@@ -35,7 +35,7 @@ namespace Graphics {
       bool free_camera;
       float free_camera_speed;
 
-      Transform negateTransformForScreen(std::shared_ptr<Transform> trans);
+      Transform negateTransformForScreen(std::shared_ptr<Transform> trans) const;
     public:
       Camera() = delete;
       /**
@@ -137,6 +137,12 @@ namespace Graphics {
        * @return     The projection matrix.
        */
       [[scriptable]] glm::mat4 getProjectionMatrix() const noexcept;
+      /**
+       * @brief      Gets the view matrix.
+       *
+       * @return     The view matrix.
+       */
+      [[scriptable]] glm::mat4 getViewMatrix() const noexcept;
 
       /**
        * @brief      Determines if component within.
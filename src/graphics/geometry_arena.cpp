@@ -0,0 +1,151 @@
+#include <easylogging++.h>
+#include <algorithm>
+#include <stdexcept>
+#include "geometry_arena.h"
+
+namespace Graphics {
+  GeometryArena::Page::Page(const VertexAttribute* attributes, const size_t attribute_count, const size_t stride, const bool quads, const size_t vertex_capacity, const size_t index_capacity) :
+    attributes(attributes, attributes + attribute_count), stride(stride), quads(quads), index_buffer_object(0), vertices(vertex_capacity), indices(quads ? 0 : index_capacity) {
+    vertex_array = GPUResourceRegistry::create(GPUResourceType::VERTEX_ARRAY);
+    vertex_array_object = vertex_array->getObject();
+    glBindVertexArray(vertex_array_object);
+
+    auto vertex_buffer = GPUResourceRegistry::create(GPUResourceType::BUFFER);
+    vertex_buffer_object = vertex_buffer->getObject();
+    glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_object);
+    glBufferData(GL_ARRAY_BUFFER, vertex_capacity * stride, nullptr, GL_STATIC_DRAW);
+    vertex_buffer->setBytes(vertex_capacity * stride);
+    vertex_array->addDependency(vertex_buffer);
+
+    BaseVertexLayout::setAttributePointers(attributes, attribute_count, stride);
+
+    //Quad pages hold the quad indices of all their vertices once, allocations only take vertices
+    if(quads) {
+      auto quad_indices = BaseVertexLayout::quadIndices(vertex_capacity / 4);
+      auto index_buffer = GPUResourceRegistry::create(GPUResourceType::BUFFER);
+      index_buffer_object = index_buffer->getObject();
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_object);
+      glBufferData(GL_ELEMENT_ARRAY_BUFFER, quad_indices.size() * sizeof(unsigned int), quad_indices.data(), GL_STATIC_DRAW);
+      index_buffer->setBytes(quad_indices.size() * sizeof(unsigned int));
+      vertex_array->addDependency(index_buffer);
+    }
+    else if(index_capacity > 0) {
+      auto index_buffer = GPUResourceRegistry::create(GPUResourceType::BUFFER);
+      index_buffer_object = index_buffer->getObject();
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_object);
+      glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_capacity * sizeof(unsigned int), nullptr, GL_STATIC_DRAW);
+      index_buffer->setBytes(index_capacity * sizeof(unsigned int));
+      vertex_array->addDependency(index_buffer);
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  }
+
+  bool GeometryArena::Page::hasLayout(const VertexAttribute* attributes, const size_t attribute_count, const size_t stride, const bool quads) const noexcept {
+    if(this->stride != stride || this->quads != quads || this->attributes.size() != attribute_count)
+      return false;
+    return std::equal(this->attributes.begin(), this->attributes.end(), attributes, [](const VertexAttribute& lhs, const VertexAttribute& rhs) {
+      return lhs.location == rhs.location && lhs.width == rhs.width && lhs.component_type == rhs.component_type && lhs.mode == rhs.mode && lhs.offset == rhs.offset;
+    });
+  }
+
+  GeometryArena::Allocation::Allocation(std::weak_ptr<GeometryArena> arena, Page* page, const VertexRecord& record) : arena(arena), page(page), record(record) {
+  }
+
+  GeometryArena::Allocation::~Allocation() {
+    //The arena goes with the GL context, its pages are gone already
+    auto owner = arena.lock();
+    if(owner != nullptr)
+      owner->free(page, record);
+  }
+
+  unsigned int GeometryArena::Allocation::getVertexArrayObject() const noexcept {
+    return page->vertex_array_object;
+  }
+
+  VertexRecord GeometryArena::Allocation::getRecord() const noexcept {
+    return record;
+  }
+
+  bool GeometryArena::Allocation::isQuads() const noexcept {
+    return page->quads;
+  }
+
+  std::shared_ptr<GeometryArena::Allocation> GeometryArena::allocate(const VertexAttribute* attributes, const size_t attribute_count, const size_t stride, const bool quads, const std::vector<unsigned char>& vertices, const std::vector<unsigned int>& indices, const VertexRecord& record) {
+    auto vertex_count = vertices.size() / stride;
+    if(quads && (vertex_count % 4 != 0 || !indices.empty()))
+      throw std::invalid_argument("Quad geometry needs four vertices per quad and no indices");
+    Page* page = nullptr;
+    size_t first_vertex = RangeAllocator::INVALID;
+    size_t first_index = RangeAllocator::INVALID;
+
+    for(auto& candidate : pages) {
+      if(!candidate->hasLayout(attributes, attribute_count, stride, quads))
+        continue;
+
+      first_vertex = candidate->vertices.allocate(vertex_count);
+      if(first_vertex == RangeAllocator::INVALID)
+        continue;
+      first_index = candidate->indices.allocate(indices.size());
+      if(first_index == RangeAllocator::INVALID) {
+        candidate->vertices.free(first_vertex, vertex_count);
+        continue;
+      }
+      page = candidate.get();
+      break;
+    }
+
+    //Geometry larger than a page gets a page of its own size
+    if(page == nullptr) {
+      auto vertex_capacity = std::max(PAGE_VERTEX_BYTES / stride, vertex_count);
+      auto index_capacity = std::max(PAGE_INDICES, indices.size());
+      pages.push_back(std::unique_ptr<Page>(new Page(attributes, attribute_count, stride, quads, vertex_capacity, index_capacity)));
+      page = pages.back().get();
+      first_vertex = page->vertices.allocate(vertex_count);
+      first_index = page->indices.allocate(indices.size());
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, page->vertex_buffer_object);
+    glBufferSubData(GL_ARRAY_BUFFER, first_vertex * stride, vertices.size(), vertices.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if(indices.size() > 0) {
+      //The element array binding belongs to whichever vertex array is bound, core profiles have no default one
+      glBindBuffer(GL_COPY_WRITE_BUFFER, page->index_buffer_object);
+      glBufferSubData(GL_COPY_WRITE_BUFFER, first_index * sizeof(unsigned int), indices.size() * sizeof(unsigned int), indices.data());
+      glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    //Quads draw the page's quad indices from the start, offset by their first vertex
+    auto index_count = quads ? vertex_count / 4 * 6 : record.getIndexCount();
+    if(quads)
+      first_index = 0;
+    VertexRecord page_record(record.getPrimitiveType(), record.getVertexCount(), index_count, record.getLow(), record.getHigh(), first_vertex, first_index);
+    return std::make_shared<Allocation>(shared_from_this(), page, page_record);
+  }
+
+  void GeometryArena::free(Page* page, const VertexRecord& record) {
+    page->vertices.free(record.getFirstVertex(), record.getVertexCount());
+    if(!page->quads)
+      page->indices.free(record.getFirstIndex(), record.getIndexCount());
+
+    if(page->vertices.getUsed() == 0 && page->indices.getUsed() == 0) {
+      pages.remove_if([page](const std::unique_ptr<Page>& candidate) {
+        return candidate.get() == page;
+      });
+    }
+  }
+
+  unsigned int GeometryArena::getPageCount() const noexcept {
+    return pages.size();
+  }
+
+  unsigned int GeometryArena::getUsedVertexBytes() const noexcept {
+    unsigned int used = 0;
+    for(auto& page : pages) {
+      used += page->vertices.getUsed() * page->stride;
+    }
+    return used;
+  }
+}
@@ -0,0 +1,155 @@
+#ifndef GEOMETRY_ARENA_H
+#define GEOMETRY_ARENA_H
+#ifdef __APPLE__
+#include <OpenGL/gl3.h>
+#else
+#include <glad/glad.h>
+#endif
+#include <list>
+#include <memory>
+#include <vector>
+#include "range_allocator.h"
+#include "vertex_layout.h"
+#include "vertex_record.h"
+#include "gpu_resource.h"
+
+namespace Graphics {
+  /**
+   * @brief      Large vertex and index buffers shared by the static geometry of many renderables.
+   *
+   * @detail     Geometry is suballocated from pages, each page a vertex buffer, an index buffer and
+   * a vertex array object for one vertex layout. Renderables draw their range of the page with a
+   * first vertex and first index, so renderables with the same layout share buffers and vertex
+   * array. An allocation returns its range when it's destroyed, and a page that empties is deleted,
+   * so unloading a scene gives its GPU memory back.
+   */
+  class [[scriptable]] GeometryArena : public std::enable_shared_from_this<GeometryArena> {
+    private:
+      struct Page {
+        std::vector<VertexAttribute> attributes;
+        size_t stride;
+        bool quads;
+        unsigned int vertex_array_object;
+        unsigned int vertex_buffer_object;
+        unsigned int index_buffer_object;
+        //Holds the buffers too, queued for deletion along with the page
+        std::shared_ptr<GPUResource> vertex_array;
+        RangeAllocator vertices;
+        RangeAllocator indices;
+
+        Page(const VertexAttribute* attributes, const size_t attribute_count, const size_t stride, const bool quads, const size_t vertex_capacity, const size_t index_capacity);
+        bool hasLayout(const VertexAttribute* attributes, const size_t attribute_count, const size_t stride, const bool quads) const noexcept;
+      };
+
+    public:
+      /**
+       * @brief      A range of a page, freed when destroyed
+       */
+      class Allocation {
+        private:
+          std::weak_ptr<GeometryArena> arena;
+          Page* page;
+          VertexRecord record;
+
+        public:
+          /**
+           * @brief      Allocation constructor
+           *
+           * @param[in]  arena   The arena
+           * @param[in]  page    The page
+           * @param[in]  record  The record, with the first vertex and index in the page
+           */
+          Allocation(std::weak_ptr<GeometryArena> arena, Page* page, const VertexRecord& record);
+          ~Allocation();
+
+          //Remove copy constructor and assignment
+          Allocation(const Allocation&) = delete;
+          Allocation operator=(Allocation&) = delete;
+
+          /**
+           * @brief      Gets the vertex array object of the page.
+           *
+           * @return     The vertex array object.
+           */
+          unsigned int getVertexArrayObject() const noexcept;
+          /**
+           * @brief      Gets the record.
+           *
+           * @return     The record, with the first vertex and index in the page.
+           */
+          VertexRecord getRecord() const noexcept;
+          /**
+           * @brief      Determines if the allocation is quads drawn with the page's shared indices.
+           *
+           * @return     True if quads, False otherwise.
+           */
+          bool isQuads() const noexcept;
+      };
+
+      /**
+       * Bytes of vertices per page
+       */
+      static const size_t PAGE_VERTEX_BYTES = 4 * 1024 * 1024;
+      /**
+       * Indices per page
+       */
+      static const size_t PAGE_INDICES = 256 * 1024;
+
+    private:
+      std::list<std::unique_ptr<Page>> pages;
+
+      std::shared_ptr<Allocation> allocate(const VertexAttribute* attributes, const size_t attribute_count, const size_t stride, const bool quads, const std::vector<unsigned char>& vertices, const std::vector<unsigned int>& indices, const VertexRecord& record);
+      void free(Page* page, const VertexRecord& record);
+
+    public:
+      GeometryArena() = default;
+
+      //Remove copy constructor and assignment
+      GeometryArena(const GeometryArena&) = delete;
+      GeometryArena operator=(GeometryArena&) = delete;
+
+      /**
+       * @brief      Uploads vertices to a page with their layout.
+       *
+       * @param[in]  vertex_layout  The vertices
+       *
+       * @tparam     Attributes     The vertex attributes
+       *
+       * @return     The allocation, the range is freed when it's destroyed.
+       */
+      template<class... Attributes>
+      std::shared_ptr<Allocation> allocate(const VertexLayout<Attributes...>& vertex_layout) {
+        auto attributes = VertexLayout<Attributes...>::getAttributes();
+        return allocate(attributes.data(), attributes.size(), VertexLayout<Attributes...>::stride, false, vertex_layout.getVertexBytes(), vertex_layout.getIndices(), vertex_layout.getRecord());
+      }
+      /**
+       * @brief      Uploads quads to a page whose quad indices are shared by all its allocations.
+       *
+       * @param[in]  vertex_layout  Four vertices per quad and no indices, see BaseVertexLayout::quadIndices
+       *
+       * @tparam     Attributes     The vertex attributes
+       *
+       * @return     The allocation, the range is freed when it's destroyed.
+       */
+      template<class... Attributes>
+      std::shared_ptr<Allocation> allocateQuads(const VertexLayout<Attributes...>& vertex_layout) {
+        auto attributes = VertexLayout<Attributes...>::getAttributes();
+        return allocate(attributes.data(), attributes.size(), VertexLayout<Attributes...>::stride, true, vertex_layout.getVertexBytes(), vertex_layout.getIndices(), vertex_layout.getRecord());
+      }
+
+      /**
+       * @brief      Gets the number of pages.
+       *
+       * @return     The page count.
+       */
+      [[scriptable]] unsigned int getPageCount() const noexcept;
+      /**
+       * @brief      Gets the vertex bytes in use.
+       *
+       * @return     The allocated vertex bytes over all pages.
+       */
+      [[scriptable]] unsigned int getUsedVertexBytes() const noexcept;
+  };
+}
+
+#endif
@@ -0,0 +1,169 @@
+#ifdef __APPLE__
+#include <OpenGL/gl3.h>
+#else
+#include <glad/glad.h>
+#endif
+#include <easylogging++.h>
+#include "gpu_resource.h"
+
+namespace Graphics {
+  std::mutex GPUResourceRegistry::mutex;
+  std::vector<std::pair<GPUResourceType, unsigned int>> GPUResourceRegistry::pending;
+  std::map<std::string, unsigned int> GPUResourceRegistry::resource_counts;
+  std::string GPUResourceRegistry::current_owner = "";
+  size_t GPUResourceRegistry::total_bytes = 0;
+  bool GPUResourceRegistry::context_alive = true;
+  unsigned long long GPUResourceRegistry::frame = 0;
+
+  GPUResource::GPUResource(const GPUResourceType type, const unsigned int object, const std::string& owner) : type(type), object(object), owner(owner), bytes(0) {
+  }
+
+  GPUResource::~GPUResource() {
+    GPUResourceRegistry::release(type, object, owner, bytes);
+  }
+
+  GPUResourceType GPUResource::getType() const noexcept {
+    return type;
+  }
+
+  unsigned int GPUResource::getObject() const noexcept {
+    return object;
+  }
+
+  std::string GPUResource::getOwner() const noexcept {
+    return owner;
+  }
+
+  void GPUResource::setBytes(const size_t bytes) noexcept {
+    GPUResourceRegistry::resize(this->bytes, bytes);
+    this->bytes = bytes;
+  }
+
+  size_t GPUResource::getBytes() const noexcept {
+    return bytes;
+  }
+
+  void GPUResource::addDependency(std::shared_ptr<GPUResource> dependency) {
+    if(dependency != nullptr)
+      dependencies.push_back(dependency);
+  }
+
+  std::shared_ptr<GPUResource> GPUResourceRegistry::create(const GPUResourceType type) {
+    unsigned int object = 0;
+    switch(type) {
+      case GPUResourceType::TEXTURE:
+        glGenTextures(1, &object);
+        break;
+      case GPUResourceType::BUFFER:
+        glGenBuffers(1, &object);
+        break;
+      case GPUResourceType::VERTEX_ARRAY:
+        glGenVertexArrays(1, &object);
+        break;
+      case GPUResourceType::FRAMEBUFFER:
+        glGenFramebuffers(1, &object);
+        break;
+    }
+    return adopt(type, object);
+  }
+
+  std::shared_ptr<GPUResource> GPUResourceRegistry::adopt(const GPUResourceType type, const unsigned int object) {
+    if(object == 0)
+      return nullptr;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    resource_counts[current_owner]++;
+    return std::make_shared<GPUResource>(type, object, current_owner);
+  }
+
+  void GPUResourceRegistry::release(const GPUResourceType type, const unsigned int object, const std::string& owner, const size_t bytes) noexcept {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto count = resource_counts.find(owner);
+    if(count != resource_counts.end() && --count->second == 0)
+      resource_counts.erase(count);
+    total_bytes -= bytes;
+
+    //Deleted with the context already
+    if(context_alive)
+      pending.push_back(std::make_pair(type, object));
+  }
+
+  void GPUResourceRegistry::resize(const size_t old_bytes, const size_t new_bytes) noexcept {
+    std::lock_guard<std::mutex> lock(mutex);
+    total_bytes = total_bytes - old_bytes + new_bytes;
+  }
+
+  void GPUResourceRegistry::collect() {
+    std::vector<std::pair<GPUResourceType, unsigned int>> released;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      released.swap(pending);
+      frame++;
+    }
+
+    for(auto& resource : released) {
+      switch(resource.first) {
+        case GPUResourceType::TEXTURE:
+          glDeleteTextures(1, &resource.second);
+          break;
+        case GPUResourceType::BUFFER:
+          glDeleteBuffers(1, &resource.second);
+          break;
+        case GPUResourceType::VERTEX_ARRAY:
+          glDeleteVertexArrays(1, &resource.second);
+          break;
+        case GPUResourceType::FRAMEBUFFER:
+          glDeleteFramebuffers(1, &resource.second);
+          break;
+      }
+    }
+  }
+
+  void GPUResourceRegistry::shutdown() {
+    collect();
+    std::lock_guard<std::mutex> lock(mutex);
+    context_alive = false;
+    for(auto& count : resource_counts) {
+      LOG(INFO)<<count.second<<" GPU resources of "<<(count.first.empty() ? "no owner" : count.first)<<" still held at shutdown";
+    }
+  }
+
+  void GPUResourceRegistry::setOwner(const std::string& owner) {
+    std::lock_guard<std::mutex> lock(mutex);
+    current_owner = owner;
+  }
+
+  std::string GPUResourceRegistry::getOwner() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return current_owner;
+  }
+
+  unsigned int GPUResourceRegistry::getResourceCount(const std::string& owner) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto count = resource_counts.find(owner);
+    return count != resource_counts.end() ? count->second : 0;
+  }
+
+  unsigned int GPUResourceRegistry::getPendingCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending.size();
+  }
+
+  size_t GPUResourceRegistry::getTotalBytes() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return total_bytes;
+  }
+
+  unsigned long long GPUResourceRegistry::getFrame() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return frame;
+  }
+
+  GPUResourceOwnerScope::GPUResourceOwnerScope(const std::string& owner) : previous_owner(GPUResourceRegistry::getOwner()) {
+    GPUResourceRegistry::setOwner(owner);
+  }
+
+  GPUResourceOwnerScope::~GPUResourceOwnerScope() {
+    GPUResourceRegistry::setOwner(previous_owner);
+  }
+}
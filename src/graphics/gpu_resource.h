@@ -0,0 +1,195 @@
+#ifndef GPU_RESOURCE_H
+#define GPU_RESOURCE_H
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Graphics {
+  /**
+   * @brief      Kinds of GL objects a GPUResource can hold
+   */
+  enum class GPUResourceType : unsigned int { TEXTURE, BUFFER, VERTEX_ARRAY, FRAMEBUFFER };
+
+  /**
+   * @brief      A GL object, deleted once the last shared_ptr to it is gone.
+   *
+   * @detail     The object isn't deleted right away, the destructor can run on any thread and in the
+   * middle of a frame. It's queued with GPUResourceRegistry and deleted at the end of the frame.
+   */
+  class [[scriptable]] GPUResource {
+    private:
+      GPUResourceType type;
+      unsigned int object;
+      std::string owner;
+      size_t bytes;
+      //Objects that only exist for this one, like the buffers of a vertex array
+      std::vector<std::shared_ptr<GPUResource>> dependencies;
+
+    public:
+      GPUResource() = delete;
+      /**
+       * @brief      GPUResource constructor, use GPUResourceRegistry to create resources
+       *
+       * @param[in]  type    The type
+       * @param[in]  object  The GL object
+       * @param[in]  owner   The owner
+       */
+      GPUResource(const GPUResourceType type, const unsigned int object, const std::string& owner);
+      ~GPUResource();
+
+      //Remove copy constructor and assignment
+      GPUResource(const GPUResource&) = delete;
+      GPUResource operator=(GPUResource&) = delete;
+
+      /**
+       * @brief      Gets the type.
+       *
+       * @return     The type.
+       */
+      GPUResourceType getType() const noexcept;
+      /**
+       * @brief      Gets the GL object.
+       *
+       * @return     The GL object.
+       */
+      [[scriptable]] unsigned int getObject() const noexcept;
+      /**
+       * @brief      Gets the owner.
+       *
+       * @return     The name of the scene, or whatever else was loading, when the resource was created.
+       */
+      [[scriptable]] std::string getOwner() const noexcept;
+      /**
+       * @brief      Sets the GPU memory the resource takes up.
+       *
+       * @param[in]  bytes  The bytes
+       */
+      void setBytes(const size_t bytes) noexcept;
+      /**
+       * @brief      Gets the GPU memory the resource takes up.
+       *
+       * @return     The bytes.
+       */
+      [[scriptable]] size_t getBytes() const noexcept;
+      /**
+       * @brief      Keeps a resource alive for as long as this one is.
+       *
+       * @param[in]  dependency  The dependency
+       */
+      void addDependency(std::shared_ptr<GPUResource> dependency);
+  };
+
+  /**
+   * @brief      Creates GL objects and deletes them at a point in the frame where it's safe to.
+   *
+   * @detail     Resources are counted by owner, the scene that was loading when they were created,
+   * so what a scene leaves behind after it's unloaded shows up in getResourceCount.
+   */
+  class [[scriptable]] GPUResourceRegistry {
+    private:
+      static std::mutex mutex;
+      static std::vector<std::pair<GPUResourceType, unsigned int>> pending;
+      static std::map<std::string, unsigned int> resource_counts;
+      static std::string current_owner;
+      static size_t total_bytes;
+      static bool context_alive;
+      static unsigned long long frame;
+
+      friend class GPUResource;
+      static void release(const GPUResourceType type, const unsigned int object, const std::string& owner, const size_t bytes) noexcept;
+      static void resize(const size_t old_bytes, const size_t new_bytes) noexcept;
+    public:
+      /**
+       * @brief      Generates a GL object.
+       *
+       * @param[in]  type  The type
+       *
+       * @return     The resource.
+       */
+      static std::shared_ptr<GPUResource> create(const GPUResourceType type);
+      /**
+       * @brief      Takes ownership of a GL object generated elsewhere.
+       *
+       * @param[in]  type    The type
+       * @param[in]  object  The GL object
+       *
+       * @return     The resource, nullptr if object is 0.
+       */
+      static std::shared_ptr<GPUResource> adopt(const GPUResourceType type, const unsigned int object);
+
+      /**
+       * @brief      Deletes the GL objects released since the last collect.
+       *
+       * @detail     Called by the graphics system at the end of every frame, on the thread owning the context.
+       */
+      static void collect();
+      /**
+       * @brief      Deletes whatever is left and drops anything released after, the context is going away.
+       */
+      static void shutdown();
+
+      /**
+       * @brief      Sets the owner of the resources created from now on.
+       *
+       * @param[in]  owner  The owner, empty for none
+       */
+      [[scriptable]] static void setOwner(const std::string& owner);
+      /**
+       * @brief      Gets the owner of the resources created from now on.
+       *
+       * @return     The owner.
+       */
+      [[scriptable]] static std::string getOwner();
+      /**
+       * @brief      Gets the number of live resources of an owner.
+       *
+       * @param[in]  owner  The owner
+       *
+       * @return     The resource count.
+       */
+      [[scriptable]] static unsigned int getResourceCount(const std::string& owner);
+      /**
+       * @brief      Gets the number of resources waiting to be deleted.
+       *
+       * @return     The pending count.
+       */
+      [[scriptable]] static unsigned int getPendingCount();
+      /**
+       * @brief      Gets the GPU memory of all live resources that report it.
+       *
+       * @return     The bytes.
+       */
+      [[scriptable]] static size_t getTotalBytes();
+      /**
+       * @brief      Gets the number of frames collected so far.
+       *
+       * @return     The frame.
+       */
+      [[scriptable]] static unsigned long long getFrame();
+  };
+
+  /**
+   * @brief      Sets the registry owner for a scope and restores the previous one after.
+   */
+  class GPUResourceOwnerScope {
+    private:
+      std::string previous_owner;
+    public:
+      /**
+       * @brief      GPUResourceOwnerScope constructor
+       *
+       * @param[in]  owner  The owner of resources created in the scope
+       */
+      GPUResourceOwnerScope(const std::string& owner);
+      ~GPUResourceOwnerScope();
+
+      //Remove copy constructor and assignment
+      GPUResourceOwnerScope(const GPUResourceOwnerScope&) = delete;
+      GPUResourceOwnerScope operator=(GPUResourceOwnerScope&) = delete;
+  };
+}
+
+#endif
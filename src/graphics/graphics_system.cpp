@@ -18,7 +18,7 @@
 
 namespace Graphics {
 
-  GraphicsSystem::GraphicsSystem() : window(nullptr), initialized(false), next_id(1), max_influence_lights(8) {
+  GraphicsSystem::GraphicsSystem() : window(nullptr), initialized(false), next_id(1), max_influence_lights(16), light_grid(std::make_shared<LightGrid>()), lighting_mode(LightingMode::FORWARD) {
   }
 
   GraphicsSystem::~GraphicsSystem() {
@@ -65,9 +65,18 @@ namespace Graphics {
         LOG(ERROR)<<"Glad could not be initialized!";
         throw std::runtime_error("Glad could not be initialized!");
       }
+
+      //Let the driver pick how many threads compile shaders, see Shader::isReady
+      if(GLAD_GL_KHR_parallel_shader_compile)
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+      else if(GLAD_GL_ARB_parallel_shader_compile)
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
     #endif
 
     ilInit();
+    streaming_buffer = std::make_shared<StreamingBuffer>(GL_ARRAY_BUFFER, STREAMING_SEGMENT_SIZE);
+    light_accumulation = std::make_shared<LightAccumulationBuffer>();
+    geometry_arena = std::make_shared<GeometryArena>();
     glfwSetFramebufferSizeCallback(window, windowSizeCallback);
 
     glfwSetWindowTitle(window, window_title.c_str());
@@ -159,38 +168,51 @@ namespace Graphics {
     if(!initialized)
       throw Exceptions::SystemNotInitializedException("Graphics");
 
+    streaming_buffer->beginFrame();
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    // for(auto& renderables_iter : renderables_map) {
-    //   if(renderables_iter.second->isActive() && !camera->isRenderableWithin(renderables_iter.second)) {
-    //     renderables_iter.second->setActive(false);
-    //   }
-    //   else if(!renderables_iter.second->isActive() && camera->isRenderableWithin(renderables_iter.second)) {
-    //     renderables_iter.second->setActive(true);
-    //   }
-      //   if(renderables_iter.second->isLightReactive()) {
-      //     //find lights that influence renderable
-      //     std::priority_queue<RankedLight, std::vector<RankedLight>, std::less<RankedLight>> light_queue;
-
-      //     for(auto& light : lights) {
-      //       auto influence = light->influenceOnComponent(*renderables_iter.second);
-      //       if(influence > 0.0)
-      //         light_queue.push(RankedLight { light,  influence });
-      //     }
-      //     renderables_iter.second->clearInfluencingLights();
-      //     for(int i = 0; i < max_influence_lights && !light_queue.empty(); i++) {
-      //       renderables_iter.second->addInfluencingLight(light_queue.top().light);
-      //       light_queue.pop();
-      //     }
-      //   }
-      // }
-    // }
+    accumulateLights();
+  }
+
+  void GraphicsSystem::accumulateLights() {
+    bool deferred = lighting_mode == LightingMode::DEFERRED && camera != nullptr && light_accumulation->getShader() != nullptr;
+    glm::vec4 bounds(0.0);
+    glm::vec2 view_size(1.0);
+    if(deferred) {
+      view_size = glm::vec2(camera->getWidth(), camera->getHeight());
+      auto extent = view_size + 2.0f * LIGHT_ACCUMULATION_MARGIN;
+      bounds = glm::vec4(glm::vec2(camera->getTransform()->getAbsoluteTranslation()) - extent / 2.0f, extent);
+    }
+
+    //Lights move, so they are binned again every frame
+    light_grid->setAccumulationBounds(bounds);
+    light_grid->build(lights, max_influence_lights);
+    light_grid->upload();
+
+    if(deferred) {
+      //Same pixel density as the screen
+      int width, height;
+      glfwGetFramebufferSize(window, &width, &height);
+      auto scale = glm::vec2(bounds.z, bounds.w) / view_size;
+      light_accumulation->render(bounds, (int)(width * scale.x), (int)(height * scale.y), lights.size());
+    }
   }
 
   void GraphicsSystem::stopFrame() {
+    streaming_buffer->endFrame();
+    //Nothing is drawing anymore, whatever was released during the frame can go
+    GPUResourceRegistry::collect();
     glfwSwapBuffers(window);
   }
 
+  std::shared_ptr<StreamingBuffer> GraphicsSystem::getStreamingBuffer() const noexcept {
+    return streaming_buffer;
+  }
+
+  std::shared_ptr<GeometryArena> GraphicsSystem::getGeometryArena() const noexcept {
+    return geometry_arena;
+  }
+
   GLFWwindow* GraphicsSystem::getWindow() const noexcept {
     return window;
   }
@@ -218,6 +240,28 @@ namespace Graphics {
     return max_influence_lights;
   }
 
+  void GraphicsSystem::setLightCellSize(const float cell_size) noexcept {
+    light_grid->setCellSize(cell_size);
+  }
+
+  void GraphicsSystem::setLightingMode(const LightingMode mode) noexcept {
+    lighting_mode = mode;
+  }
+
+  GraphicsSystem::LightingMode GraphicsSystem::getLightingMode() const noexcept {
+    return lighting_mode;
+  }
+
+  void GraphicsSystem::setLightAccumulationShader(std::shared_ptr<Shader> shader) {
+    if(!initialized)
+      throw Exceptions::SystemNotInitializedException("Graphics");
+    light_accumulation->setShader(shader);
+  }
+
+  void GraphicsSystem::setCamera(std::shared_ptr<Camera> camera) noexcept {
+    this->camera = camera;
+  }
+
   void GraphicsSystem::addLight(std::shared_ptr<Light> light) noexcept {
     lights.push_back(light);
   }
@@ -231,6 +275,14 @@ namespace Graphics {
       throw Exceptions::SystemNotInitializedException("Graphics");
 
     initialized = false;
+    //GL objects have to go before the context does
+    streaming_buffer.reset();
+    light_accumulation.reset();
+    //Allocations still held by renderables see the arena is gone and don't free
+    geometry_arena.reset();
+    light_grid = std::make_shared<LightGrid>(light_grid->getCellSize());
+    //Resources released after this are gone with the context
+    GPUResourceRegistry::shutdown();
     glfwTerminate();
     LOG(INFO)<<"Graphics System destroyed!";
   }
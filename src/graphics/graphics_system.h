@@ -17,21 +17,23 @@
 #include "renderable.h"
 #include "window_exit_functor.h"
 #include "camera.h"
+#include "streaming_buffer.h"
+#include "geometry_arena.h"
+#include "gpu_resource.h"
+#include "light_grid.h"
+#include "light_accumulation_buffer.h"
 
 namespace Graphics {
   /**
    * @brief      Class for graphics system.
    */
   class [[scriptable]] GraphicsSystem {
+    public:
+      /**
+       * @brief      How lit renderables gather their lights
+       */
+      enum [[scriptable]] LightingMode : unsigned int { FORWARD, DEFERRED };
     private:
-      struct RankedLight {
-        std::shared_ptr<Light> light;
-        float influence;
-        friend bool operator<(const RankedLight& left, const RankedLight& right) {
-          return left.influence < right.influence;
-        }
-      };
-
       GLFWwindow* window;
       bool initialized;
       float delta;
@@ -43,10 +45,23 @@ namespace Graphics {
 
       std::list<std::shared_ptr<Light>> lights;
       unsigned int max_influence_lights;
+      std::shared_ptr<LightGrid> light_grid;
+      LightingMode lighting_mode;
+      std::shared_ptr<LightAccumulationBuffer> light_accumulation;
+      std::shared_ptr<Camera> camera;
+      //World units the light accumulation buffer reaches past the camera, so the camera moving after the pass stays lit
+      static constexpr float LIGHT_ACCUMULATION_MARGIN = 2.0f;
+
+      void accumulateLights();
 
       //The next id for renderables
       int next_id;
 
+      std::shared_ptr<StreamingBuffer> streaming_buffer;
+      static const unsigned int STREAMING_SEGMENT_SIZE = 4 * 1024 * 1024;
+
+      std::shared_ptr<GeometryArena> geometry_arena;
+
       static void errorCallback(int error, const char* description);
       static void windowSizeCallback(GLFWwindow* window, int width, int height);
 
@@ -161,17 +176,50 @@ namespace Graphics {
       [[scriptable]] int renderablesCount();
 
       /**
-       * @brief      Sets the maximum number influencing lights.
+       * @brief      Sets the maximum number of lights influencing a single light grid cell.
        *
        * @param[in]  number  The number
        */
       [[scriptable]] void setMaxInfluenceLights(const unsigned int number) noexcept;
       /**
-       * @brief      Gets the maximum number of influencing lights.
+       * @brief      Gets the maximum number of lights influencing a single light grid cell.
        *
        * @return     The maximum influence lights.
        */
       [[scriptable]] unsigned int getMaxInfluenceLights() const noexcept;
+      /**
+       * @brief      Sets the smallest light grid cell size.
+       *
+       * @param[in]  cell_size  The cell size in world units
+       */
+      [[scriptable]] void setLightCellSize(const float cell_size) noexcept;
+      /**
+       * @brief      Sets the lighting mode.
+       *
+       * @detail     Deferred lighting needs a camera and a light accumulation shader, forward lighting
+       * is used until both are set.
+       *
+       * @param[in]  mode  The mode
+       */
+      [[scriptable]] void setLightingMode(const LightingMode mode) noexcept;
+      /**
+       * @brief      Gets the lighting mode.
+       *
+       * @return     The lighting mode.
+       */
+      [[scriptable]] LightingMode getLightingMode() const noexcept;
+      /**
+       * @brief      Sets the shader the deferred lighting pass draws lights with.
+       *
+       * @param[in]  shader  The shader
+       */
+      [[scriptable]] void setLightAccumulationShader(std::shared_ptr<Shader> shader);
+      /**
+       * @brief      Sets the camera the deferred lighting pass covers.
+       *
+       * @param[in]  camera  The camera
+       */
+      [[scriptable]] void setCamera(std::shared_ptr<Camera> camera) noexcept;
       /**
        * @brief      Adds a light.
        *
@@ -187,6 +235,19 @@ namespace Graphics {
 
       GLFWwindow* getCurrentWindow() noexcept;
 
+      /**
+       * @brief      Gets the streaming buffer for geometry that is uploaded every frame.
+       *
+       * @return     The streaming buffer, nullptr before initialization.
+       */
+      [[scriptable]] std::shared_ptr<StreamingBuffer> getStreamingBuffer() const noexcept;
+      /**
+       * @brief      Gets the geometry arena for static geometry.
+       *
+       * @return     The geometry arena, nullptr before initialization.
+       */
+      [[scriptable]] std::shared_ptr<GeometryArena> getGeometryArena() const noexcept;
+
 
       /**
        * @brief Closes window, and destroys GLFW context.
@@ -195,6 +256,13 @@ namespace Graphics {
        */
       void destroy();
 
+      static inline const LightingMode stringToLightingMode(const std::string& str) {
+        if(str == "Deferred" || str == "deferred" || str == "DEFERRED")
+          return LightingMode::DEFERRED;
+        else
+          return LightingMode::FORWARD;
+      }
+
   };
 }
 
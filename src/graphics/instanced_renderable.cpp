@@ -0,0 +1,117 @@
+#ifdef __APPLE__
+#include <OpenGL/gl3.h>
+#else
+#include <glad/glad.h>
+#endif
+#include <algorithm>
+#include <cstddef>
+#include "instanced_renderable.h"
+
+namespace Graphics {
+  InstancedRenderable::InstancedRenderable(std::shared_ptr<GPUResource> vertex_array, const VertexData& vertex_data) :
+    Renderable(vertex_array, vertex_data), vertex_count(vertex_data.getVertexCount()), instance_buffer(GPUResourceRegistry::create(GPUResourceType::BUFFER)), instance_buffer_capacity(0), dirty_first(0), dirty_last(0), instances_changed(false), instances_streamed(false) {
+
+    glBindVertexArray(vertex_array->getObject());
+    pointInstanceAttributes(instance_buffer->getObject(), 0);
+    glVertexAttribDivisor(VertexData::DATA_TYPE::INSTANCE_OFFSET, 1);
+    glEnableVertexAttribArray(VertexData::DATA_TYPE::INSTANCE_OFFSET);
+    glVertexAttribDivisor(VertexData::DATA_TYPE::INSTANCE_TILE_COORD, 1);
+    glEnableVertexAttribArray(VertexData::DATA_TYPE::INSTANCE_TILE_COORD);
+    glBindVertexArray(0);
+  }
+
+  void InstancedRenderable::pointInstanceAttributes(const unsigned int buffer_object, const unsigned int offset) {
+    glBindBuffer(GL_ARRAY_BUFFER, buffer_object);
+    glVertexAttribPointer(VertexData::DATA_TYPE::INSTANCE_OFFSET, VertexData::DataWidth.at(VertexData::DATA_TYPE::INSTANCE_OFFSET), GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)(offset + offsetof(Instance, offset)));
+    //integers need glVertexAttribIPointer, same as in VertexData
+    glVertexAttribIPointer(VertexData::DATA_TYPE::INSTANCE_TILE_COORD, VertexData::DataWidth.at(VertexData::DATA_TYPE::INSTANCE_TILE_COORD), GL_INT, sizeof(Instance), (void*)(offset + offsetof(Instance, tile_coord)));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+  }
+
+  std::shared_ptr<InstancedRenderable> InstancedRenderable::create(const VertexData& vertex_data) {
+    return std::make_shared<InstancedRenderable>(vertex_data.generateVertexArrayObject(), vertex_data);
+  }
+
+  unsigned int InstancedRenderable::addInstance(const glm::vec3& offset, const glm::ivec2& tile_coord) {
+    Instance instance;
+    instance.offset = offset;
+    instance.tile_coord = tile_coord;
+    instances.push_back(instance);
+
+    unsigned int index = instances.size() - 1;
+    dirty_first = std::min(dirty_first, index);
+    dirty_last = instances.size();
+    instances_changed = true;
+    return index;
+  }
+
+  void InstancedRenderable::setInstanceTileCoord(const unsigned int index, const glm::ivec2& tile_coord) {
+    if(index >= instances.size() || instances[index].tile_coord == tile_coord)
+      return;
+
+    instances[index].tile_coord = tile_coord;
+    if(dirty_first >= dirty_last) {
+      dirty_first = index;
+      dirty_last = index + 1;
+    }
+    else {
+      dirty_first = std::min(dirty_first, index);
+      dirty_last = std::max(dirty_last, index + 1);
+    }
+    instances_changed = true;
+  }
+
+  unsigned int InstancedRenderable::getInstanceCount() const noexcept {
+    return instances.size();
+  }
+
+  void InstancedRenderable::setStreamingBuffer(std::shared_ptr<StreamingBuffer> streaming_buffer) {
+    this->streaming_buffer = streaming_buffer;
+  }
+
+  void InstancedRenderable::uploadInstances() {
+    if(dirty_first >= dirty_last)
+      return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, instance_buffer->getObject());
+    //Grow the buffer if instances were added since the last upload, otherwise only send the changed range
+    if(instance_buffer_capacity < instances.size()) {
+      instance_buffer_capacity = instances.size();
+      glBufferData(GL_ARRAY_BUFFER, instance_buffer_capacity * sizeof(Instance), &instances[0], GL_DYNAMIC_DRAW);
+      instance_buffer->setBytes(instance_buffer_capacity * sizeof(Instance));
+    }
+    else {
+      glBufferSubData(GL_ARRAY_BUFFER, dirty_first * sizeof(Instance), (dirty_last - dirty_first) * sizeof(Instance), &instances[dirty_first]);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    dirty_first = instances.size();
+    dirty_last = instances.size();
+  }
+
+  void InstancedRenderable::draw() {
+    if(instances.size() == 0)
+      return;
+
+    //The dirty range stays marked while streaming, the instance buffer gets it once the instances stop changing
+    if(streaming_buffer != nullptr && instances_changed) {
+      auto allocation = streaming_buffer->upload(instances);
+      pointInstanceAttributes(allocation.buffer_object, allocation.offset);
+      instances_streamed = true;
+    }
+    else {
+      uploadInstances();
+      if(instances_streamed) {
+        pointInstanceAttributes(instance_buffer->getObject(), 0);
+        instances_streamed = false;
+      }
+    }
+    instances_changed = false;
+
+    glDrawArraysInstanced(GL_TRIANGLES, 0, vertex_count, instances.size());
+  }
+
+  std::string InstancedRenderable::className() const noexcept {
+    return "Graphics::InstancedRenderable";
+  }
+}
@@ -0,0 +1,101 @@
+#ifndef INSTANCED_RENDERABLE_H
+#define INSTANCED_RENDERABLE_H
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+#include "renderable.h"
+#include "streaming_buffer.h"
+
+namespace Graphics {
+  /**
+   * @brief      Renderable that draws the same geometry many times with a single instanced draw call.
+   *
+   * @detail     Every instance has an offset that is added to the shared geometry and a tile coordinate,
+   * both of which are streamed to the shader through an instance buffer bound to
+   * VertexData::DATA_TYPE::INSTANCE_OFFSET and VertexData::DATA_TYPE::INSTANCE_TILE_COORD. With a
+   * StreamingBuffer, instances that changed since the last draw are written to it instead, so the upload
+   * never waits on a draw still reading the instance buffer. The instance buffer catches up on the next
+   * draw without changes, when only older frames could have read it.
+   */
+  class [[scriptable]] InstancedRenderable : public Renderable {
+    public:
+      /**
+       * @brief      Per instance data as laid out in the instance buffer
+       */
+      struct Instance {
+        glm::vec3 offset;
+        glm::ivec2 tile_coord;
+      };
+
+    private:
+      unsigned int vertex_count;
+      std::shared_ptr<GPUResource> instance_buffer;
+      unsigned int instance_buffer_capacity;
+      std::vector<Instance> instances;
+      std::shared_ptr<StreamingBuffer> streaming_buffer;
+
+      //Range of instances that have changed since the last upload, [first, last)
+      unsigned int dirty_first;
+      unsigned int dirty_last;
+      //Changed since the last draw
+      bool instances_changed;
+      //The instance attributes point into the streaming buffer
+      bool instances_streamed;
+
+      void uploadInstances();
+      void pointInstanceAttributes(const unsigned int buffer_object, const unsigned int offset);
+
+    protected:
+      virtual void draw() override;
+
+    public:
+      /**
+       * @brief      InstancedRenderable constructor
+       *
+       * @param[in]  vertex_array  The vertex array object
+       * @param[in]  vertex_data   The vertex data shared by all instances
+       */
+      InstancedRenderable(std::shared_ptr<GPUResource> vertex_array, const VertexData& vertex_data);
+      /**
+       * @brief      InstancedRenderable factory function
+       *
+       * @param[in]  vertex_data  The vertex data shared by all instances
+       *
+       * @return     newly created InstancedRenderable
+       */
+      static std::shared_ptr<InstancedRenderable> create(const VertexData& vertex_data);
+
+      /**
+       * @brief      Adds an instance.
+       *
+       * @param[in]  offset      The offset added to the shared geometry
+       * @param[in]  tile_coord  The tile coordinate of the instance
+       *
+       * @return     The index of the new instance
+       */
+      [[scriptable]] unsigned int addInstance(const glm::vec3& offset, const glm::ivec2& tile_coord);
+      /**
+       * @brief      Sets the tile coordinate of an instance.
+       *
+       * @param[in]  index       The instance index
+       * @param[in]  tile_coord  The tile coordinate
+       */
+      [[scriptable]] void setInstanceTileCoord(const unsigned int index, const glm::ivec2& tile_coord);
+      /**
+       * @brief      Gets the instance count.
+       *
+       * @return     The instance count.
+       */
+      [[scriptable]] unsigned int getInstanceCount() const noexcept;
+      /**
+       * @brief      Sets the buffer the instances are streamed through every frame.
+       *
+       * @param[in]  streaming_buffer  The streaming buffer, nullptr to keep them in the instance buffer
+       */
+      [[scriptable]] void setStreamingBuffer(std::shared_ptr<StreamingBuffer> streaming_buffer);
+
+      [[scriptable]] virtual std::string className() const noexcept override;
+  };
+}
+
+#endif
@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <cmath>
+#include "instanced_tile_animator.h"
+
+namespace Graphics {
+  InstancedTileAnimator::InstancedTileAnimator(std::shared_ptr<InstancedRenderable> renderable, const unsigned int tileset_width, const unsigned int tileset_height, const unsigned int tile_width_pixels, const unsigned int tile_height_pixels, const bool gpu_evaluated) :
+    renderable(renderable), multiplier(float(tile_width_pixels) / float(tileset_width), float(tile_height_pixels) / float(tileset_height)),
+    gpu_evaluated(gpu_evaluated), frame_table(nullptr), animation_time(0.0), animation_period(0.0), animation_time_slot(0) {
+  }
+
+  std::shared_ptr<InstancedTileAnimator> InstancedTileAnimator::create(std::shared_ptr<InstancedRenderable> renderable, const unsigned int tileset_width, const unsigned int tileset_height, const unsigned int tile_width, const unsigned int tile_height, const bool gpu_evaluated) {
+    return std::make_shared<InstancedTileAnimator>(renderable, tileset_width, tileset_height, tile_width, tile_height, gpu_evaluated);
+  }
+
+  unsigned int InstancedTileAnimator::addAnimation(const std::vector<std::pair<glm::ivec2, unsigned int>>& frames) {
+    Animation animation;
+    animation.frames = frames;
+    animation.current_frame = 0;
+    animation.frame_time_accumulator = 0.0;
+    animations.push_back(animation);
+    return animations.size() - 1;
+  }
+
+  void InstancedTileAnimator::addInstance(const unsigned int animation_index, const glm::vec3& offset) {
+    auto& animation = animations.at(animation_index);
+    glm::ivec2 tile_coord(0);
+    //The shader looks the frame up itself, it only needs to know which row of the frame table to read
+    if(gpu_evaluated)
+      tile_coord = glm::ivec2(animation_index, 0);
+    else if(animation.frames.size() > 0)
+      tile_coord = animation.frames[animation.current_frame].first;
+
+    animation.instances.push_back(renderable.lock()->addInstance(offset, tile_coord));
+  }
+
+  bool InstancedTileAnimator::isGPUEvaluated() const noexcept {
+    return gpu_evaluated;
+  }
+
+  std::string InstancedTileAnimator::className() const noexcept {
+    return "Graphics::InstancedTileAnimator";
+  }
+
+  void InstancedTileAnimator::generateFrameTable() {
+    //Row per animation, texel 0 holds (frame count, total duration), the rest hold (tile x, tile y, start time, duration)
+    unsigned int table_width = 1;
+    for(auto& animation : animations) {
+      table_width = std::max(table_width, (unsigned int)animation.frames.size() + 1);
+    }
+
+    std::vector<glm::ivec4> table(table_width * std::max((unsigned int)animations.size(), 1u), glm::ivec4(0));
+    unsigned long long period = 1;
+
+    for(unsigned int row = 0; row < animations.size(); row++) {
+      int start_time = 0;
+      for(unsigned int frame = 0; frame < animations[row].frames.size(); frame++) {
+        auto& tile_frame = animations[row].frames[frame];
+        table[row * table_width + frame + 1] = glm::ivec4(tile_frame.first, start_time, tile_frame.second);
+        start_time += tile_frame.second;
+      }
+      table[row * table_width] = glm::ivec4(animations[row].frames.size(), start_time, 0, 0);
+
+      //Wrap the clock on the least common multiple of all loops so it never loses float precision in the shader
+      if(start_time > 0 && period != 0) {
+        unsigned long long a = period;
+        unsigned long long b = start_time;
+        while(b != 0) {
+          auto t = a % b;
+          a = b;
+          b = t;
+        }
+        period = period / a * start_time;
+        if(period > (1 << 24))
+          period = 0;
+      }
+    }
+    animation_period = (double)period;
+
+    frame_table = std::make_shared<BaseTexture>(GL_TEXTURE_2D);
+    frame_table->setName("frame_table");
+    frame_table->loadFromData(table_width, std::max((unsigned int)animations.size(), 1u), GL_RGBA32I, GL_RGBA_INTEGER, GL_INT, &table[0]);
+  }
+
+  void InstancedTileAnimator::onStart() {
+    auto instanced_renderable = renderable.lock();
+    if(instanced_renderable == nullptr)
+      return;
+
+    instanced_renderable->setUniformSlot(instanced_renderable->getUniformSlot("tile_coord_multiplier", multiplier), multiplier);
+
+    if(gpu_evaluated) {
+      animation_time_slot = instanced_renderable->getUniformSlot("animation_time", (float)animation_time);
+      if(frame_table == nullptr) {
+        generateFrameTable();
+        instanced_renderable->addTexture(FRAME_TABLE_UNIT, "frame_table", frame_table);
+      }
+    }
+  }
+
+  bool InstancedTileAnimator::onUpdate(const double delta) {
+    if(!active)
+      return false;
+
+    if(gpu_evaluated)
+      updateGPUAnimations(delta);
+    else
+      updateCPUAnimations(delta);
+
+    return true;
+  }
+
+  void InstancedTileAnimator::updateCPUAnimations(const double delta) {
+    auto instanced_renderable = renderable.lock();
+    if(instanced_renderable == nullptr)
+      return;
+
+    for(auto& animation : animations) {
+      if(animation.frames.size() < 2)
+        continue;
+
+      animation.frame_time_accumulator += delta;
+      if(animation.frame_time_accumulator > animation.frames[animation.current_frame].second) {
+        animation.frame_time_accumulator = 0.0;
+        animation.current_frame = (animation.current_frame + 1) % animation.frames.size();
+
+        for(auto instance : animation.instances) {
+          instanced_renderable->setInstanceTileCoord(instance, animation.frames[animation.current_frame].first);
+        }
+      }
+    }
+  }
+
+  void InstancedTileAnimator::updateGPUAnimations(const double delta) {
+    animation_time += delta;
+    if(animation_period > 0.0)
+      animation_time = std::fmod(animation_time, animation_period);
+
+    auto instanced_renderable = renderable.lock();
+    if(instanced_renderable != nullptr)
+      instanced_renderable->setUniformSlot(animation_time_slot, (float)animation_time);
+  }
+
+  void InstancedTileAnimator::onDestroy() {
+    animations.clear();
+  }
+
+  void InstancedTileAnimator::onNotifyNow(std::shared_ptr<Events::Event> event) {
+    handleQueuedEvent(event);
+  }
+
+  unsigned long long InstancedTileAnimator::getValueForSorting() const noexcept {
+    return getId();
+  }
+}
@@ -0,0 +1,110 @@
+#ifndef INSTANCED_TILE_ANIMATOR_H
+#define INSTANCED_TILE_ANIMATOR_H
+#include <glm/glm.hpp>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "../component.h"
+#include "instanced_renderable.h"
+#include "base_texture.h"
+
+namespace Graphics {
+  /**
+   * @brief      Animates every instance of an InstancedRenderable from a shared set of tile animations.
+   *
+   * @detail     Instances that play the same animation share one frame clock, so each frame only the
+   * animations that actually changed frame touch the instance buffer.
+   *
+   * When GPU evaluated, the frames are instead uploaded once into a frame table texture and every
+   * instance carries its animation index. The shader picks the frame from the animation_time uniform,
+   * which is the only thing updated per frame.
+   */
+  class [[scriptable]] InstancedTileAnimator : public Component {
+    private:
+      struct Animation {
+        std::vector<std::pair<glm::ivec2, unsigned int>> frames;
+        std::vector<unsigned int> instances;
+        unsigned int current_frame;
+        //in ms
+        float frame_time_accumulator;
+      };
+
+      std::weak_ptr<InstancedRenderable> renderable;
+      std::vector<Animation> animations;
+      glm::vec2 multiplier;
+
+      bool gpu_evaluated;
+      std::shared_ptr<BaseTexture> frame_table;
+      //in ms
+      double animation_time;
+      double animation_period;
+      unsigned int animation_time_slot;
+
+      void generateFrameTable();
+      void updateCPUAnimations(const double delta);
+      void updateGPUAnimations(const double delta);
+
+      static const unsigned int FRAME_TABLE_UNIT = 1;
+
+    public:
+      InstancedTileAnimator() = delete;
+      /**
+       * @brief      InstancedTileAnimator constructor
+       *
+       * @param[in]  renderable          The instanced renderable to animate
+       * @param[in]  tileset_width       The tileset width
+       * @param[in]  tileset_height      The tileset height
+       * @param[in]  tile_width_pixels   The tile width pixels
+       * @param[in]  tile_height_pixels  The tile height pixels
+       * @param[in]  gpu_evaluated       True if frames should be picked by the shader
+       */
+      InstancedTileAnimator(std::shared_ptr<InstancedRenderable> renderable, const unsigned int tileset_width, const unsigned int tileset_height, const unsigned int tile_width_pixels, const unsigned int tile_height_pixels, const bool gpu_evaluated = false);
+      /**
+       * @brief      Factory function for InstancedTileAnimator
+       *
+       * @param[in]  renderable      The instanced renderable to animate
+       * @param[in]  tileset_width   The tileset width
+       * @param[in]  tileset_height  The tileset height
+       * @param[in]  tile_width      The tile width
+       * @param[in]  tile_height     The tile height
+       * @param[in]  gpu_evaluated   True if frames should be picked by the shader
+       *
+       * @return     Newly created InstancedTileAnimator
+       */
+      static std::shared_ptr<InstancedTileAnimator> create(std::shared_ptr<InstancedRenderable> renderable, const unsigned int tileset_width, const unsigned int tileset_height, const unsigned int tile_width, const unsigned int tile_height, const bool gpu_evaluated = false);
+
+      /**
+       * @brief      Adds an animation.
+       *
+       * @param[in]  frames  The frames as pairs of tile coordinates and frame times in ms
+       *
+       * @return     The index of the new animation
+       */
+      unsigned int addAnimation(const std::vector<std::pair<glm::ivec2, unsigned int>>& frames);
+      /**
+       * @brief      Adds an instance playing an animation to the renderable
+       *
+       * @param[in]  animation_index  The animation index
+       * @param[in]  offset           The offset of the instance
+       */
+      void addInstance(const unsigned int animation_index, const glm::vec3& offset);
+
+      /**
+       * @brief      Determines if the animation frames are picked by the shader.
+       *
+       * @return     True if gpu evaluated, False otherwise.
+       */
+      [[scriptable]] bool isGPUEvaluated() const noexcept;
+
+      [[scriptable]] virtual std::string className() const noexcept override;
+
+      virtual void onStart() override;
+      virtual bool onUpdate(const double delta) override;
+      virtual void onDestroy() override;
+
+      void onNotifyNow(std::shared_ptr<Events::Event> event) override;
+      virtual unsigned long long getValueForSorting() const noexcept override;
+  };
+}
+
+#endif
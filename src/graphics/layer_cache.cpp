@@ -0,0 +1,212 @@
+#include <easylogging++.h>
+#include <algorithm>
+#include <stdexcept>
+#include <glm/gtc/matrix_transform.hpp>
+#include "layer_cache.h"
+
+namespace Graphics {
+  LayerCache::LayerCache(std::shared_ptr<GPUResource> vertex_array, const VertexRecord& vertex_record, std::shared_ptr<Camera> camera, const unsigned int tile_width, const unsigned int tile_height) :
+    Renderable(vertex_array, vertex_record), camera(camera), frame_buffer(nullptr), tile_size(tile_width, tile_height), extent(0), origin(0), valid(false) {
+  }
+
+  std::shared_ptr<LayerCache> LayerCache::create(std::shared_ptr<Camera> camera, const unsigned int tile_width, const unsigned int tile_height) {
+    auto quad = generateUnitQuad();
+    return std::make_shared<LayerCache>(quad.generateVertexArrayObject(), quad.getRecord(), camera, tile_width, tile_height);
+  }
+
+  LayerCache::QuadLayout LayerCache::generateUnitQuad() {
+    std::vector<glm::vec3> verts {
+      glm::vec3(0.0, 0.0, 0.0),
+      glm::vec3(0.0, 1.0, 0.0),
+      glm::vec3(1.0, 1.0, 0.0),
+      glm::vec3(0.0, 0.0, 0.0),
+      glm::vec3(1.0, 1.0, 0.0),
+      glm::vec3(1.0, 0.0, 0.0)
+    };
+
+    std::vector<glm::vec2> texs {
+      glm::vec2(0.0, 0.0),
+      glm::vec2(0.0, 1.0),
+      glm::vec2(1.0, 1.0),
+      glm::vec2(0.0, 0.0),
+      glm::vec2(1.0, 1.0),
+      glm::vec2(1.0, 0.0)
+    };
+
+    return QuadLayout::fromVectors(GL_TRIANGLES, verts, texs);
+  }
+
+  int LayerCache::floorMod(const int value, const int divisor) noexcept {
+    auto mod = value % divisor;
+    return mod < 0 ? mod + divisor : mod;
+  }
+
+  void LayerCache::addSource(std::shared_ptr<Renderable> renderable, const glm::vec4& bounds) {
+    sources.push_back(Source{renderable, bounds});
+    valid = false;
+  }
+
+  unsigned int LayerCache::getSourceCount() const noexcept {
+    return sources.size();
+  }
+
+  void LayerCache::invalidate() noexcept {
+    valid = false;
+  }
+
+  void LayerCache::resize(const glm::ivec2& extent) {
+    if(frame_buffer == nullptr) {
+      frame_buffer = GPUResourceRegistry::create(GPUResourceType::FRAMEBUFFER);
+      texture = std::make_shared<BaseTexture>(GL_TEXTURE_2D);
+    }
+
+    auto size = extent * tile_size;
+    texture->loadFromData(size.x, size.y, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    //The cached area starts anywhere in the texture and wraps around its edges
+    glBindTexture(GL_TEXTURE_2D, texture->getTextureObject());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer->getObject());
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture->getTextureObject(), 0);
+    auto status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if(status != GL_FRAMEBUFFER_COMPLETE) {
+      LOG(ERROR)<<"Layer cache is incomplete: "<<status;
+      throw std::runtime_error("Layer cache is incomplete!");
+    }
+
+    addTexture(0, "layer_cache", texture);
+    this->extent = extent;
+    valid = false;
+  }
+
+  void LayerCache::refresh(const glm::ivec2& new_origin) {
+    if(valid && new_origin == origin)
+      return;
+
+    int viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer->getObject());
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_SCISSOR_TEST);
+    glClearColor(0.0, 0.0, 0.0, 0.0);
+    //Alpha adds up as coverage, which leaves the color premultiplied
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    auto scrolled = new_origin - origin;
+    if(!valid || std::abs(scrolled.x) >= extent.x || std::abs(scrolled.y) >= extent.y) {
+      renderRegion(new_origin, new_origin + extent);
+    }
+    else {
+      //Only the columns and rows that scrolled in
+      if(scrolled.x > 0)
+        renderRegion(glm::ivec2(origin.x + extent.x, new_origin.y), new_origin + extent);
+      else if(scrolled.x < 0)
+        renderRegion(new_origin, glm::ivec2(origin.x, new_origin.y + extent.y));
+      if(scrolled.y > 0)
+        renderRegion(glm::ivec2(new_origin.x, origin.y + extent.y), new_origin + extent);
+      else if(scrolled.y < 0)
+        renderRegion(new_origin, glm::ivec2(new_origin.x + extent.x, origin.y));
+    }
+
+    //Back to the state startRender sets up, with the camera's matrices
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDisable(GL_SCISSOR_TEST);
+    glEnable(GL_DEPTH_TEST);
+    glClearColor(0.0, 0.0, 0.0, 1.0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    for(auto& source : sources) {
+      auto shader = source.renderable->getShader();
+      if(shader != nullptr) {
+        shader->setUniform<glm::mat4>("projection", camera->getProjectionMatrix());
+        shader->setUniform<glm::mat4>("view", camera->getViewMatrix());
+      }
+    }
+
+    getTransform()->translate(glm::vec2(new_origin - origin));
+    origin = new_origin;
+    valid = true;
+
+    Uniform texture_offset_uniform;
+    texture_offset_uniform.setData<glm::vec2>("texture_offset", glm::vec2(floorMod(origin.x, extent.x), floorMod(origin.y, extent.y)) / glm::vec2(extent));
+    setUniform(texture_offset_uniform);
+  }
+
+  void LayerCache::renderRegion(const glm::ivec2& first, const glm::ivec2& end) {
+    //Split where the region wraps around the texture's edges
+    for(int y = first.y; y < end.y;) {
+      auto y_end = std::min(end.y, y - floorMod(y, extent.y) + extent.y);
+      for(int x = first.x; x < end.x;) {
+        auto x_end = std::min(end.x, x - floorMod(x, extent.x) + extent.x);
+        renderPiece(glm::ivec2(x, y), glm::ivec2(x_end, y_end));
+        x = x_end;
+      }
+      y = y_end;
+    }
+  }
+
+  void LayerCache::renderPiece(const glm::ivec2& first, const glm::ivec2& end) {
+    auto texel = glm::ivec2(floorMod(first.x, extent.x), floorMod(first.y, extent.y)) * tile_size;
+    auto size = (end - first) * tile_size;
+    glViewport(texel.x, texel.y, size.x, size.y);
+    glScissor(texel.x, texel.y, size.x, size.y);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    auto projection = glm::ortho((float)first.x, (float)end.x, (float)first.y, (float)end.y, -1.0f, 1.0f);
+    for(auto& source : sources) {
+      auto& bounds = source.bounds;
+      if(bounds.x >= end.x || bounds.x + bounds.z <= first.x || bounds.y >= end.y || bounds.y + bounds.w <= first.y)
+        continue;
+
+      auto shader = source.renderable->getShader();
+      if(shader == nullptr)
+        continue;
+      shader->setUniform<glm::mat4>("projection", projection);
+      shader->setUniform<glm::mat4>("view", glm::mat4(1.0));
+      source.renderable->onUpdate(0.0);
+    }
+  }
+
+  void LayerCache::draw() {
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    Renderable::draw();
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  }
+
+  std::string LayerCache::className() const noexcept {
+    return "Graphics::LayerCache";
+  }
+
+  void LayerCache::onStart() {
+    Renderable::onStart();
+    for(auto& source : sources) {
+      source.renderable->onStart();
+    }
+  }
+
+  bool LayerCache::onUpdate(const double delta) {
+    if(isActive() && camera != nullptr && !sources.empty()) {
+      //The camera in the coordinates the sources are in
+      auto parent_translation = glm::vec2(getTransform()->getAbsoluteTranslation() - getTransform()->getLocalTranslation());
+      auto center = glm::vec2(camera->getTransform()->getAbsoluteTranslation()) - parent_translation;
+
+      auto wanted_extent = glm::ivec2(glm::ceil(glm::vec2(camera->getWidth(), camera->getHeight()))) + 2 * MARGIN_TILES;
+      if(wanted_extent != extent) {
+        resize(wanted_extent);
+
+        Uniform extent_uniform;
+        extent_uniform.setData<glm::vec2>("extent", glm::vec2(extent));
+        setUniform(extent_uniform);
+      }
+
+      refresh(glm::ivec2(glm::floor(center)) - extent / 2);
+    }
+
+    if(texture == nullptr)
+      return true;
+    return Renderable::onUpdate(delta);
+  }
+}
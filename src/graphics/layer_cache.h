@@ -0,0 +1,108 @@
+#ifndef LAYER_CACHE_H
+#define LAYER_CACHE_H
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+#include "renderable.h"
+#include "base_texture.h"
+#include "camera.h"
+
+namespace Graphics {
+  /**
+   * @brief      Renderable that draws a static layer from a texture that follows the camera.
+   *
+   * @detail     The layer's patches are drawn once into a texture covering the camera's view plus a
+   * margin, at the tiles' own pixel density. The texture wraps around: when the camera moves on to
+   * new tiles only the rows and columns that scrolled into view are drawn, over the ones that
+   * scrolled out. Every frame the layer is a single quad sampling the texture, however many patches
+   * it has. The texture holds premultiplied alpha so translucent tiles blend the same as drawn
+   * directly.
+   */
+  class [[scriptable]] LayerCache : public Renderable {
+    public:
+      /**
+       * Tiles the cache reaches past the camera on every side
+       */
+      static const int MARGIN_TILES = 2;
+
+    private:
+      struct Source {
+        std::shared_ptr<Renderable> renderable;
+        glm::vec4 bounds;
+      };
+
+      std::shared_ptr<Camera> camera;
+      std::vector<Source> sources;
+      std::shared_ptr<BaseTexture> texture;
+      std::shared_ptr<GPUResource> frame_buffer;
+      glm::ivec2 tile_size;
+      //The cached area in tiles, and its lower left tile
+      glm::ivec2 extent;
+      glm::ivec2 origin;
+      bool valid;
+
+      typedef VertexLayout<Position3f, UV2f> QuadLayout;
+
+      static QuadLayout generateUnitQuad();
+      static int floorMod(const int value, const int divisor) noexcept;
+
+      void resize(const glm::ivec2& extent);
+      void refresh(const glm::ivec2& new_origin);
+      void renderRegion(const glm::ivec2& first, const glm::ivec2& end);
+      void renderPiece(const glm::ivec2& first, const glm::ivec2& end);
+
+    protected:
+      virtual void draw() override;
+
+    public:
+      /**
+       * @brief      LayerCache constructor
+       *
+       * @param[in]  vertex_array   The vertex array object
+       * @param[in]  vertex_record  The record of the unit quad
+       * @param[in]  camera         The camera the cache follows
+       * @param[in]  tile_width     The tile width in pixels
+       * @param[in]  tile_height    The tile height in pixels
+       */
+      LayerCache(std::shared_ptr<GPUResource> vertex_array, const VertexRecord& vertex_record, std::shared_ptr<Camera> camera, const unsigned int tile_width, const unsigned int tile_height);
+      /**
+       * @brief      LayerCache factory function
+       *
+       * @param[in]  camera       The camera the cache follows
+       * @param[in]  tile_width   The tile width in pixels
+       * @param[in]  tile_height  The tile height in pixels
+       *
+       * @return     newly created LayerCache
+       */
+      static std::shared_ptr<LayerCache> create(std::shared_ptr<Camera> camera, const unsigned int tile_width, const unsigned int tile_height);
+
+      //Remove copy constructor and assignment
+      LayerCache(const LayerCache&) = delete;
+      LayerCache operator=(LayerCache&) = delete;
+
+      /**
+       * @brief      Adds a renderable drawn into the cache instead of to the screen.
+       *
+       * @param[in]  renderable  The renderable, in the same coordinates as the cache's parent
+       * @param[in]  bounds      The rectangle the renderable covers as (x, y, width, height)
+       */
+      void addSource(std::shared_ptr<Renderable> renderable, const glm::vec4& bounds);
+      /**
+       * @brief      Gets the number of renderables drawn into the cache.
+       *
+       * @return     The number of sources.
+       */
+      [[scriptable]] unsigned int getSourceCount() const noexcept;
+      /**
+       * @brief      Redraws the whole cache next frame.
+       */
+      [[scriptable]] void invalidate() noexcept;
+
+      [[scriptable]] virtual std::string className() const noexcept override;
+
+      virtual void onStart() override;
+      virtual bool onUpdate(const double delta) override;
+  };
+}
+
+#endif
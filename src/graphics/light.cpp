@@ -1,4 +1,6 @@
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include "light.h"
 #include "transform.h"
 
@@ -97,6 +99,42 @@ namespace Graphics {
     return diffuse_coefficient;
   }
 
+  float Light::getRadius() const noexcept {
+    //Solve intensity / (1 + linear * d + quadratic * d^2) = 1 / 256 for d
+    float brightest = intensity * std::max(color.r, std::max(color.g, color.b));
+    float constant = 1.0f - 256.0f * brightest;
+    if(constant >= 0.0f)
+      return 0.0f;
+
+    if(quadratic_attenuation > 0.0f)
+      return (-linear_attenuation + std::sqrt(linear_attenuation * linear_attenuation - 4.0f * quadratic_attenuation * constant)) / (2.0f * quadratic_attenuation);
+    else if(linear_attenuation > 0.0f)
+      return -constant / linear_attenuation;
+    else
+      return std::numeric_limits<float>::infinity();
+  }
+
+  glm::vec3 Light::illuminationAt(const glm::vec3& point) const noexcept {
+    auto position = getTransform()->getAbsoluteTranslation();
+    auto offset = glm::vec3(glm::vec2(position) - glm::vec2(point), position.z);
+    float distance = glm::length(offset);
+    auto surface_to_light = distance > 0.0f ? offset / distance : glm::vec3(0.0, 0.0, 1.0);
+
+    float attenuation = 1.0f / (1.0f + linear_attenuation * distance + quadratic_attenuation * distance * distance);
+
+    if(type == Type::SPOT) {
+      float light_to_surface_angle = glm::degrees(std::acos(glm::clamp(glm::dot(-surface_to_light, glm::normalize(cone_direction)), -1.0f, 1.0f)));
+      if(light_to_surface_angle > cone_angle)
+        attenuation = 0.0f;
+    }
+
+    float diffuse_coefficient = std::max(0.0f, surface_to_light.z);
+    if(quantized_bands > 0 && diffuse_coefficient > 0.0f)
+      diffuse_coefficient = std::floor(diffuse_coefficient * (quantized_bands + 1.0f)) / (quantized_bands + 1.0f);
+
+    return glm::clamp(attenuation * diffuse_coefficient * color * intensity, glm::vec3(0.0), glm::vec3(1.0));
+  }
+
   unsigned long long Light::getValueForSorting() const noexcept {
     return getId();
   }
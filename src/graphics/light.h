@@ -148,6 +148,20 @@ namespace Graphics {
        * @return     Influence amount clamped 0.0, 1.0, on the given component
        */
       [[scriptable]] float influenceOnComponent(const Component& component) const;
+      /**
+       * @brief      Calculates how far the light reaches
+       *
+       * @return     Distance past which the light adds less than one 8 bit step, infinity if it never falls off
+       */
+      [[scriptable]] float getRadius() const noexcept;
+      /**
+       * @brief      Calculates the light a flat surface facing the camera receives, the same way the lit shaders do
+       *
+       * @param[in]  point  The world position of the surface
+       *
+       * @return     The light color clamped 0.0, 1.0, to be multiplied with the surface color
+       */
+      [[scriptable]] glm::vec3 illuminationAt(const glm::vec3& point) const noexcept;
       [[scriptable]] virtual std::string className() const noexcept override;
 
       virtual unsigned long long getValueForSorting() const noexcept override;
@@ -0,0 +1,90 @@
+#include <easylogging++.h>
+#include <stdexcept>
+#include "light_accumulation_buffer.h"
+#include "light_grid.h"
+
+namespace Graphics {
+  LightAccumulationBuffer::LightAccumulationBuffer() : frame_buffer(nullptr), texture(nullptr), width(0), height(0), shader(nullptr) {
+    //The quad corners come from gl_VertexID, the vertex array only has to exist
+    vertex_array = GPUResourceRegistry::create(GPUResourceType::VERTEX_ARRAY);
+  }
+
+  void LightAccumulationBuffer::resize(const int width, const int height) {
+    if(frame_buffer == nullptr) {
+      frame_buffer = GPUResourceRegistry::create(GPUResourceType::FRAMEBUFFER);
+      texture = GPUResourceRegistry::create(GPUResourceType::TEXTURE);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, texture->getObject());
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+    //Four half floats a texel
+    texture->setBytes((size_t)width * height * 8);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer->getObject());
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture->getObject(), 0);
+    auto status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if(status != GL_FRAMEBUFFER_COMPLETE) {
+      LOG(ERROR)<<"Light accumulation buffer is incomplete: "<<status;
+      throw std::runtime_error("Light accumulation buffer is incomplete!");
+    }
+
+    this->width = width;
+    this->height = height;
+  }
+
+  void LightAccumulationBuffer::setShader(std::shared_ptr<Shader> shader) noexcept {
+    this->shader = shader;
+  }
+
+  std::shared_ptr<Shader> LightAccumulationBuffer::getShader() const noexcept {
+    return shader;
+  }
+
+  void LightAccumulationBuffer::render(const glm::vec4& bounds, const int width, const int height, const unsigned int light_count) {
+    if(width <= 0 || height <= 0 || shader == nullptr)
+      return;
+    if(width != this->width || height != this->height)
+      resize(width, height);
+
+    int viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer->getObject());
+    glViewport(0, 0, width, height);
+    glClearColor(0.0, 0.0, 0.0, 0.0);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    if(light_count > 0) {
+      shader->setUniform<glm::vec4>("bounds", bounds);
+      shader->setUniform<int>("light_data", LightGrid::LIGHT_DATA_UNIT);
+      shader->useProgram();
+
+      glDisable(GL_DEPTH_TEST);
+      glBlendFunc(GL_ONE, GL_ONE);
+      glBindVertexArray(vertex_array->getObject());
+      glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, light_count);
+      glBindVertexArray(0);
+
+      //Back to the state startRender sets up
+      glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+      glEnable(GL_DEPTH_TEST);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    glClearColor(0.0, 0.0, 0.0, 1.0);
+
+    glActiveTexture(GL_TEXTURE0 + LIGHT_ACCUMULATION_UNIT);
+    glBindTexture(GL_TEXTURE_2D, texture->getObject());
+    glActiveTexture(GL_TEXTURE0);
+  }
+
+  unsigned int LightAccumulationBuffer::getTextureHandle() const noexcept {
+    return texture != nullptr ? texture->getObject() : 0;
+  }
+}
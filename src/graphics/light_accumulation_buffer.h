@@ -0,0 +1,85 @@
+#ifndef LIGHT_ACCUMULATION_BUFFER_H
+#define LIGHT_ACCUMULATION_BUFFER_H
+#ifdef __APPLE__
+#include <OpenGL/gl3.h>
+#else
+#include <glad/glad.h>
+#endif
+#include <glm/glm.hpp>
+#include <memory>
+#include "shader.h"
+#include "gpu_resource.h"
+
+namespace Graphics {
+  /**
+   * @brief      Offscreen buffer the lights are added into for deferred lighting.
+   *
+   * @detail     Every light is drawn as one instanced quad covering its radius, reading its data from
+   * the light grid's texture buffer, and blended additively into a half float color buffer. Lit
+   * shaders then multiply their unlit color with the buffer instead of looping over lights, so the
+   * cost scales with the pixels the lights touch. The buffer covers a world rectangle rather than
+   * the screen, lit shaders map their world position into it.
+   */
+  class LightAccumulationBuffer {
+    public:
+      /**
+       * The texture unit the accumulated light is bound to, after the light grid units
+       */
+      static const unsigned int LIGHT_ACCUMULATION_UNIT = 16;
+
+    private:
+      std::shared_ptr<GPUResource> frame_buffer;
+      std::shared_ptr<GPUResource> texture;
+      std::shared_ptr<GPUResource> vertex_array;
+      int width;
+      int height;
+      std::shared_ptr<Shader> shader;
+
+      void resize(const int width, const int height);
+
+    public:
+      /**
+       * @brief      LightAccumulationBuffer constructor, needs a current context
+       */
+      LightAccumulationBuffer();
+
+      //Remove copy constructor and assignment
+      LightAccumulationBuffer(const LightAccumulationBuffer&) = delete;
+      LightAccumulationBuffer& operator=(const LightAccumulationBuffer&) = delete;
+
+      /**
+       * @brief      Sets the shader the lights are drawn with.
+       *
+       * @param[in]  shader  The shader
+       */
+      void setShader(std::shared_ptr<Shader> shader) noexcept;
+      /**
+       * @brief      Gets the shader the lights are drawn with.
+       *
+       * @return     The shader, nullptr if none was set.
+       */
+      std::shared_ptr<Shader> getShader() const noexcept;
+
+      /**
+       * @brief      Clears the buffer, adds the lights into it and binds it to its texture unit.
+       *
+       * @detail     Expects the light grid to be uploaded already. The frame buffer and viewport are
+       * restored afterwards.
+       *
+       * @param[in]  bounds       The world rectangle covered as (x, y, width, height)
+       * @param[in]  width        The buffer width in pixels
+       * @param[in]  height       The buffer height in pixels
+       * @param[in]  light_count  The number of lights in the light grid
+       */
+      void render(const glm::vec4& bounds, const int width, const int height, const unsigned int light_count);
+
+      /**
+       * @brief      Gets the texture handle.
+       *
+       * @return     The handle.
+       */
+      unsigned int getTextureHandle() const noexcept;
+  };
+}
+
+#endif
@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include "light_grid.h"
+#include "transform.h"
+
+namespace Graphics {
+  LightGrid::LightGrid(const float cell_size) : cell_size(cell_size), grid_cell_size(cell_size), origin(0.0), size(0), accumulation_bounds(0.0) {
+    for(unsigned int i = 0; i < 3; i++) {
+      buffer_objects[i] = 0;
+      textures[i] = 0;
+    }
+  }
+
+  LightGrid::~LightGrid() {
+    if(buffer_objects[0] != 0) {
+      glDeleteTextures(3, textures);
+      glDeleteBuffers(3, buffer_objects);
+    }
+  }
+
+  void LightGrid::packLight(const Light& light, const float radius) {
+    auto position = light.getTransform()->getAbsoluteTranslation();
+    //Point lights aren't restricted to a cone
+    float cone_angle = light.getType() == Light::Type::SPOT ? light.getConeAngle() : 360.0f;
+
+    light_data.push_back(glm::vec4(position, light.getIntensity()));
+    light_data.push_back(glm::vec4(light.getColor(), light.getLinearAttenuation()));
+    light_data.push_back(glm::vec4(light.getQuadraticAttenuation(), cone_angle, (float)light.getNumberOfQuantizedBands(), 0.0));
+    //Negative radius for lights that never fall off
+    light_data.push_back(glm::vec4(light.getConeDirection(), std::isfinite(radius) ? radius : -1.0f));
+  }
+
+  int LightGrid::cellIndex(const glm::ivec2& cell) const noexcept {
+    if(cell.x < 0 || cell.y < 0 || cell.x >= size.x || cell.y >= size.y)
+      return size.x * size.y;
+    return cell.y * size.x + cell.x;
+  }
+
+  void LightGrid::build(const std::list<std::shared_ptr<Light>>& lights, const unsigned int max_lights_per_cell) {
+    light_data.assign(GRID_HEADER_TEXELS, glm::vec4(0.0));
+    cells.clear();
+    indices.clear();
+
+    std::vector<float> radii;
+    bool has_bounds = false;
+    glm::vec2 minimum(0.0);
+    glm::vec2 maximum(0.0);
+
+    for(auto& light : lights) {
+      auto radius = light->getRadius();
+      packLight(*light, radius);
+      radii.push_back(radius);
+      if(radius > 0.0f && std::isfinite(radius)) {
+        auto position = glm::vec2(light->getTransform()->getAbsoluteTranslation());
+        minimum = has_bounds ? glm::min(minimum, position - radius) : position - radius;
+        maximum = has_bounds ? glm::max(maximum, position + radius) : position + radius;
+        has_bounds = true;
+      }
+    }
+
+    //Cells grow past the configured size rather than the grid growing past its cap
+    origin = minimum;
+    size = glm::ivec2(0);
+    grid_cell_size = cell_size;
+    if(has_bounds) {
+      auto extent = maximum - minimum;
+      grid_cell_size = std::max(cell_size, std::max(extent.x, extent.y) / (float)MAX_CELLS_PER_SIDE);
+      size = glm::max(glm::ivec2(glm::ceil(extent / grid_cell_size)), glm::ivec2(1));
+    }
+
+    //Candidate lights per cell as (strength at the cell's center, light index)
+    std::vector<std::vector<std::pair<float, unsigned int>>> cell_lights(size.x * size.y + 1);
+    auto strength = [&](const Light& light, const glm::vec2& point) {
+      auto distance = glm::length(glm::vec2(light.getTransform()->getAbsoluteTranslation()) - point);
+      return light.getIntensity() / (1.0f + light.getLinearAttenuation() * distance + light.getQuadraticAttenuation() * distance * distance);
+    };
+
+    unsigned int light_index = 0;
+    for(auto& light : lights) {
+      auto radius = radii[light_index];
+      if(radius > 0.0f) {
+        glm::ivec2 first(0);
+        glm::ivec2 last(size - 1);
+        if(std::isfinite(radius)) {
+          auto position = glm::vec2(light->getTransform()->getAbsoluteTranslation());
+          first = glm::max(glm::ivec2(glm::floor((position - radius - origin) / grid_cell_size)), glm::ivec2(0));
+          last = glm::min(glm::ivec2(glm::floor((position + radius - origin) / grid_cell_size)), size - 1);
+        }
+        else {
+          cell_lights.back().push_back(std::make_pair(light->getIntensity(), light_index));
+        }
+
+        for(int y = first.y; y <= last.y; y++) {
+          for(int x = first.x; x <= last.x; x++) {
+            auto center = origin + (glm::vec2(x, y) + 0.5f) * grid_cell_size;
+            cell_lights[y * size.x + x].push_back(std::make_pair(strength(*light, center), light_index));
+          }
+        }
+      }
+      light_index++;
+    }
+
+    for(auto& cell : cell_lights) {
+      if(cell.size() > max_lights_per_cell) {
+        std::partial_sort(cell.begin(), cell.begin() + max_lights_per_cell, cell.end(), [](const std::pair<float, unsigned int>& left, const std::pair<float, unsigned int>& right) {
+          return left.first > right.first;
+        });
+        cell.resize(max_lights_per_cell);
+      }
+
+      cells.push_back(glm::uvec2(indices.size(), cell.size()));
+      for(auto& cell_light : cell) {
+        indices.push_back(cell_light.second);
+      }
+    }
+
+    light_data[0] = glm::vec4(origin, grid_cell_size, (float)lights.size());
+    light_data[1] = glm::vec4((float)size.x, (float)size.y, 0.0, 0.0);
+    light_data[2] = accumulation_bounds;
+  }
+
+  void LightGrid::upload() {
+    if(buffer_objects[0] == 0) {
+      glGenBuffers(3, buffer_objects);
+      glGenTextures(3, textures);
+    }
+
+    //Texture buffers can't be empty
+    if(indices.empty())
+      indices.push_back(0);
+
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer_objects[0]);
+    glBufferData(GL_TEXTURE_BUFFER, light_data.size() * sizeof(glm::vec4), &light_data[0], GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer_objects[1]);
+    glBufferData(GL_TEXTURE_BUFFER, cells.size() * sizeof(glm::uvec2), &cells[0], GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer_objects[2]);
+    glBufferData(GL_TEXTURE_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    GLenum formats[3] = {GL_RGBA32F, GL_RG32UI, GL_R32UI};
+    unsigned int units[3] = {LIGHT_DATA_UNIT, LIGHT_CELLS_UNIT, LIGHT_INDICES_UNIT};
+    for(unsigned int i = 0; i < 3; i++) {
+      glActiveTexture(GL_TEXTURE0 + units[i]);
+      glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+      glTexBuffer(GL_TEXTURE_BUFFER, formats[i], buffer_objects[i]);
+    }
+    glActiveTexture(GL_TEXTURE0);
+  }
+
+  void LightGrid::setCellSize(const float cell_size) noexcept {
+    this->cell_size = cell_size;
+  }
+
+  void LightGrid::setAccumulationBounds(const glm::vec4& bounds) noexcept {
+    accumulation_bounds = bounds;
+  }
+
+  float LightGrid::getCellSize() const noexcept {
+    return cell_size;
+  }
+
+  glm::ivec2 LightGrid::getSize() const noexcept {
+    return size;
+  }
+
+  std::vector<unsigned int> LightGrid::getLightsAt(const glm::vec2& position) const {
+    if(cells.empty())
+      return std::vector<unsigned int>();
+
+    auto cell = cells[cellIndex(glm::ivec2(glm::floor((position - origin) / grid_cell_size)))];
+    return std::vector<unsigned int>(indices.begin() + cell.x, indices.begin() + cell.x + cell.y);
+  }
+}
@@ -0,0 +1,121 @@
+#ifndef LIGHT_GRID_H
+#define LIGHT_GRID_H
+#ifdef __APPLE__
+#include <OpenGL/gl3.h>
+#else
+#include <glad/glad.h>
+#endif
+#include <glm/glm.hpp>
+#include <list>
+#include <memory>
+#include <vector>
+#include "light.h"
+
+namespace Graphics {
+  /**
+   * @brief      Bins lights into a world space grid for the lit shaders.
+   *
+   * @detail     Every frame the lights are assigned to the grid cells their radius overlaps, keeping
+   * the strongest ones when a cell has more than the cap. The light data, each cell's (offset, count)
+   * into the index list and the index list are uploaded as texture buffers, so a fragment only loops
+   * over the lights of the cell it is in. Lights that never fall off go into every cell and into one
+   * extra cell used outside the grid.
+   *
+   * The first three texels of the light data hold the grid: (origin x, origin y, cell size, light count),
+   * (width in cells, height in cells, 0, 0) and the world rectangle of the light accumulation buffer,
+   * zero sized when lighting is forward. Each light then takes four texels, the radius is stored in
+   * the last one.
+   */
+  class LightGrid {
+    public:
+      /**
+       * The texture units the buffers are bound to, after the tile map unit
+       */
+      static const unsigned int LIGHT_DATA_UNIT = 13;
+      static const unsigned int LIGHT_CELLS_UNIT = 14;
+      static const unsigned int LIGHT_INDICES_UNIT = 15;
+
+    private:
+      float cell_size;
+      float grid_cell_size;
+      glm::vec2 origin;
+      glm::ivec2 size;
+      glm::vec4 accumulation_bounds;
+
+      std::vector<glm::vec4> light_data;
+      std::vector<glm::uvec2> cells;
+      std::vector<unsigned int> indices;
+
+      unsigned int buffer_objects[3];
+      unsigned int textures[3];
+
+      static const int MAX_CELLS_PER_SIDE = 64;
+      static const unsigned int GRID_HEADER_TEXELS = 3;
+
+      void packLight(const Light& light, const float radius);
+      int cellIndex(const glm::ivec2& cell) const noexcept;
+
+    public:
+      /**
+       * @brief      LightGrid constructor
+       *
+       * @param[in]  cell_size  The smallest cell size in world units
+       */
+      LightGrid(const float cell_size = 4.0);
+      /**
+       * @brief      Destroys the buffers and textures.
+       */
+      ~LightGrid();
+
+      //Remove copy constructor and assignment
+      LightGrid(const LightGrid&) = delete;
+      LightGrid& operator=(const LightGrid&) = delete;
+
+      /**
+       * @brief      Bins the lights into cells.
+       *
+       * @param[in]  lights              The lights
+       * @param[in]  max_lights_per_cell The most lights a single cell keeps
+       */
+      void build(const std::list<std::shared_ptr<Light>>& lights, const unsigned int max_lights_per_cell);
+      /**
+       * @brief      Uploads the last build and binds the buffers to their texture units.
+       */
+      void upload();
+
+      /**
+       * @brief      Sets the smallest cell size.
+       *
+       * @param[in]  cell_size  The cell size in world units
+       */
+      void setCellSize(const float cell_size) noexcept;
+      /**
+       * @brief      Sets the world rectangle the light accumulation buffer covers, written on the next build.
+       *
+       * @param[in]  bounds  The rectangle as (x, y, width, height), zero sized for forward lighting
+       */
+      void setAccumulationBounds(const glm::vec4& bounds) noexcept;
+      /**
+       * @brief      Gets the smallest cell size.
+       *
+       * @return     The cell size in world units.
+       */
+      float getCellSize() const noexcept;
+      /**
+       * @brief      Gets the grid size of the last build.
+       *
+       * @return     The width and height in cells.
+       */
+      glm::ivec2 getSize() const noexcept;
+      /**
+       * @brief      Gets the indices of the lights in a cell of the last build.
+       *
+       * @param[in]  position  The world position
+       *
+       * @return     Indices into the lights passed to build.
+       */
+      std::vector<unsigned int> getLightsAt(const glm::vec2& position) const;
+  };
+}
+
+#endif
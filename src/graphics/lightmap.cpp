@@ -0,0 +1,80 @@
+#ifdef __APPLE__
+#include <OpenGL/gl3.h>
+#else
+#include <glad/glad.h>
+#endif
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "lightmap.h"
+#include "transform.h"
+
+namespace Graphics {
+  Lightmap::Lightmap(const unsigned int width, const unsigned int height, const glm::vec4& bounds) : width(width), height(height), bounds(bounds), texels(width * height, glm::vec3(0.0)) {
+  }
+
+  void Lightmap::bake(const std::vector<std::shared_ptr<Light>>& lights) {
+    auto texel_size = glm::vec2(bounds.z / (float)width, bounds.w / (float)height);
+
+    for(auto& light : lights) {
+      auto radius = light->getRadius();
+      if(radius <= 0.0f)
+        continue;
+
+      //Only the texels the light reaches
+      glm::ivec2 first(0);
+      glm::ivec2 last(width - 1, height - 1);
+      if(std::isfinite(radius)) {
+        auto position = glm::vec2(light->getTransform()->getAbsoluteTranslation());
+        first = glm::max(glm::ivec2(glm::floor((position - radius - glm::vec2(bounds)) / texel_size)), first);
+        last = glm::min(glm::ivec2(glm::floor((position + radius - glm::vec2(bounds)) / texel_size)), last);
+      }
+
+      for(int y = first.y; y <= last.y; y++) {
+        for(int x = first.x; x <= last.x; x++) {
+          auto center = glm::vec2(bounds) + (glm::vec2(x, y) + 0.5f) * texel_size;
+          texels[y * width + x] += light->illuminationAt(glm::vec3(center, 0.0));
+        }
+      }
+    }
+  }
+
+  std::shared_ptr<BaseTexture> Lightmap::createTexture() const {
+    std::vector<unsigned char> pixels;
+    pixels.reserve(texels.size() * 3);
+    for(auto& texel : texels) {
+      auto clamped = glm::clamp(texel, glm::vec3(0.0), glm::vec3(1.0));
+      pixels.push_back((unsigned char)std::round(clamped.r * 255.0f));
+      pixels.push_back((unsigned char)std::round(clamped.g * 255.0f));
+      pixels.push_back((unsigned char)std::round(clamped.b * 255.0f));
+    }
+
+    auto texture = std::make_shared<BaseTexture>(GL_TEXTURE_2D);
+    texture->loadFromData(width, height, GL_RGB8, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+    //Light is smooth between texels
+    glBindTexture(GL_TEXTURE_2D, texture->getTextureObject());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+  }
+
+  glm::vec3 Lightmap::getTexel(const unsigned int x, const unsigned int y) const {
+    if(x >= width || y >= height)
+      throw std::out_of_range("Lightmap texel out of range");
+    return glm::clamp(texels[y * width + x], glm::vec3(0.0), glm::vec3(1.0));
+  }
+
+  glm::vec4 Lightmap::getBounds() const noexcept {
+    return bounds;
+  }
+
+  unsigned int Lightmap::getWidth() const noexcept {
+    return width;
+  }
+
+  unsigned int Lightmap::getHeight() const noexcept {
+    return height;
+  }
+}
@@ -0,0 +1,83 @@
+#ifndef LIGHTMAP_H
+#define LIGHTMAP_H
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+#include "base_texture.h"
+#include "light.h"
+
+namespace Graphics {
+  /**
+   * @brief      Light from static lights, evaluated once into a texture.
+   *
+   * @detail     The lightmap covers a world rectangle. Baking adds up Light::illuminationAt at every
+   * texel center, the same model the lit shaders use, so baked and live lights look the same. Baking
+   * only needs the lights, the texture is created separately.
+   */
+  class [[scriptable]] Lightmap {
+    public:
+      /**
+       * The texture unit lightmaps are bound to, after the light accumulation unit
+       */
+      static const unsigned int LIGHTMAP_UNIT = 17;
+
+    private:
+      unsigned int width;
+      unsigned int height;
+      glm::vec4 bounds;
+      std::vector<glm::vec3> texels;
+
+    public:
+      /**
+       * @brief      Lightmap constructor
+       *
+       * @param[in]  width   The width in texels
+       * @param[in]  height  The height in texels
+       * @param[in]  bounds  The world rectangle covered as (x, y, width, height)
+       */
+      [[scriptable]] Lightmap(const unsigned int width, const unsigned int height, const glm::vec4& bounds);
+
+      /**
+       * @brief      Adds the light of the given lights to the lightmap.
+       *
+       * @param[in]  lights  The lights
+       */
+      void bake(const std::vector<std::shared_ptr<Light>>& lights);
+      /**
+       * @brief      Creates a texture from the baked light.
+       *
+       * @return     The texture.
+       */
+      [[scriptable]] std::shared_ptr<BaseTexture> createTexture() const;
+
+      /**
+       * @brief      Gets the baked light of a texel.
+       *
+       * @param[in]  x     The texel x
+       * @param[in]  y     The texel y, 0 is the bottom row
+       *
+       * @return     The light color clamped 0.0, 1.0.
+       */
+      [[scriptable]] glm::vec3 getTexel(const unsigned int x, const unsigned int y) const;
+      /**
+       * @brief      Gets the world rectangle covered.
+       *
+       * @return     The rectangle as (x, y, width, height).
+       */
+      [[scriptable]] glm::vec4 getBounds() const noexcept;
+      /**
+       * @brief      Gets the width.
+       *
+       * @return     The width in texels.
+       */
+      [[scriptable]] unsigned int getWidth() const noexcept;
+      /**
+       * @brief      Gets the height.
+       *
+       * @return     The height in texels.
+       */
+      [[scriptable]] unsigned int getHeight() const noexcept;
+  };
+}
+
+#endif
@@ -0,0 +1,131 @@
+#include <sstream>
+#include "material.h"
+#include "lightmap.h"
+#include "light_grid.h"
+#include "light_accumulation_buffer.h"
+
+namespace Graphics {
+  unsigned int Material::next_id = 0;
+
+  Material::Material() : id(next_id++), shader(nullptr), light_reactive(false), ambient_light(1.0), ambient_intensity(1.0) {
+  }
+
+  std::shared_ptr<Material> Material::create() {
+    return std::make_shared<Material>();
+  }
+
+  unsigned int Material::getId() const noexcept {
+    return id;
+  }
+
+  void Material::setShader(std::shared_ptr<Shader> shader_object) noexcept {
+    shader = shader_object;
+  }
+
+  std::shared_ptr<Shader> Material::getShader() const noexcept {
+    return shader;
+  }
+
+  void Material::addTexture(const unsigned int unit, const std::string uniform_name, std::shared_ptr<BaseTexture> texture_object) {
+    textures[unit] = texture_object;
+    Uniform texture_uniform;
+    //convert unit to int, samplers expect glUniform1i
+    texture_uniform.setData(uniform_name, (int)unit);
+    setUniform(texture_uniform);
+  }
+
+  void Material::removeTexture(const unsigned int unit) {
+    textures.erase(unit);
+  }
+
+  std::map<unsigned int, std::shared_ptr<BaseTexture>> Material::getTextures() const noexcept {
+    return textures;
+  }
+
+  void Material::setUniform(const Uniform& uniform) {
+    uniforms.set(uniform);
+  }
+
+  std::vector<Uniform> Material::getUniforms() const noexcept {
+    return uniforms.getUniforms();
+  }
+
+  void Material::setLightReactive(const bool reactive) {
+    light_reactive = reactive;
+    if(light_reactive)
+      setLightingUniforms();
+  }
+
+  bool Material::isLightReactive() const noexcept {
+    return light_reactive;
+  }
+
+  void Material::setAmbientLight(const glm::vec3 color) {
+    ambient_light = color;
+    if(light_reactive)
+      setLightingUniforms();
+  }
+
+  glm::vec3 Material::getAmbientLight() const noexcept {
+    return ambient_light;
+  }
+
+  void Material::setAmbientIntensity(const float intensity) {
+    ambient_intensity = intensity;
+    if(light_reactive)
+      setLightingUniforms();
+  }
+
+  float Material::getAmbientIntensity() const noexcept {
+    return ambient_intensity;
+  }
+
+  void Material::setLightmap(std::shared_ptr<BaseTexture> lightmap, const glm::vec4& bounds) {
+    addTexture(Lightmap::LIGHTMAP_UNIT, "lightmap", lightmap);
+
+    Uniform bounds_uniform;
+    bounds_uniform.setData<glm::vec4>("lightmap_bounds", bounds);
+    setUniform(bounds_uniform);
+  }
+
+  void Material::setLightingUniforms() {
+    Uniform ambient_uniform;
+    ambient_uniform.setData<glm::vec3>("ambient_color", ambient_light);
+    Uniform ambient_intensity_uniform;
+    ambient_intensity_uniform.setData<float>("ambient_intensity", ambient_intensity);
+    setUniform(ambient_uniform);
+    setUniform(ambient_intensity_uniform);
+
+    //The light grid stays bound to its units for the whole frame
+    Uniform light_data_uniform;
+    light_data_uniform.setData<int>("light_data", LightGrid::LIGHT_DATA_UNIT);
+    Uniform light_cells_uniform;
+    light_cells_uniform.setData<int>("light_cells", LightGrid::LIGHT_CELLS_UNIT);
+    Uniform light_indices_uniform;
+    light_indices_uniform.setData<int>("light_indices", LightGrid::LIGHT_INDICES_UNIT);
+    setUniform(light_data_uniform);
+    setUniform(light_cells_uniform);
+    setUniform(light_indices_uniform);
+
+    Uniform light_accumulation_uniform;
+    light_accumulation_uniform.setData<int>("light_accumulation", LightAccumulationBuffer::LIGHT_ACCUMULATION_UNIT);
+    setUniform(light_accumulation_uniform);
+  }
+
+  void Material::apply(std::shared_ptr<Shader> program) {
+    uniforms.apply(program);
+    for(auto& texture : textures) {
+      texture.second->bind(texture.first);
+    }
+  }
+
+  std::string Material::to_string() const noexcept {
+    std::stringstream str;
+    str << "Material:: id: "<<id<<" textures: "<<textures.size()<<" light reactive: "<<light_reactive;
+
+    for(auto& uniform : uniforms.getUniforms()) {
+      str<<" "<<uniform.to_string();
+    }
+    return str.str();
+  }
+}
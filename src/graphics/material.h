@@ -0,0 +1,167 @@
+#ifndef MATERIAL_H
+#define MATERIAL_H
+#include <glm/glm.hpp>
+#include <map>
+#include <memory>
+#include <vector>
+#include <string>
+#include "shader.h"
+#include "base_texture.h"
+#include "uniform.h"
+#include "uniform_block.h"
+
+namespace Graphics {
+  /**
+   * @brief      Shader, textures and constant uniforms shared by renderables.
+   *
+   * @detail     Renderables drawn the same way reference one material and only keep their own
+   * transform. Only uniforms another material or renderable changed since are set again, so
+   * renderables sharing one sort next to each other.
+   */
+  class [[scriptable]] Material {
+    private:
+      unsigned int id;
+      std::shared_ptr<Shader> shader;
+      std::map<unsigned int, std::shared_ptr<BaseTexture>> textures;
+      UniformBlock uniforms;
+
+      bool light_reactive;
+      glm::vec3 ambient_light;
+      float ambient_intensity;
+
+      static unsigned int next_id;
+
+      void setLightingUniforms();
+    public:
+      /**
+       * @brief      Material constructor
+       */
+      [[scriptable]] Material();
+      /**
+       * @brief      Material factory function
+       *
+       * @return     newly created Material
+       */
+      [[scriptable]] static std::shared_ptr<Material> create();
+
+      //Remove copy constructor and assignment
+      Material(const Material&) = delete;
+      Material operator=(Material&) = delete;
+
+      /**
+       * @brief      Gets the identifier.
+       *
+       * @return     The identifier, unique to every material.
+       */
+      [[scriptable]] unsigned int getId() const noexcept;
+
+      /**
+       * @brief      Sets the shader.
+       *
+       * @param[in]  shader_object  The shader object
+       */
+      [[scriptable]] void setShader(std::shared_ptr<Shader> shader_object) noexcept;
+      /**
+       * @brief      Gets the shader.
+       *
+       * @return     The shader.
+       */
+      [[scriptable]] std::shared_ptr<Shader> getShader() const noexcept;
+
+      /**
+       * @brief      Adds a texture.
+       *
+       * @param[in]  unit            The unit
+       * @param[in]  uniform_name    The uniform name
+       * @param[in]  texture_object  The texture object
+       */
+      [[scriptable]] void addTexture(const unsigned int unit, const std::string uniform_name, std::shared_ptr<BaseTexture> texture_object);
+      /**
+       * @brief      Removes a texture.
+       *
+       * @param[in]  unit  The unit
+       */
+      [[scriptable]] void removeTexture(const unsigned int unit);
+      /**
+       * @brief      Gets the textures
+       *
+       * @return     A map of texture units to textures
+       */
+      [[scriptable]] std::map<unsigned int, std::shared_ptr<BaseTexture>> getTextures() const noexcept;
+
+      /**
+       * @brief      Sets a uniform every renderable using the material draws with.
+       *
+       * @param[in]  uniform  The uniform
+       */
+      [[scriptable]] void setUniform(const Uniform& uniform);
+      /**
+       * @brief      Gets the uniforms.
+       *
+       * @return     The uniforms.
+       */
+      std::vector<Uniform> getUniforms() const noexcept;
+
+      /**
+       * @brief      Sets if the material should be light reactive
+       *
+       * @param[in]  reactive  True if reactive
+       */
+      [[scriptable]] void setLightReactive(const bool reactive);
+      /**
+       * @brief      Determines if light reactive.
+       *
+       * @return     True if light reactive, False otherwise.
+       */
+      [[scriptable]] bool isLightReactive() const noexcept;
+      /**
+       * @brief      Sets the ambient light.
+       *
+       * @param[in]  color  The color
+       */
+      [[scriptable]] void setAmbientLight(const glm::vec3 color);
+      /**
+       * @brief      Gets the ambient light.
+       *
+       * @return     The ambient light.
+       */
+      [[scriptable]] glm::vec3 getAmbientLight() const noexcept;
+      /**
+       * @brief      Sets the ambient intensity.
+       *
+       * @param[in]  intensity  The intensity
+       */
+      [[scriptable]] void setAmbientIntensity(const float intensity);
+      /**
+       * @brief      Gets the ambient intensity.
+       *
+       * @return     The ambient intensity.
+       */
+      [[scriptable]] float getAmbientIntensity() const noexcept;
+      /**
+       * @brief      Sets the baked light added on top of the live lights.
+       *
+       * @param[in]  lightmap  The lightmap texture
+       * @param[in]  bounds    The world rectangle the lightmap covers as (x, y, width, height)
+       */
+      [[scriptable]] void setLightmap(std::shared_ptr<BaseTexture> lightmap, const glm::vec4& bounds);
+
+      /**
+       * @brief      Sets the changed uniforms on a program and binds the textures.
+       *
+       * @detail     Textures are always bound, text and render targets bind their own in between.
+       *
+       * @param[in]  program  The shader or the fallback drawing in its place, it has to be in use
+       */
+      void apply(std::shared_ptr<Shader> program);
+
+      /**
+       * @brief      Returns a string representation of the object.
+       *
+       * @return     String representation of the object.
+       */
+      [[scriptable]] std::string to_string() const noexcept;
+  };
+}
+
+#endif
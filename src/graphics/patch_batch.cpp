@@ -0,0 +1,74 @@
+#ifdef __APPLE__
+#include <OpenGL/gl3.h>
+#else
+#include <glad/glad.h>
+#endif
+#include <stdexcept>
+#include "patch_batch.h"
+
+namespace Graphics {
+  PatchBatch::PatchBatch(std::shared_ptr<GeometryArena::Allocation> geometry) : Renderable(geometry), camera(nullptr) {
+    if(!geometry->isQuads())
+      throw std::invalid_argument("Batched patches have to be quads");
+    patches.push_back(Patch{geometry, geometry->getRecord()});
+  }
+
+  bool PatchBatch::canAddPatch(std::shared_ptr<GeometryArena::Allocation> geometry) const noexcept {
+    return geometry->isQuads() && geometry->getVertexArrayObject() == getVertexArrayBinding();
+  }
+
+  void PatchBatch::addPatch(std::shared_ptr<GeometryArena::Allocation> geometry) {
+    if(!canAddPatch(geometry))
+      throw std::invalid_argument("Patch isn't quads in the batch's arena page");
+    patches.push_back(Patch{geometry, geometry->getRecord()});
+  }
+
+  unsigned int PatchBatch::getPatchCount() const noexcept {
+    return patches.size();
+  }
+
+  void PatchBatch::setCamera(std::shared_ptr<Camera> camera) noexcept {
+    this->camera = camera;
+  }
+
+  bool PatchBatch::isVisible(const VertexRecord& record, const glm::vec4& view) const noexcept {
+    auto low = record.getLow();
+    auto high = record.getHigh();
+    return high.x >= view.x && low.x <= view.z && high.y >= view.y && low.y <= view.w;
+  }
+
+  void PatchBatch::draw() {
+    counts.clear();
+    offsets.clear();
+    base_vertices.clear();
+
+    //The camera's view as (left, bottom, right, top) in the coordinates the patches are in
+    glm::vec4 view;
+    if(camera != nullptr) {
+      auto center = glm::vec2(camera->getTransform()->getAbsoluteTranslation() - getTransform()->getAbsoluteTranslation());
+      auto half_size = glm::vec2(camera->getWidth(), camera->getHeight()) / 2.0f;
+      view = glm::vec4(center - half_size, center + half_size);
+    }
+
+    for(auto& patch : patches) {
+      if(camera != nullptr && !isVisible(patch.record, view))
+        continue;
+
+      //Quads index from their first vertex, a patch starting where the last draw ends continues it
+      if(!base_vertices.empty() && (unsigned int)base_vertices.back() + counts.back() / 6 * 4 == patch.record.getFirstVertex()) {
+        counts.back() += patch.record.getIndexCount();
+        continue;
+      }
+      counts.push_back(patch.record.getIndexCount());
+      offsets.push_back((const void*)(patch.record.getFirstIndex() * sizeof(unsigned int)));
+      base_vertices.push_back(patch.record.getFirstVertex());
+    }
+
+    if(!counts.empty())
+      glMultiDrawElementsBaseVertex(GL_TRIANGLES, counts.data(), GL_UNSIGNED_INT, offsets.data(), counts.size(), base_vertices.data());
+  }
+
+  std::string PatchBatch::className() const noexcept {
+    return "Graphics::PatchBatch";
+  }
+}
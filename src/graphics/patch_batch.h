@@ -0,0 +1,83 @@
+#ifndef PATCH_BATCH_H
+#define PATCH_BATCH_H
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+#include "renderable.h"
+#include "geometry_arena.h"
+#include "camera.h"
+
+namespace Graphics {
+  /**
+   * @brief      Renderable that draws many map patches of one arena page with a single call.
+   *
+   * @detail     The patches share the shader, textures and uniforms of the batch, only their vertex
+   * ranges differ, so the visible ones go to one glMultiDrawElementsBaseVertex. Patches are quads
+   * from GeometryArena::allocateQuads, and patches next to each other in the page merge into one
+   * draw. With a camera set, patches outside its view are left out.
+   */
+  class [[scriptable]] PatchBatch : public Renderable {
+    private:
+      struct Patch {
+        std::shared_ptr<GeometryArena::Allocation> geometry;
+        VertexRecord record;
+      };
+
+      std::vector<Patch> patches;
+      std::shared_ptr<Camera> camera;
+
+      //Reused every frame
+      std::vector<GLsizei> counts;
+      std::vector<const void*> offsets;
+      std::vector<GLint> base_vertices;
+
+      bool isVisible(const VertexRecord& record, const glm::vec4& view) const noexcept;
+
+    protected:
+      virtual void draw() override;
+
+    public:
+      /**
+       * @brief      PatchBatch constructor
+       *
+       * @param[in]  geometry  The first patch, the batch draws from its page
+       */
+      PatchBatch(std::shared_ptr<GeometryArena::Allocation> geometry);
+
+      //Remove copy constructor and assignment
+      PatchBatch(const PatchBatch&) = delete;
+      PatchBatch operator=(PatchBatch&) = delete;
+
+      /**
+       * @brief      Determines if a patch can be added.
+       *
+       * @param[in]  geometry  The patch
+       *
+       * @return     True if the patch is quads in the batch's page, False otherwise.
+       */
+      bool canAddPatch(std::shared_ptr<GeometryArena::Allocation> geometry) const noexcept;
+      /**
+       * @brief      Adds a patch.
+       *
+       * @param[in]  geometry  The patch, in the batch's page
+       */
+      void addPatch(std::shared_ptr<GeometryArena::Allocation> geometry);
+      /**
+       * @brief      Gets the number of patches.
+       *
+       * @return     The patch count.
+       */
+      [[scriptable]] unsigned int getPatchCount() const noexcept;
+
+      /**
+       * @brief      Sets the camera patches are culled against.
+       *
+       * @param[in]  camera  The camera, nullptr to draw every patch
+       */
+      [[scriptable]] void setCamera(std::shared_ptr<Camera> camera) noexcept;
+
+      [[scriptable]] virtual std::string className() const noexcept override;
+  };
+}
+
+#endif
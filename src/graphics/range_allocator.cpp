@@ -0,0 +1,65 @@
+#include <iterator>
+#include <stdexcept>
+#include "range_allocator.h"
+
+namespace Graphics {
+  RangeAllocator::RangeAllocator(const size_t capacity) : capacity(capacity), used(0) {
+    if(capacity > 0)
+      free_ranges[0] = capacity;
+  }
+
+  size_t RangeAllocator::allocate(const size_t size) {
+    if(size == 0)
+      return 0;
+
+    for(auto range = free_ranges.begin(); range != free_ranges.end(); range++) {
+      if(range->second < size)
+        continue;
+
+      auto offset = range->first;
+      auto remaining = range->second - size;
+      free_ranges.erase(range);
+      if(remaining > 0)
+        free_ranges[offset + size] = remaining;
+      used += size;
+      return offset;
+    }
+    return INVALID;
+  }
+
+  void RangeAllocator::free(const size_t offset, const size_t size) {
+    if(size == 0)
+      return;
+    if(offset + size > capacity || size > used)
+      throw std::out_of_range("Freed range is outside the allocator");
+
+    auto start = offset;
+    auto end = offset + size;
+
+    //Merge with the free range after
+    auto next = free_ranges.lower_bound(offset);
+    if(next != free_ranges.end() && next->first == end) {
+      end += next->second;
+      next = free_ranges.erase(next);
+    }
+    //And the one before
+    if(next != free_ranges.begin()) {
+      auto previous = std::prev(next);
+      if(previous->first + previous->second == start) {
+        start = previous->first;
+        free_ranges.erase(previous);
+      }
+    }
+
+    free_ranges[start] = end - start;
+    used -= size;
+  }
+
+  size_t RangeAllocator::getCapacity() const noexcept {
+    return capacity;
+  }
+
+  size_t RangeAllocator::getUsed() const noexcept {
+    return used;
+  }
+}
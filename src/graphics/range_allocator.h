@@ -0,0 +1,63 @@
+#ifndef RANGE_ALLOCATOR_H
+#define RANGE_ALLOCATOR_H
+#include <cstddef>
+#include <limits>
+#include <map>
+
+namespace Graphics {
+  /**
+   * @brief      First fit allocator of ranges in a fixed capacity, freed ranges merge with their neighbors.
+   */
+  class RangeAllocator {
+    public:
+      /**
+       * Returned when no free range is large enough
+       */
+      static const size_t INVALID = std::numeric_limits<size_t>::max();
+
+    private:
+      //Free ranges by offset, to their size
+      std::map<size_t, size_t> free_ranges;
+      size_t capacity;
+      size_t used;
+
+    public:
+      /**
+       * @brief      RangeAllocator constructor
+       *
+       * @param[in]  capacity  The capacity
+       */
+      RangeAllocator(const size_t capacity);
+
+      /**
+       * @brief      Allocates a range.
+       *
+       * @param[in]  size  The size
+       *
+       * @return     The offset of the range, INVALID if it doesn't fit.
+       */
+      size_t allocate(const size_t size);
+      /**
+       * @brief      Frees a range.
+       *
+       * @param[in]  offset  The offset returned by allocate
+       * @param[in]  size    The size it was allocated with
+       */
+      void free(const size_t offset, const size_t size);
+
+      /**
+       * @brief      Gets the capacity.
+       *
+       * @return     The capacity.
+       */
+      size_t getCapacity() const noexcept;
+      /**
+       * @brief      Gets the allocated size.
+       *
+       * @return     The sum of the allocated ranges.
+       */
+      size_t getUsed() const noexcept;
+  };
+}
+
+#endif
@@ -19,11 +19,21 @@
 #include "graphics/set_uniform_event.h"
 
 namespace Graphics {
-  Renderable::Renderable(const unsigned int vertex_array_object, const VertexData& vertex_data) : shader(nullptr), vertex_data(vertex_data), light_reactive(false), ambient_light(1.0), ambient_intensity(1.0) {
+  Renderable::Renderable(std::shared_ptr<GPUResource> vertex_array, const VertexData& vertex_data) : Renderable(vertex_array, vertex_data.getRecord()) {
+  }
+
+  Renderable::Renderable(std::shared_ptr<GPUResource> vertex_array, const VertexRecord& vertex_record) : vertex_array(vertex_array), material(Material::create()), vertex_record(vertex_record), alpha_mode(AlphaMode::TRANSLUCENT) {
+    vertex_array_object = vertex_array != nullptr ? vertex_array->getObject() : 0;
+    if(!glIsVertexArray(vertex_array_object)) {
+      throw Exceptions::InvalidVertexArrayException(vertex_array_object);
+    }
+  }
+
+  Renderable::Renderable(std::shared_ptr<GeometryArena::Allocation> geometry) : vertex_array_object(geometry->getVertexArrayObject()), material(Material::create()), vertex_record(geometry->getRecord()), geometry(geometry), alpha_mode(AlphaMode::TRANSLUCENT) {
+    //The arena page owns the vertex array
     if(!glIsVertexArray(vertex_array_object)) {
       throw Exceptions::InvalidVertexArrayException(vertex_array_object);
     }
-    this->vertex_array_object = vertex_array_object;
   }
 
 
@@ -31,19 +41,19 @@ namespace Graphics {
     return std::make_shared<Renderable>(vertex_data.generateVertexArrayObject(), vertex_data);
   }
 
-  Renderable::Renderable(Renderable&& renderable) : vertex_data(renderable.vertex_data) {
+  Renderable::Renderable(Renderable&& renderable) : vertex_array(std::move(renderable.vertex_array)), vertex_record(renderable.vertex_record), geometry(std::move(renderable.geometry)) {
     vertex_array_object = std::move(renderable.vertex_array_object);
-    shader = renderable.shader;
-    light_reactive = std::move(renderable.light_reactive);
-    textures = renderable.textures;
+    material = renderable.material;
+    alpha_mode = renderable.alpha_mode;
   }
 
   Renderable& Renderable::operator=(Renderable&& renderable) {
     vertex_array_object = std::move(renderable.vertex_array_object);
-    shader = renderable.shader;
-    vertex_data = renderable.vertex_data;
-    light_reactive = std::move(renderable.light_reactive);
-    textures = renderable.textures;
+    vertex_array = std::move(renderable.vertex_array);
+    material = renderable.material;
+    vertex_record = renderable.vertex_record;
+    geometry = std::move(renderable.geometry);
+    alpha_mode = renderable.alpha_mode;
 
     return *this;
   }
@@ -52,114 +62,93 @@ namespace Graphics {
     onDestroy();
   }
 
+  void Renderable::setMaterial(std::shared_ptr<Material> material) {
+    if(material == nullptr)
+      throw std::invalid_argument("Renderable material can't be null");
+    this->material = material;
+  }
+
+  std::shared_ptr<Material> Renderable::getMaterial() const noexcept {
+    return material;
+  }
+
   void Renderable::setShader(const std::shared_ptr<Shader> shader_object) noexcept {
-    this->shader = shader_object;
+    material->setShader(shader_object);
   }
 
   std::shared_ptr<Shader> Renderable::getShader() const noexcept {
-    return shader;
+    return material->getShader();
   }
 
-  void Renderable::addTexture(const unsigned int unit, const std::string uniform_name, std::shared_ptr<BaseTexture> texture_object) noexcept {
-    textures[unit] = texture_object;
-    Uniform texture_uniform;
-    //convert unit to int, samplers expect glUniform1i
-    texture_uniform.setData(uniform_name, (int)unit);
-    uniforms.insert(texture_uniform);
+  void Renderable::addTexture(const unsigned int unit, const std::string uniform_name, std::shared_ptr<BaseTexture> texture_object) {
+    material->addTexture(unit, uniform_name, texture_object);
   }
 
   void Renderable::removeTexture(const unsigned int unit) {
-    textures.erase(unit);
+    material->removeTexture(unit);
   }
 
   std::map<unsigned int, std::shared_ptr<BaseTexture>> Renderable::getTextures() const noexcept {
-    return textures;
+    return material->getTextures();
   }
 
-  void Renderable::setLightReactive(const bool reactive) noexcept {
-    light_reactive = reactive;
+  void Renderable::setLightReactive(const bool reactive) {
+    material->setLightReactive(reactive);
   }
 
   bool Renderable::isLightReactive() const noexcept {
-    return light_reactive;
+    return material->isLightReactive();
   }
 
-  void Renderable::setAmbientLight(const glm::vec3 color) noexcept {
-    ambient_light = color;
+  void Renderable::setAmbientLight(const glm::vec3 color) {
+    material->setAmbientLight(color);
   }
 
   glm::vec3 Renderable::getAmbientLight() const noexcept {
-    return ambient_light;
+    return material->getAmbientLight();
   }
 
-  void Renderable::setAmbientIntensity(const float intensity) noexcept {
-    ambient_intensity = intensity;
+  void Renderable::setAmbientIntensity(const float intensity) {
+    material->setAmbientIntensity(intensity);
   }
 
   float Renderable::getAmbientIntensity() const noexcept {
-    return ambient_intensity;
+    return material->getAmbientIntensity();
   }
 
-  void Renderable::addInfluencingLight(std::shared_ptr<Light> light) noexcept {
-    influencing_lights.push_back(light);
+  void Renderable::setAlphaMode(const AlphaMode mode) noexcept {
+    alpha_mode = mode;
   }
 
-  void Renderable::clearInfluencingLights() {
-    influencing_lights.clear();
+  Renderable::AlphaMode Renderable::getAlphaMode() const noexcept {
+    return alpha_mode;
+  }
+
+  void Renderable::setLightmap(std::shared_ptr<BaseTexture> lightmap, const glm::vec4& bounds) {
+    material->setLightmap(lightmap, bounds);
   }
 
   float Renderable::highestZ() const noexcept {
-    return vertex_data.highestZ();
+    return vertex_record.highestZ();
   }
 
   unsigned int Renderable::getVertexArrayBinding() const noexcept {
     return vertex_array_object;
   }
 
-  VertexData Renderable::getVertexData() const noexcept {
-    return vertex_data;
+  VertexRecord Renderable::getVertexRecord() const noexcept {
+    return vertex_record;
   }
 
-  void Renderable::setUniforms() {
-    for(auto i : uniforms) {
-      if(i.isDirty()) {
-        getShader()->setUniform(i);
-        i.clean();
-      }
-    }
-  }
-
-  void Renderable::setUniform(const Uniform& uniform) noexcept {
-    auto find_iter = uniforms.find(uniform);
-
-    if(find_iter != uniforms.end()) {
-      if(*find_iter != uniform) {
-        uniforms.erase(find_iter);
-        uniforms.insert(uniform);
-      }
-    }
-    else {
-      uniforms.insert(uniform);
-    }
+  void Renderable::setUniform(const Uniform& uniform) {
+    uniforms.set(uniform);
   }
 
   void Renderable::onDestroy() {
-    //not this one's job to destroy shader
-    shader = nullptr;
-    textures.clear();
+    //not this one's job to destroy the shader or textures, other renderables may share the material
   }
 
   void Renderable::onStart() {
-    if(light_reactive) {
-      Uniform ambient_uniform;
-      ambient_uniform.setData<glm::vec3>("ambient_color", ambient_light);
-
-      Uniform ambient_intensity_uniform;
-      ambient_intensity_uniform.setData<float>("ambient_intensity", ambient_intensity);
-
-      setUniform(ambient_uniform);
-      setUniform(ambient_intensity_uniform);
-    }
   }
 
   bool Renderable::onUpdate(const double delta) {
@@ -173,55 +162,46 @@ namespace Graphics {
       setUniform(transform_uniform);
 
 
+      //Shaders still linking draw with their fallback, or not at all
+      auto shader = material->getShader();
+      auto program = shader;
+      if(program != nullptr && !program->isReady()) {
+        program = shader->getFallback();
+        if(program == nullptr || !program->isReady())
+          return true;
+      }
+
       glBindVertexArray(vertex_array_object);
 
-      if(shader != nullptr) {
-        setUniforms();
-        // if(light_reactive) {
-        //   shader->setUniform("num_lights", (int)influencing_lights.size());
-        //   int index = 0;
-        //   std::stringstream light_str;
-        //   for(auto& light : influencing_lights) {
-        //     light_str << "lights[" << index << "].";
-        //     shader->setUniform(light_str.str() + "position", light->getTransform()->getAbsoluteTranslation());
-        //     shader->setUniform(light_str.str() + "color", light->getColor());
-        //     shader->setUniform(light_str.str() + "intensity", light->getIntensity());
-        //     shader->setUniform(light_str.str() + "linear_attenuation", light->getLinearAttenuation());
-        //     if(light->castsQuantizedBands()) {
-        //       shader->setUniform(light_str.str() + "number_quantized_bands", light->getNumberOfQuantizedBands());
-        //     }
-        //     if(light->getType() == Light::Type::POINT) {
-        //       shader->setUniform(light_str.str() + "cone_angle", 0.0f);
-        //     }
-        //     else if(light->getType() == Light::Type::SPOT) {
-        //       shader->setUniform(light_str.str() + "cone_angle", light->getConeAngle());
-        //       shader->setUniform(light_str.str() + "cone_direction", light->getConeDirection());
-        //     }
-        //     light_str.str(std::string());
-        //     index++;
-        //   }
-        // }
-
-        shader->useProgram();
-
-        for(auto& texture : textures) {
-          texture.second->bind(texture.first);
-        }
+      if(program != nullptr) {
+        program->useProgram();
+        material->apply(program);
+        uniforms.apply(program);
       }
       else {
         LOG(WARNING)<<"Trying to render renderable with nullptr shader";
       }
 
-      if(vertex_data.getIndexCount() > 0) {
-        glDrawElements(GL_TRIANGLES, vertex_data.getIndexCount(), GL_UNSIGNED_INT, 0);
-      }
-      else {
-        glDrawArrays(GL_TRIANGLES, 0, vertex_data.getVertexCount());
-      }
+      //Nothing shows through opaque and cutout texels, so they skip blending
+      if(alpha_mode != AlphaMode::TRANSLUCENT)
+        glDisable(GL_BLEND);
+      draw();
+      if(alpha_mode != AlphaMode::TRANSLUCENT)
+        glEnable(GL_BLEND);
     }
     return true;
   }
 
+  void Renderable::draw() {
+    if(vertex_record.getIndexCount() > 0) {
+      //Indices count from the first vertex, so arena pages don't have to rebase them
+      glDrawElementsBaseVertex(GL_TRIANGLES, vertex_record.getIndexCount(), GL_UNSIGNED_INT, (void*)(vertex_record.getFirstIndex() * sizeof(unsigned int)), vertex_record.getFirstVertex());
+    }
+    else {
+      glDrawArrays(GL_TRIANGLES, vertex_record.getFirstVertex(), vertex_record.getVertexCount());
+    }
+  }
+
 
   void Renderable::handleQueuedEvent(std::shared_ptr<Events::Event> event) {
     switch(event->getEventType()) {
@@ -248,8 +228,13 @@ namespace Graphics {
   }
 
   unsigned long long Renderable::getValueForSorting() const noexcept {
+    auto z = getTransform()->getAbsoluteTranslation().z;
+    if(alpha_mode == AlphaMode::TRANSLUCENT)
+      return (unsigned long long)z;
 
-    return (unsigned long long)getTransform()->getAbsoluteTranslation().z;
+    //Front to back, so hidden fragments fail the depth test before shading, then by material so shared state stays bound
+    auto depth = (unsigned long long)(std::max(0.0f, -z) * 1024.0f);
+    return OPAQUE_SORT_BASE + (depth << MATERIAL_SORT_BITS) + (material->getId() & ((1U << MATERIAL_SORT_BITS) - 1));
   }
 
   std::string Renderable::className() const noexcept {
@@ -258,9 +243,9 @@ namespace Graphics {
 
   std::string Renderable::to_string() const noexcept {
     std::stringstream str;
-    str << Component::to_string()<<" vao: "<<vertex_array_object<<" Highest Z: "<<highestZ();
+    str << Component::to_string()<<" vao: "<<vertex_array_object<<" Highest Z: "<<highestZ()<<" "<<material->to_string();
 
-    for(auto u : uniforms) {
+    for(auto& u : uniforms.getUniforms()) {
       str<<" "<<u.to_string();
     }
     return str.str();
@@ -3,47 +3,80 @@
 #include <glm/glm.hpp>
 #include <map>
 #include <memory>
-#include <set>
 #include "../component.h"
 #include "../transform.h"
 #include "../events/observer.h"
 #include "vertex_data.h"
+#include "vertex_record.h"
+#include "vertex_layout.h"
+#include "geometry_arena.h"
 #include "shader.h"
 #include "base_texture.h"
 #include "light.h"
+#include "lightmap.h"
+#include "material.h"
 #include "uniform.h"
+#include "uniform_block.h"
+#include "gpu_resource.h"
 
 namespace Graphics {
   /**
    * @brief      Class for renderable.
    */
   class [[scriptable]] Renderable : public Component {
+    public:
+      /**
+       * @brief      How a renderable's texels cover what is behind them
+       */
+      enum [[scriptable]] AlphaMode : unsigned int { OPAQUE, CUTOUT, TRANSLUCENT };
     private:
       unsigned int vertex_array_object;
-      std::shared_ptr<Shader> shader;
-      std::map<unsigned int, std::shared_ptr<BaseTexture>> textures;
+      //Set when the renderable owns its vertex array, released with the renderable
+      std::shared_ptr<GPUResource> vertex_array;
+      std::shared_ptr<Material> material;
+
+      VertexRecord vertex_record;
+      //Set when the vertices live in a shared arena page, released with the renderable
+      std::shared_ptr<GeometryArena::Allocation> geometry;
 
-      VertexData vertex_data;
+      AlphaMode alpha_mode;
 
-      bool light_reactive;
-      std::list<std::shared_ptr<Light>> influencing_lights;
-      glm::vec3 ambient_light;
-      float ambient_intensity;
+      //Opaque and cutout renderables sort after the id sorted components and before the z sorted ones
+      static const unsigned long long OPAQUE_SORT_BASE = 1ULL << 62;
+      //Opaque renderables at the same depth sort by the low bits of their material id
+      static const unsigned int MATERIAL_SORT_BITS = 20;
 
-      void setUniforms();
     protected:
-      std::set<Uniform> uniforms;
-      void setUniform(const Uniform& uniform) noexcept;
-      Renderable() {}
+      UniformBlock uniforms;
+      void setUniform(const Uniform& uniform);
+      Renderable() : material(Material::create()), alpha_mode(AlphaMode::TRANSLUCENT) {}
+
+      /**
+       * @brief      Issues the draw call for the bound vertex array object
+       */
+      virtual void draw();
 
     public:
       /**
        * @brief      Renderable constructor
        *
-       * @param[in]  vertex_array_object  The vertex array object
-       * @param[in]  vertex_data          The vertex data
+       * @param[in]  vertex_array  The vertex array object
+       * @param[in]  vertex_data   The vertex data
        */
-      Renderable(const unsigned int vertex_array_object, const VertexData& vertex_data);
+      Renderable(std::shared_ptr<GPUResource> vertex_array, const VertexData& vertex_data);
+      /**
+       * @brief      Renderable constructor
+       *
+       * @param[in]  vertex_array   The vertex array object
+       * @param[in]  vertex_record  The record of the uploaded vertices
+       */
+      Renderable(std::shared_ptr<GPUResource> vertex_array, const VertexRecord& vertex_record);
+      /**
+       * @brief      Renderable constructor
+       *
+       * @param[in]  geometry  The range of a geometry arena page holding the vertices
+       */
+      Renderable(std::shared_ptr<GeometryArena::Allocation> geometry);
       /**
        * @brief      Renderable factory function
        *
@@ -52,6 +85,33 @@ namespace Graphics {
        * @return     newly created Renderable
        */
       static std::shared_ptr<Renderable> create(const VertexData& vertex_data);
+      /**
+       * @brief      Renderable factory function
+       *
+       * @param[in]  vertex_layout  The interleaved vertices
+       *
+       * @tparam     Attributes     The vertex attributes
+       *
+       * @return     newly created Renderable
+       */
+      template<class... Attributes>
+      static std::shared_ptr<Renderable> create(const VertexLayout<Attributes...>& vertex_layout) {
+        return std::make_shared<Renderable>(vertex_layout.generateVertexArrayObject(), vertex_layout.getRecord());
+      }
+      /**
+       * @brief      Renderable factory function, the vertices are uploaded to a shared arena.
+       *
+       * @param[in]  vertex_layout  The interleaved vertices
+       * @param[in]  arena          The geometry arena
+       *
+       * @tparam     Attributes     The vertex attributes
+       *
+       * @return     newly created Renderable
+       */
+      template<class... Attributes>
+      static std::shared_ptr<Renderable> create(const VertexLayout<Attributes...>& vertex_layout, GeometryArena& arena) {
+        return std::make_shared<Renderable>(arena.allocate(vertex_layout));
+      }
 
       //Remove copy constructor and assignment
       Renderable(const Renderable&) = delete;
@@ -63,28 +123,76 @@ namespace Graphics {
       virtual ~Renderable();
 
       /**
-       * @brief      Sets the shader.
+       * @brief      Sets the material.
+       *
+       * @detail     Renderables drawn with the same shader, textures and constant uniforms should
+       * share one, the setters below change it for every renderable using it. Opaque renderables
+       * sort by their material, so it has to be set before the renderable is added to the
+       * component manager.
+       *
+       * @param[in]  material  The material
+       */
+      [[scriptable]] void setMaterial(std::shared_ptr<Material> material);
+      /**
+       * @brief      Gets the material.
+       *
+       * @return     The material.
+       */
+      [[scriptable]] std::shared_ptr<Material> getMaterial() const noexcept;
+
+      /**
+       * @brief      Gets the slot of one of the renderable's own uniforms, adding it if missing.
+       *
+       * @detail     Sibling components resolve their slots once in onStart and write through
+       * setUniformSlot afterwards, skipping the name lookup and the event.
+       *
+       * @param[in]  name     The uniform name
+       * @param[in]  initial  The value of an added uniform, giving it its type
+       *
+       * @tparam     T        DataType for uniform
+       *
+       * @return     The slot.
+       */
+      template<typename T>
+      unsigned int getUniformSlot(const std::string& name, const T& initial) {
+        return uniforms.getSlot(name, initial);
+      }
+      /**
+       * @brief      Sets the value of the uniform in a slot.
+       *
+       * @param[in]  slot   The slot from getUniformSlot
+       * @param[in]  value  The value
+       *
+       * @tparam     T      DataType for uniform
+       */
+      template<typename T>
+      void setUniformSlot(const unsigned int slot, const T& value) {
+        uniforms.setSlot(slot, value);
+      }
+
+      /**
+       * @brief      Sets the shader of the material.
        *
        * @param[in]  shader_object  The shader object
        */
       [[scriptable]] void setShader(std::shared_ptr<Shader> shader_object) noexcept;
       /**
-       * @brief      Gets the shader.
+       * @brief      Gets the shader of the material.
        *
        * @return     The shader.
        */
       [[scriptable]] std::shared_ptr<Shader> getShader() const noexcept;
 
       /**
-       * @brief      Adds a texture.
+       * @brief      Adds a texture to the material.
        *
        * @param[in]  unit            The unit
        * @param[in]  uniform_name    The uniform name
        * @param[in]  texture_object  The texture object
        */
-      [[scriptable]] void addTexture(const unsigned int unit, const std::string uniform_name, std::shared_ptr<BaseTexture> texture_object) noexcept;
+      [[scriptable]] void addTexture(const unsigned int unit, const std::string uniform_name, std::shared_ptr<BaseTexture> texture_object);
       /**
-       * @brief      Removes a texture.
+       * @brief      Removes a texture from the material.
        *
        * @param[in]  unit  The unit
        */
@@ -97,11 +205,11 @@ namespace Graphics {
       [[scriptable]] std::map<unsigned int, std::shared_ptr<BaseTexture>> getTextures() const noexcept;
 
       /**
-       * @brief      Sets if the renderable should be light reactive
+       * @brief      Sets if the material should be light reactive
        *
        * @param[in]  reactive  True if reactive
        */
-      [[scriptable]] void setLightReactive(const bool reactive) noexcept;
+      [[scriptable]] void setLightReactive(const bool reactive);
       /**
        * @brief      Determines if light reactive.
        *
@@ -110,11 +218,11 @@ namespace Graphics {
       [[scriptable]] bool isLightReactive() const noexcept;
 
       /**
-       * @brief      Sets the ambient light.
+       * @brief      Sets the ambient light of the material.
        *
        * @param[in]  color  The color
        */
-      [[scriptable]] void setAmbientLight(const glm::vec3 color) noexcept;
+      [[scriptable]] void setAmbientLight(const glm::vec3 color);
       /**
        * @brief      Gets the ambient light.
        *
@@ -122,28 +230,39 @@ namespace Graphics {
        */
       [[scriptable]] glm::vec3 getAmbientLight() const noexcept;
       /**
-       * @brief      Sets the ambient intensity.
+       * @brief      Sets the ambient intensity of the material.
        *
        * @param[in]  intensity  The intensity
        */
-      [[scriptable]] void setAmbientIntensity(const float intensity) noexcept;
+      [[scriptable]] void setAmbientIntensity(const float intensity);
       /**
        * @brief      Gets the ambient intensity.
        *
        * @return     The ambient intensity.
        */
       [[scriptable]] float getAmbientIntensity() const noexcept;
-
       /**
-       * @brief      Adds an influencing light.
+       * @brief      Sets the alpha mode.
+       *
+       * @detail     Opaque and cutout renderables are drawn without blending, nearest first, before
+       * the translucent ones. Has to be set before the renderable is added to the component manager.
+       *
+       * @param[in]  mode  The mode
+       */
+      [[scriptable]] void setAlphaMode(const AlphaMode mode) noexcept;
+      /**
+       * @brief      Gets the alpha mode.
        *
-       * @param[in]  light  The light
+       * @return     The alpha mode.
        */
-      [[scriptable]] void addInfluencingLight(std::shared_ptr<Light> light) noexcept;
+      [[scriptable]] AlphaMode getAlphaMode() const noexcept;
       /**
-       * @brief      Clears all influencing lights.
+       * @brief      Sets the baked light the material adds on top of the live lights.
+       *
+       * @param[in]  lightmap  The lightmap texture
+       * @param[in]  bounds    The world rectangle the lightmap covers as (x, y, width, height)
        */
-      [[scriptable]] void clearInfluencingLights();
+      [[scriptable]] void setLightmap(std::shared_ptr<BaseTexture> lightmap, const glm::vec4& bounds);
 
       /**
        * @brief      Returns a string representation of the object.
@@ -169,11 +288,11 @@ namespace Graphics {
       unsigned int getVertexArrayBinding() const noexcept;
 
       /**
-       * @brief      Gets the vertex data.
+       * @brief      Gets the record of the vertices.
        *
-       * @return     The vertex data.
+       * @return     The vertex record.
        */
-      VertexData getVertexData() const noexcept;
+      VertexRecord getVertexRecord() const noexcept;
 
       virtual void onDestroy() override;
       virtual void onStart() override;
@@ -1,4 +1,5 @@
 #include <easylogging++.h>
+#include <algorithm>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include "shader.h"
@@ -9,7 +10,7 @@
 #include "exceptions/invalid_uniform_name_exception.h"
 
 namespace Graphics {
-  Shader::Shader(const unsigned int vertex_program, const unsigned int fragment_program, const unsigned int geometry_program) : name("") {
+  Shader::Shader(const unsigned int vertex_program, const unsigned int fragment_program, const unsigned int geometry_program) : name(""), linked(false), link_failed(false), fallback(nullptr) {
     if(!glIsShader(vertex_program)) {
       throw Exceptions::InvalidVertexShaderException(vertex_program);
     }
@@ -26,25 +27,175 @@ namespace Graphics {
     if(geometry_program != 0)
       glAttachShader(program_object, geometry_program);
 
+    //Lets the linked program be written to the program cache
+    if(isProgramBinarySupported())
+      glProgramParameteri(program_object, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glLinkProgram(program_object);
-    int is_linked = 0;
-    glGetProgramiv(program_object, GL_LINK_STATUS, &is_linked);
-    if(!is_linked)
-    {
-      int max_length = 0;
-      glGetProgramiv(program_object, GL_INFO_LOG_LENGTH, &max_length);
-      std::vector<char> info_log(max_length);
-      glGetProgramInfoLog(program_object, max_length, &max_length, &info_log[0]);
-      std::string output(info_log.begin(), info_log.end());
-      LOG(ERROR)<<output;
-      glDeleteProgram(program_object);
 
+    //Asking for the link status waits for the link, with parallel compile it's asked for once the driver is done
+    if(isParallelCompileSupported())
+      return;
+
+    if(!finishLink()) {
+      glDeleteProgram(program_object);
       throw Exceptions::InvalidShaderProgramException(program_object);
     }
     if(!glIsProgram(program_object)) {
       throw Exceptions::InvalidShaderProgramException(program_object);
     }
+  }
+
+  Shader::Shader(const GLenum binary_format, const std::vector<char>& binary) : name(""), linked(true), link_failed(false), fallback(nullptr) {
+    program_object = glCreateProgram();
+    glProgramBinary(program_object, binary_format, binary.data(), binary.size());
+
+    //Drivers reject binaries from other versions, the caller compiles the sources instead
+    int is_linked = 0;
+    glGetProgramiv(program_object, GL_LINK_STATUS, &is_linked);
+    if(!is_linked) {
+      glDeleteProgram(program_object);
+      throw Exceptions::InvalidShaderProgramException(program_object);
+    }
+
+    findUniforms();
+  }
+
+  bool Shader::isProgramBinarySupported() noexcept {
+    #ifndef __APPLE__
+      if(!GLAD_GL_ARB_get_program_binary)
+        return false;
+    #endif
+    int format_count = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+    return format_count > 0;
+  }
+
+  bool Shader::isParallelCompileSupported() noexcept {
+    #ifdef __APPLE__
+      return false;
+    #else
+      return GLAD_GL_KHR_parallel_shader_compile || GLAD_GL_ARB_parallel_shader_compile;
+    #endif
+  }
+
+  bool Shader::finishLink() {
+    linked = true;
+    int is_linked = 0;
+    glGetProgramiv(program_object, GL_LINK_STATUS, &is_linked);
+    if(!is_linked) {
+      logLinkErrors();
+      link_failed = true;
+      return false;
+    }
+
+    findUniforms();
+
+    //Values set while the program was linking
+    for(auto& uniform : queued_uniforms) {
+      if(hasUniform(uniform.first))
+        setUniform(uniform.second);
+    }
+    queued_uniforms.clear();
+    return true;
+  }
+
+  void Shader::logLinkErrors() const {
+    int max_length = 0;
+    glGetProgramiv(program_object, GL_INFO_LOG_LENGTH, &max_length);
+    if(max_length > 0) {
+      std::vector<char> info_log(max_length);
+      glGetProgramInfoLog(program_object, max_length, &max_length, &info_log[0]);
+      LOG(ERROR)<<std::string(info_log.begin(), info_log.begin() + max_length);
+    }
+
+    //Compile errors of parallel compiled stages only show up here
+    int shader_count = 0;
+    unsigned int shader_objects[3];
+    glGetAttachedShaders(program_object, 3, &shader_count, shader_objects);
+    for(int i = 0; i < shader_count; i++) {
+      int compiled = 0;
+      glGetShaderiv(shader_objects[i], GL_COMPILE_STATUS, &compiled);
+      if(compiled)
+        continue;
+      glGetShaderiv(shader_objects[i], GL_INFO_LOG_LENGTH, &max_length);
+      if(max_length > 0) {
+        std::vector<char> info_log(max_length);
+        glGetShaderInfoLog(shader_objects[i], max_length, &max_length, &info_log[0]);
+        LOG(ERROR)<<std::string(info_log.begin(), info_log.begin() + max_length);
+      }
+    }
+  }
+
+  template<class T>
+  void Shader::queueUniform(const std::string& name, const T& data) {
+    Uniform uniform;
+    uniform.setData<T>(name, data);
+    queued_uniforms[name] = uniform;
+  }
+
+  bool Shader::isReady() {
+    if(linked)
+      return !link_failed;
+
+    #ifndef __APPLE__
+      int complete = 0;
+      glGetProgramiv(program_object, GL_COMPLETION_STATUS_KHR, &complete);
+      if(!complete)
+        return false;
+    #endif
+
+    if(!finishLink())
+      LOG(ERROR)<<"Shader program "<<name<<" failed to link, its renderables draw with the fallback";
+    return !link_failed;
+  }
+
+  bool Shader::isLinked() const noexcept {
+    return linked;
+  }
+
+  bool Shader::hasUniform(const std::string& name) const noexcept {
+    return name_to_location.count(name) > 0;
+  }
+
+  int Shader::getUniformLocation(const std::string& name) const noexcept {
+    auto found = name_to_location.find(name);
+    if(found == name_to_location.end())
+      return -1;
+    return found->second;
+  }
 
+  unsigned int Shader::getUniformWriter(const int location) const noexcept {
+    if(location < 0 || (unsigned int)location >= location_writers.size())
+      return 0;
+    return location_writers[location];
+  }
+
+  void Shader::setUniformWriter(const int location, const unsigned int writer) noexcept {
+    if(location >= 0 && (unsigned int)location < location_writers.size())
+      location_writers[location] = writer;
+  }
+
+  void Shader::setFallback(std::shared_ptr<Shader> fallback) noexcept {
+    this->fallback = fallback;
+  }
+
+  std::shared_ptr<Shader> Shader::getFallback() const noexcept {
+    return fallback;
+  }
+
+  bool Shader::getBinary(GLenum& binary_format, std::vector<char>& binary) const {
+    int length = 0;
+    glGetProgramiv(program_object, GL_PROGRAM_BINARY_LENGTH, &length);
+    if(length <= 0)
+      return false;
+
+    binary.resize(length);
+    glGetProgramBinary(program_object, length, &length, &binary_format, binary.data());
+    binary.resize(length);
+    return length > 0;
+  }
+
+  void Shader::findUniforms() {
     int count = 0;
     glGetProgramiv(program_object, GL_ACTIVE_UNIFORMS, &count);
     for(int i = 0; i < count; i++) {
@@ -57,15 +208,34 @@ namespace Graphics {
       name_to_location[std::string(name)] = location;
       name_to_type[std::string(name)] = type;
       LOG(INFO)<<"Uniform found: "<<name<<" Location: "<<location;
+
+      //Arrays of basic types are only reported by their first element, register the rest by name as well
+      std::string element_name(name);
+      if(arr_size > 1 && element_name.size() > 3 && element_name.compare(element_name.size() - 3, 3, "[0]") == 0) {
+        auto base_name = element_name.substr(0, element_name.size() - 3);
+        for(int element = 1; element < arr_size; element++) {
+          auto next_name = base_name + "[" + std::to_string(element) + "]";
+          name_to_location[next_name] = glGetUniformLocation(program_object, next_name.c_str());
+          name_to_type[next_name] = type;
+        }
+      }
     }
+
+    int highest_location = -1;
+    for(auto& uniform : name_to_location)
+      highest_location = std::max(highest_location, uniform.second);
+    location_writers.assign(highest_location + 1, 0);
   }
 
   unsigned int Shader::getHandle() const noexcept {
     return program_object;
   }
 
-  void Shader::useProgram() const {
-    if(!glIsProgram(program_object)) {
+  void Shader::useProgram() {
+    //Waits for a program still linking
+    if(!linked)
+      finishLink();
+    if(link_failed || !glIsProgram(program_object)) {
       throw Exceptions::InvalidShaderProgramException(program_object);
     }
     glUseProgram(program_object);
@@ -78,334 +248,184 @@ namespace Graphics {
     return names;
   }
 
-  template<>
-  void Shader::setUniform<float>(const std::string& name, const float& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
+  template<class T, class Upload>
+  void Shader::writeUniform(const std::string& name, const T& data, Upload upload) {
+    //Set once the driver is done linking, see finishLink
+    if(!linked) {
+      queueUniform(name, data);
+      return;
+    }
+
+    auto location = name_to_location.find(name);
+    if(location == name_to_location.end()) {
       throw Exceptions::InvalidUniformNameException(name);
     }
-    if(prev_bound_program != program_object)
+    //Set by name, uniform blocks upload to the location again the next time they're applied
+    setUniformWriter(location->second, 0);
+
+    int prev_bound_program;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
+    auto switch_program = (unsigned int)prev_bound_program != program_object;
+    if(switch_program)
       useProgram();
-    glUniform1f(name_to_location[name], data);
-    if(prev_bound_program != program_object)
+    upload(location->second);
+    if(switch_program)
       glUseProgram(prev_bound_program);
   }
+
+  template<>
+  void Shader::setUniform<float>(const std::string& name, const float& data) {
+    writeUniform(name, data, [&](const int location) {
+      glUniform1f(location, data);
+    });
+  }
   template<>
   void Shader::setUniform<glm::vec2>(const std::string& name, const glm::vec2& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
-      throw Exceptions::InvalidUniformNameException(name);
-    }
-    if(prev_bound_program != program_object)
-      useProgram();
-    glUniform2fv(name_to_location[name], 1, glm::value_ptr(data));
-    if(prev_bound_program != program_object)
-      glUseProgram(prev_bound_program);
+    writeUniform(name, data, [&](const int location) {
+      glUniform2fv(location, 1, glm::value_ptr(data));
+    });
   }
   template<>
   void Shader::setUniform<glm::vec3>(const std::string& name, const glm::vec3& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
-      throw Exceptions::InvalidUniformNameException(name);
-    }
-    if(prev_bound_program != program_object)
-      useProgram();
-    glUniform3fv(name_to_location[name], 1, glm::value_ptr(data));
-    if(prev_bound_program != program_object)
-      glUseProgram(prev_bound_program);
+    writeUniform(name, data, [&](const int location) {
+      glUniform3fv(location, 1, glm::value_ptr(data));
+    });
   }
   template<>
   void Shader::setUniform<glm::vec4>(const std::string& name, const glm::vec4& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
-      throw Exceptions::InvalidUniformNameException(name);
-    }
-    if(prev_bound_program != program_object)
-      useProgram();
-    glUniform4fv(name_to_location[name], 1, glm::value_ptr(data));
-    if(prev_bound_program != program_object)
-      glUseProgram(prev_bound_program);
+    writeUniform(name, data, [&](const int location) {
+      glUniform4fv(location, 1, glm::value_ptr(data));
+    });
   }
 
   template<>
   void Shader::setUniform<int>(const std::string& name, const int& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
-      throw Exceptions::InvalidUniformNameException(name);
-    }
-    if(prev_bound_program != program_object)
-      useProgram();
-    glUniform1i(name_to_location[name], data);
-    if(prev_bound_program != program_object)
-      glUseProgram(prev_bound_program);
+    writeUniform(name, data, [&](const int location) {
+      glUniform1i(location, data);
+    });
   }
   template<>
   void Shader::setUniform<glm::ivec2>(const std::string& name, const glm::ivec2& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
-      throw Exceptions::InvalidUniformNameException(name);
-    }
-    if(prev_bound_program != program_object)
-      useProgram();
-    glUniform2iv(name_to_location[name], 1, glm::value_ptr(data));
-    if(prev_bound_program != program_object)
-      glUseProgram(prev_bound_program);
+    writeUniform(name, data, [&](const int location) {
+      glUniform2iv(location, 1, glm::value_ptr(data));
+    });
   }
   template<>
   void Shader::setUniform<glm::ivec3>(const std::string& name, const glm::ivec3& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
-      throw Exceptions::InvalidUniformNameException(name);
-    }
-    if(prev_bound_program != program_object)
-      useProgram();
-    glUniform3iv(name_to_location[name], 1, glm::value_ptr(data));
-    if(prev_bound_program != program_object)
-      glUseProgram(prev_bound_program);
+    writeUniform(name, data, [&](const int location) {
+      glUniform3iv(location, 1, glm::value_ptr(data));
+    });
   }
   template<>
   void Shader::setUniform<glm::ivec4>(const std::string& name, const glm::ivec4& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
-      throw Exceptions::InvalidUniformNameException(name);
-    }
-    if(prev_bound_program != program_object)
-      useProgram();
-    glUniform4iv(name_to_location[name], 1, glm::value_ptr(data));
-    if(prev_bound_program != program_object)
-      glUseProgram(prev_bound_program);
+    writeUniform(name, data, [&](const int location) {
+      glUniform4iv(location, 1, glm::value_ptr(data));
+    });
   }
 
   template<>
   void Shader::setUniform<unsigned int>(const std::string& name, const unsigned int& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
-      throw Exceptions::InvalidUniformNameException(name);
-    }
-    if(prev_bound_program != program_object)
-      useProgram();
-    glUniform1ui(name_to_location[name], data);
-    if(prev_bound_program != program_object)
-      glUseProgram(prev_bound_program);
+    writeUniform(name, data, [&](const int location) {
+      glUniform1ui(location, data);
+    });
   }
   template<>
   void Shader::setUniform<glm::uvec2>(const std::string& name, const glm::uvec2& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
-      throw Exceptions::InvalidUniformNameException(name);
-    }
-    if(prev_bound_program != program_object)
-      useProgram();
-    glUniform2uiv(name_to_location[name], 1, glm::value_ptr(data));
-    if(prev_bound_program != program_object)
-      glUseProgram(prev_bound_program);
+    writeUniform(name, data, [&](const int location) {
+      glUniform2uiv(location, 1, glm::value_ptr(data));
+    });
   }
   template<>
   void Shader::setUniform<glm::uvec3>(const std::string& name, const glm::uvec3& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
-      throw Exceptions::InvalidUniformNameException(name);
-    }
-    if(prev_bound_program != program_object)
-      useProgram();
-    glUniform3uiv(name_to_location[name], 1, glm::value_ptr(data));
-    if(prev_bound_program != program_object)
-      glUseProgram(prev_bound_program);
+    writeUniform(name, data, [&](const int location) {
+      glUniform3uiv(location, 1, glm::value_ptr(data));
+    });
   }
   template<>
   void Shader::setUniform<glm::uvec4>(const std::string& name, const glm::uvec4& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
-      throw Exceptions::InvalidUniformNameException(name);
-    }
-    if(prev_bound_program != program_object)
-      useProgram();
-    glUniform4uiv(name_to_location[name], 1, glm::value_ptr(data));
-    if(prev_bound_program != program_object)
-      glUseProgram(prev_bound_program);
+    writeUniform(name, data, [&](const int location) {
+      glUniform4uiv(location, 1, glm::value_ptr(data));
+    });
   }
 
   template<>
   void Shader::setUniform<bool>(const std::string& name, const bool& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
-      throw Exceptions::InvalidUniformNameException(name);
-    }
-    if(prev_bound_program != program_object)
-      useProgram();
-    glUniform1i(name_to_location[name], data);
-    if(prev_bound_program != program_object)
-      glUseProgram(prev_bound_program);
+    writeUniform(name, data, [&](const int location) {
+      glUniform1i(location, data);
+    });
   }
   template<>
   void Shader::setUniform<glm::bvec2>(const std::string& name, const glm::bvec2& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
-      throw Exceptions::InvalidUniformNameException(name);
-    }
-    if(prev_bound_program != program_object)
-      useProgram();
-    glUniform2iv(name_to_location[name], 1, glm::value_ptr(glm::ivec2(data)));
-    if(prev_bound_program != program_object)
-      glUseProgram(prev_bound_program);
+    writeUniform(name, data, [&](const int location) {
+      glUniform2iv(location, 1, glm::value_ptr(glm::ivec2(data)));
+    });
   }
   template<>
   void Shader::setUniform<glm::bvec3>(const std::string& name, const glm::bvec3& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
-      throw Exceptions::InvalidUniformNameException(name);
-    }
-    if(prev_bound_program != program_object)
-      useProgram();
-    glUniform3iv(name_to_location[name], 1, glm::value_ptr(glm::ivec3(data)));
-    if(prev_bound_program != program_object)
-      glUseProgram(prev_bound_program);
+    writeUniform(name, data, [&](const int location) {
+      glUniform3iv(location, 1, glm::value_ptr(glm::ivec3(data)));
+    });
   }
   template<>
   void Shader::setUniform<glm::bvec4>(const std::string& name, const glm::bvec4& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
-      throw Exceptions::InvalidUniformNameException(name);
-    }
-    if(prev_bound_program != program_object)
-      useProgram();
-    glUniform4iv(name_to_location[name], 1, glm::value_ptr(glm::ivec4(data)));
-    if(prev_bound_program != program_object)
-      glUseProgram(prev_bound_program);
+    writeUniform(name, data, [&](const int location) {
+      glUniform4iv(location, 1, glm::value_ptr(glm::ivec4(data)));
+    });
   }
 
   template<>
   void Shader::setUniform<glm::mat2>(const std::string& name, const glm::mat2& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
-      throw Exceptions::InvalidUniformNameException(name);
-    }
-    if(prev_bound_program != program_object)
-      useProgram();
-    glUniformMatrix2fv(name_to_location[name], 1, false, glm::value_ptr(data));
-    if(prev_bound_program != program_object)
-      glUseProgram(prev_bound_program);
+    writeUniform(name, data, [&](const int location) {
+      glUniformMatrix2fv(location, 1, false, glm::value_ptr(data));
+    });
   }
   template<>
   void Shader::setUniform<glm::mat3>(const std::string& name, const glm::mat3& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
-      throw Exceptions::InvalidUniformNameException(name);
-    }
-    if(prev_bound_program != program_object)
-      useProgram();
-    glUniformMatrix3fv(name_to_location[name], 1, false, glm::value_ptr(data));
-    if(prev_bound_program != program_object)
-      glUseProgram(prev_bound_program);
+    writeUniform(name, data, [&](const int location) {
+      glUniformMatrix3fv(location, 1, false, glm::value_ptr(data));
+    });
   }
   template<>
   void Shader::setUniform<glm::mat4>(const std::string& name, const glm::mat4& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
-      throw Exceptions::InvalidUniformNameException(name);
-    }
-    if(prev_bound_program != program_object)
-      useProgram();
-    glUniformMatrix4fv(name_to_location[name], 1, false, glm::value_ptr(data));
-    if(prev_bound_program != program_object)
-      glUseProgram(prev_bound_program);
+    writeUniform(name, data, [&](const int location) {
+      glUniformMatrix4fv(location, 1, false, glm::value_ptr(data));
+    });
   }
   template<>
   void Shader::setUniform<glm::mat2x3>(const std::string& name, const glm::mat2x3& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
-      throw Exceptions::InvalidUniformNameException(name);
-    }
-    if(prev_bound_program != program_object)
-      useProgram();
-    glUniformMatrix2x3fv(name_to_location[name], 1, false, glm::value_ptr(data));
-    if(prev_bound_program != program_object)
-      glUseProgram(prev_bound_program);
+    writeUniform(name, data, [&](const int location) {
+      glUniformMatrix2x3fv(location, 1, false, glm::value_ptr(data));
+    });
   }
   template<>
   void Shader::setUniform<glm::mat3x2>(const std::string& name, const glm::mat3x2& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
-      throw Exceptions::InvalidUniformNameException(name);
-    }
-    if(prev_bound_program != program_object)
-      useProgram();
-    glUniformMatrix3x2fv(name_to_location[name], 1, false, glm::value_ptr(data));
-    if(prev_bound_program != program_object)
-      glUseProgram(prev_bound_program);
+    writeUniform(name, data, [&](const int location) {
+      glUniformMatrix3x2fv(location, 1, false, glm::value_ptr(data));
+    });
   }
   template<>
   void Shader::setUniform<glm::mat2x4>(const std::string& name, const glm::mat2x4& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
-      throw Exceptions::InvalidUniformNameException(name);
-    }
-    if(prev_bound_program != program_object)
-      useProgram();
-    glUniformMatrix2x4fv(name_to_location[name], 1, false, glm::value_ptr(data));
-    if(prev_bound_program != program_object)
-      glUseProgram(prev_bound_program);
+    writeUniform(name, data, [&](const int location) {
+      glUniformMatrix2x4fv(location, 1, false, glm::value_ptr(data));
+    });
   }
   template<>
   void Shader::setUniform<glm::mat4x2>(const std::string& name, const glm::mat4x2& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
-      throw Exceptions::InvalidUniformNameException(name);
-    }
-    if(prev_bound_program != program_object)
-      useProgram();
-    glUniformMatrix4x2fv(name_to_location[name], 1, false, glm::value_ptr(data));
-    if(prev_bound_program != program_object)
-      glUseProgram(prev_bound_program);
+    writeUniform(name, data, [&](const int location) {
+      glUniformMatrix4x2fv(location, 1, false, glm::value_ptr(data));
+    });
   }
   template<>
   void Shader::setUniform<glm::mat3x4>(const std::string& name, const glm::mat3x4& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
-      throw Exceptions::InvalidUniformNameException(name);
-    }
-    if(prev_bound_program != program_object)
-      useProgram();
-    glUniformMatrix3x4fv(name_to_location[name], 1, false, glm::value_ptr(data));
-    if(prev_bound_program != program_object)
-      glUseProgram(prev_bound_program);
+    writeUniform(name, data, [&](const int location) {
+      glUniformMatrix3x4fv(location, 1, false, glm::value_ptr(data));
+    });
   }
   template<>
   void Shader::setUniform<glm::mat4x3>(const std::string& name, const glm::mat4x3& data) {
-    int prev_bound_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &prev_bound_program);
-    if(name_to_location.count(name) == 0) {
-      throw Exceptions::InvalidUniformNameException(name);
-    }
-    if(prev_bound_program != program_object)
-      useProgram();
-    glUniformMatrix4x3fv(name_to_location[name], 1, false, glm::value_ptr(data));
-    if(prev_bound_program != program_object)
-      glUseProgram(prev_bound_program);
+    writeUniform(name, data, [&](const int location) {
+      glUniformMatrix4x3fv(location, 1, false, glm::value_ptr(data));
+    });
   }
 
   void Shader::setUniform(const Uniform& uniform) {
@@ -417,7 +437,7 @@ namespace Graphics {
         setUniform(uniform.getName(), uniform.getData<glm::vec2>());
         break;
       case Graphics::Uniform::UniformTypes::VEC3:
-        setUniform(uniform.getName(), uniform.getData<glm::vec2>());
+        setUniform(uniform.getName(), uniform.getData<glm::vec3>());
         break;
       case Graphics::Uniform::UniformTypes::VEC4:
         setUniform(uniform.getName(), uniform.getData<glm::vec4>());
@@ -1,7 +1,9 @@
 #ifndef SHADER_H
 #define SHADER_H
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 #ifdef __APPLE__
 #include <OpenGL/gl3.h>
 #else
@@ -19,6 +21,24 @@ namespace Graphics {
       std::map<std::string, int> name_to_location;
       std::map<std::string, GLenum> name_to_type;
       std::string name;
+
+      //False while the driver links in parallel, see isReady
+      bool linked;
+      bool link_failed;
+      std::map<std::string, Uniform> queued_uniforms;
+      std::shared_ptr<Shader> fallback;
+      //The uniform block that last set each location, 0 when set by name
+      std::vector<unsigned int> location_writers;
+
+      void findUniforms();
+      bool finishLink();
+      void logLinkErrors() const;
+      template<class T>
+      void queueUniform(const std::string& name, const T& data);
+      //Looks up a uniform set by name and calls upload with its location while the program is in use,
+      //queues the data instead while the program is still linking
+      template<class T, class Upload>
+      void writeUniform(const std::string& name, const T& data, Upload upload);
     public:
       Shader() = delete;
       /**
@@ -29,6 +49,96 @@ namespace Graphics {
        * @param[in]  geometry_program  The geometry program
        */
       Shader(const unsigned int vertex_program, const unsigned int fragment_program, const unsigned int geometry_program = 0);
+      /**
+       * @brief      Shader constructor from a program binary
+       *
+       * @param[in]  binary_format  The binary format, from getBinary
+       * @param[in]  binary         The binary
+       */
+      Shader(const GLenum binary_format, const std::vector<char>& binary);
+
+      /**
+       * @brief      Determines if the driver compiles and links in the background.
+       *
+       * @detail     With GL_KHR_parallel_shader_compile shaders don't wait for the link when they're
+       * created, they link while isReady returns false.
+       *
+       * @return     True if parallel compile is supported, False otherwise.
+       */
+      static bool isParallelCompileSupported() noexcept;
+      /**
+       * @brief      Determines if the program is linked and can be used without waiting.
+       *
+       * @detail     Uniforms set before then are kept and set once the program links.
+       *
+       * @return     True if ready, False while linking or if linking failed.
+       */
+      bool isReady();
+      /**
+       * @brief      Determines if linking finished, checked by isReady.
+       *
+       * @return     True once linked or failed, False while linking.
+       */
+      bool isLinked() const noexcept;
+      /**
+       * @brief      Determines if the program has a uniform.
+       *
+       * @param[in]  name  The name
+       *
+       * @return     True if the uniform is active, False otherwise or while linking.
+       */
+      bool hasUniform(const std::string& name) const noexcept;
+      /**
+       * @brief      Gets the location of a uniform.
+       *
+       * @param[in]  name  The name
+       *
+       * @return     The location, -1 if the uniform isn't active or the program is linking.
+       */
+      int getUniformLocation(const std::string& name) const noexcept;
+      /**
+       * @brief      Gets the uniform block whose value a location holds.
+       *
+       * @param[in]  location  The location
+       *
+       * @return     The block id, 0 if the value was set by name or never set.
+       */
+      unsigned int getUniformWriter(const int location) const noexcept;
+      /**
+       * @brief      Records the uniform block that set a location.
+       *
+       * @param[in]  location  The location
+       * @param[in]  writer    The block id
+       */
+      void setUniformWriter(const int location, const unsigned int writer) noexcept;
+      /**
+       * @brief      Sets the shader renderables draw with until this one is ready.
+       *
+       * @param[in]  fallback  The fallback, taking the same vertices, nullptr to skip drawing
+       */
+      [[scriptable]] void setFallback(std::shared_ptr<Shader> fallback) noexcept;
+      /**
+       * @brief      Gets the fallback.
+       *
+       * @return     The fallback, nullptr if there isn't one.
+       */
+      [[scriptable]] std::shared_ptr<Shader> getFallback() const noexcept;
+
+      /**
+       * @brief      Determines if the driver can save and load program binaries.
+       *
+       * @return     True if program binaries are supported, False otherwise.
+       */
+      static bool isProgramBinarySupported() noexcept;
+      /**
+       * @brief      Gets the linked program as a binary.
+       *
+       * @param[out] binary_format  The binary format
+       * @param[out] binary         The binary
+       *
+       * @return     True if the driver returned a binary, False otherwise.
+       */
+      bool getBinary(GLenum& binary_format, std::vector<char>& binary) const;
 
       /**
        * @brief      Gets the shader's opengl handle.
@@ -37,9 +147,9 @@ namespace Graphics {
        */
       unsigned int getHandle() const noexcept;
       /**
-       * @brief      Tell open gl to use this shader
+       * @brief      Tell open gl to use this shader, waits for it if it's still linking
        */
-      void useProgram() const;
+      void useProgram();
 
       /**
        * @brief      Gets the uniform names.
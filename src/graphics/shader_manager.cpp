@@ -1,5 +1,7 @@
 #include <easylogging++.h>
+#include <algorithm>
 #include <fstream>
+#include <sstream>
 #ifdef __APPLE__
 #include <OpenGL/gl3.h>
 #else
@@ -18,7 +20,7 @@ namespace Graphics {
   char const* ShaderManager::GEOMETRY_EXTENSION = ".geom";
   char const* ShaderManager::SHADER_DIRECTORY = "./shaders/";
 
-  ShaderManager::ShaderManager() {
+  ShaderManager::ShaderManager() : program_cache_path("") {
 
   }
 
@@ -35,108 +37,255 @@ namespace Graphics {
   }
 
   bool ShaderManager::loadShader(const std::string& name, const std::string& vertex_filename, const std::string& fragment_filename, const std::string& geometry_filename) {
-    std::ifstream vertex_file;
-    if(vertex_filename != "") {
-      vertex_file.open((SHADER_DIRECTORY + vertex_filename).c_str(), std::ios_base::binary);
+    return loadShader(name, vertex_filename, fragment_filename, geometry_filename, "");
+  }
+
+  std::string ShaderManager::injectDefines(const std::string& source, const std::string& defines) {
+    std::stringstream define_lines;
+    std::stringstream names(defines);
+    std::string define;
+    while(names >> define) {
+      auto value = define.find('=');
+      if(value != std::string::npos)
+        define[value] = ' ';
+      define_lines << "#define " << define << "\n";
     }
-    std::ifstream fragment_file;
-    if(fragment_filename != "")
-      fragment_file.open((SHADER_DIRECTORY + fragment_filename).c_str(), std::ios_base::binary);
-    std::ifstream geometry_file;
-    if(geometry_filename != "") {
-      geometry_file.open((SHADER_DIRECTORY + geometry_filename).c_str(), std::ios_base::binary);
+
+    //#version has to stay the first line
+    auto version_end = source.find('\n', source.find("#version"));
+    if(version_end == std::string::npos)
+      return define_lines.str() + source;
+    return source.substr(0, version_end + 1) + define_lines.str() + source.substr(version_end + 1);
+  }
+
+  std::string ShaderManager::readSource(const std::string& filename, const std::string& defines) {
+    std::ifstream file((SHADER_DIRECTORY + filename).c_str(), std::ios_base::binary);
+    if(!file.is_open()) {
+      throw Exceptions::InvalidFilenameException(filename);
+    }
+    LOG(INFO)<<filename<<" shader file loaded.";
+
+    std::string source;
+    file.seekg(0, std::ios::end);
+    source.reserve(file.tellg());
+    file.seekg(0, std::ios::beg);
+    source.assign((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return injectDefines(source, defines);
+  }
+
+  unsigned int ShaderManager::compileShader(const GLenum type, const std::string& source, const std::string& filename) {
+    unsigned int shader_object = glCreateShader(type);
+    const char* source_string = source.c_str();
+    int source_length = source.size();
+    glShaderSource(shader_object, 1, &source_string, &source_length);
+    glCompileShader(shader_object);
+
+    //Asking for the compile status waits for the compile, with parallel compile errors are logged when the program links
+    if(!Shader::isParallelCompileSupported() && !checkCompilation(shader_object)) {
+      logShaderInfoLog(shader_object);
+      glDeleteShader(shader_object);
+      throw Exceptions::ShaderCompilationException(filename);
+    }
+    return shader_object;
+  }
+
+  bool ShaderManager::loadShader(const std::string& name, const std::string& vertex_filename, const std::string& fragment_filename, const std::string& geometry_filename, const std::string& defines) {
+    std::string vertex_source = vertex_filename != "" ? readSource(vertex_filename, defines) : "";
+    std::string fragment_source = fragment_filename != "" ? readSource(fragment_filename, defines) : "";
+    std::string geometry_source = geometry_filename != "" ? readSource(geometry_filename, defines) : "";
+
+    //A program linked on an earlier launch from the same sources and driver skips compiling
+    auto cache_key = hashProgram(vertex_source, fragment_source, geometry_source);
+    auto cached_shader = loadProgramCache(name, cache_key);
+    if(cached_shader != nullptr) {
+      shaders_to_names[name] = cached_shader;
+      return true;
     }
 
     unsigned int vertex_shader = 0;
     unsigned int fragment_shader = 0;
     unsigned int geometry_shader = 0;
 
-    if(vertex_filename != "" && !vertex_file.is_open()) {
-      throw Exceptions::InvalidFilenameException(vertex_filename);
+    if(vertex_filename != "")
+      vertex_shader = compileShader(GL_VERTEX_SHADER, vertex_source, vertex_filename);
+    if(fragment_filename != "")
+      fragment_shader = compileShader(GL_FRAGMENT_SHADER, fragment_source, fragment_filename);
+    if(geometry_filename != "")
+      geometry_shader = compileShader(GL_GEOMETRY_SHADER, geometry_source, geometry_filename);
+
+    std::shared_ptr<Shader> shader = nullptr;
+    try {
+      shader = std::make_shared<Shader>(vertex_shader, fragment_shader, geometry_shader);
     }
-    else if(vertex_filename != "" && vertex_file.is_open()) {
-      LOG(INFO)<<vertex_filename<<" shader file loaded.";
-      vertex_shader = glCreateShader(GL_VERTEX_SHADER);
-      const char *vc_str;
-      std::string vertex_string;
-      vertex_file.seekg(0, std::ios::end);
-      vertex_string.reserve(vertex_file.tellg());
-      vertex_file.seekg(0, std::ios::beg);
-
-      vertex_string.assign((std::istreambuf_iterator<char>(vertex_file)),
-                            std::istreambuf_iterator<char>());
-      vertex_file.close();
-
-      vc_str = vertex_string.c_str();
-
-      glShaderSource(vertex_shader, 1, &vc_str, new int[1] {(int)vertex_string.size()});
-      glCompileShader(vertex_shader);
-
-      if(!checkCompilation(vertex_shader)) {
-        logShaderInfoLog(vertex_shader);
-        throw Exceptions::ShaderCompilationException(vertex_filename);
-      }
+    catch(std::exception& e) {
+      LOG(ERROR)<<e.what();
     }
-    if(fragment_filename != "" && !fragment_file.is_open()) {
-      throw Exceptions::InvalidFilenameException(fragment_filename);
+
+    //The program keeps what it needs once linked
+    for(auto shader_object : {vertex_shader, fragment_shader, geometry_shader}) {
+      if(shader_object != 0)
+        glDeleteShader(shader_object);
     }
-    else if(fragment_filename != "" && fragment_file.is_open()) {
-      LOG(INFO)<<fragment_filename<<" shader file loaded.";
-      fragment_shader = glCreateShader(GL_FRAGMENT_SHADER);
-      const char *fc_str;
-      std::string fragment_string;
-      fragment_file.seekg(0, std::ios::end);
-      fragment_string.reserve(fragment_file.tellg());
-      fragment_file.seekg(0, std::ios::beg);
-
-      fragment_string.assign((std::istreambuf_iterator<char>(fragment_file)),
-                              std::istreambuf_iterator<char>());
-      fragment_file.close();
-
-      fc_str = fragment_string.c_str();
-
-      glShaderSource(fragment_shader, 1, &fc_str, new int[1] {(int)fragment_string.size()});
-      glCompileShader(fragment_shader);
-      if(!checkCompilation(fragment_shader)) {
-        logShaderInfoLog(fragment_shader);
-        throw Exceptions::ShaderCompilationException(fragment_filename);
+
+    if(shader == nullptr)
+      return false;
+
+    shaders_to_names[name] = shader;
+    //A program still linking is saved once it's done
+    unsaved_programs[name] = cache_key;
+    savePendingPrograms();
+    return true;
+  }
+
+  void ShaderManager::savePendingPrograms() {
+    for(auto program = unsaved_programs.begin(); program != unsaved_programs.end();) {
+      auto shader = shaders_to_names.at(program->first);
+      if(shader->isReady()) {
+        saveProgramCache(program->first, program->second, *shader);
+      }
+      else if(!shader->isLinked()) {
+        program++;
+        continue;
       }
+      program = unsaved_programs.erase(program);
     }
-    if(geometry_filename != "" && !geometry_file.is_open()) {
-      throw Exceptions::InvalidFilenameException(geometry_filename);
+  }
+
+  void ShaderManager::setFallbackShader(const std::string& name, const std::string& fallback_name) {
+    getShader(name)->setFallback(getShader(fallback_name));
+  }
+
+  void ShaderManager::setVariantBase(const std::string& base_name, const std::string& vertex_filename, const std::string& fragment_filename, const std::string& geometry_filename) {
+    auto& base = variant_bases[base_name];
+    base.vertex_filename = vertex_filename;
+    base.fragment_filename = fragment_filename;
+    base.geometry_filename = geometry_filename;
+  }
+
+  void ShaderManager::setVariantFallback(const std::string& base_name, const std::string& fallback_name) {
+    if(variant_bases.count(base_name) == 0)
+      setVariantBase(base_name, base_name + VERTEX_EXTENSION, base_name + FRAGMENT_EXTENSION, "");
+    variant_bases[base_name].fallback_name = fallback_name;
+  }
+
+  std::string ShaderManager::getVariantName(const std::string& base_name, const std::string& defines) {
+    std::vector<std::string> sorted_defines;
+    std::stringstream names(defines);
+    std::string define;
+    while(names >> define)
+      sorted_defines.push_back(define);
+    std::sort(sorted_defines.begin(), sorted_defines.end());
+    sorted_defines.erase(std::unique(sorted_defines.begin(), sorted_defines.end()), sorted_defines.end());
+
+    std::string name = base_name;
+    for(auto& sorted_define : sorted_defines)
+      name += "." + sorted_define;
+    return name;
+  }
+
+  std::shared_ptr<Shader> ShaderManager::getVariant(const std::string& base_name, const std::string& defines) {
+    auto name = getVariantName(base_name, defines);
+    auto found = shaders_to_names.find(name);
+    if(found != shaders_to_names.end())
+      return found->second;
+
+    VariantBase base = {base_name + VERTEX_EXTENSION, base_name + FRAGMENT_EXTENSION, "", ""};
+    if(variant_bases.count(base_name) > 0)
+      base = variant_bases.at(base_name);
+
+    if(!loadShader(name, base.vertex_filename, base.fragment_filename, base.geometry_filename, defines))
+      throw Exceptions::InvalidShaderNameException(name);
+
+    //The variant is cached before its fallback is looked up, so fallbacks can't loop
+    auto shader = shaders_to_names.at(name);
+    if(base.fallback_name != "")
+      shader->setFallback(getVariant(base.fallback_name, defines));
+    return shader;
+  }
+
+  unsigned long long ShaderManager::hashProgram(const std::string& vertex_source, const std::string& fragment_source, const std::string& geometry_source) {
+    //Binaries only load on the driver that made them
+    std::string driver;
+    for(auto parameter : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+      auto value = glGetString(parameter);
+      if(value != nullptr)
+        driver += std::string((const char*)value) + "\n";
     }
-    else if(geometry_filename != "" && geometry_file.is_open()) {
-      LOG(INFO)<<geometry_filename<<" shader file loaded.";
-      geometry_shader = glCreateShader(GL_GEOMETRY_SHADER);
-      const char *gc_str;
-      std::string geometry_string;
-      geometry_file.seekg(0, geometry_file.end);
-      geometry_string.reserve(geometry_file.tellg());
-      geometry_file.seekg(0, geometry_file.beg);
-
-      geometry_string.assign((std::istreambuf_iterator<char>(geometry_file)),
-                              std::istreambuf_iterator<char>());
-      geometry_file.close();
-
-      gc_str = geometry_string.c_str();
-
-      glShaderSource(geometry_shader, 1, &gc_str, new int[1] {(int)geometry_string.size()});
-      glCompileShader(geometry_shader);
-      if(!checkCompilation(geometry_shader)) {
-        logShaderInfoLog(geometry_shader);
-        throw Exceptions::ShaderCompilationException(geometry_filename);
+
+    //FNV-1a, the same as the glyph caches, with a separator so moving text between stages changes the key
+    unsigned long long hash = 14695981039346656037ULL;
+    const std::string* parts[] = {&vertex_source, &fragment_source, &geometry_source, &driver};
+    for(auto part : parts) {
+      for(auto byte : *part) {
+        hash ^= (unsigned char)byte;
+        hash *= 1099511628211ULL;
       }
+      hash ^= 0xFF;
+      hash *= 1099511628211ULL;
+    }
+    return hash;
+  }
+
+  std::string ShaderManager::getProgramCacheFile(const std::string& name) const {
+    return program_cache_path + name + ".program";
+  }
+
+  std::shared_ptr<Shader> ShaderManager::loadProgramCache(const std::string& name, const unsigned long long key) {
+    if(program_cache_path == "" || !Shader::isProgramBinarySupported())
+      return nullptr;
+
+    std::ifstream file(getProgramCacheFile(name), std::ios::binary);
+    if(!file)
+      return nullptr;
+
+    unsigned int header[3];
+    unsigned long long cached_key;
+    if(!file.read((char*)header, sizeof(header)) || !file.read((char*)&cached_key, sizeof(cached_key)))
+      return nullptr;
+    if(header[0] != PROGRAM_CACHE_MAGIC || cached_key != key) {
+      LOG(INFO)<<"Program cache for "<<name<<" is out of date";
+      return nullptr;
     }
 
+    std::vector<char> binary(header[2]);
+    if(!file.read(binary.data(), binary.size()))
+      return nullptr;
+
     try {
-      shaders_to_names[name] = std::make_shared<Shader>(vertex_shader, fragment_shader, geometry_shader);
+      auto shader = std::make_shared<Shader>((GLenum)header[1], binary);
+      LOG(INFO)<<"Program "<<name<<" loaded from the program cache.";
+      return shader;
     }
     catch(std::exception& e) {
-      LOG(ERROR)<<e.what();
-      return false;
+      LOG(INFO)<<"Program cache for "<<name<<" was rejected by the driver, compiling";
+      return nullptr;
     }
+  }
 
-    return true;
+  void ShaderManager::saveProgramCache(const std::string& name, const unsigned long long key, const Shader& shader) {
+    if(program_cache_path == "" || !Shader::isProgramBinarySupported())
+      return;
+
+    GLenum binary_format;
+    std::vector<char> binary;
+    if(!shader.getBinary(binary_format, binary))
+      return;
+
+    std::ofstream file(getProgramCacheFile(name), std::ios::binary | std::ios::trunc);
+    unsigned int header[3] = {PROGRAM_CACHE_MAGIC, (unsigned int)binary_format, (unsigned int)binary.size()};
+    file.write((const char*)header, sizeof(header));
+    file.write((const char*)&key, sizeof(key));
+    file.write(binary.data(), binary.size());
+    if(!file)
+      LOG(WARNING)<<"Could not write program cache: "<<getProgramCacheFile(name);
+  }
+
+  void ShaderManager::setProgramCachePath(const std::string& path) noexcept {
+    program_cache_path = path;
+  }
+
+  std::string ShaderManager::getProgramCachePath() const noexcept {
+    return program_cache_path;
   }
 
   std::shared_ptr<Shader> ShaderManager::operator[](const std::string& name) const {
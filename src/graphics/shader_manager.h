@@ -13,8 +13,33 @@ namespace Graphics {
   class [[scriptable]] ShaderManager {
     private:
       std::map<std::string, std::shared_ptr<Shader>> shaders_to_names;
+      std::string program_cache_path;
+      //Programs to save to the program cache once linked, to their cache key
+      std::map<std::string, unsigned long long> unsaved_programs;
+
+      /**
+       * @brief      Source files and fallback of a shader variants are compiled from
+       */
+      struct VariantBase {
+        std::string vertex_filename;
+        std::string fragment_filename;
+        std::string geometry_filename;
+        std::string fallback_name;
+      };
+      std::map<std::string, VariantBase> variant_bases;
+
+      static const unsigned int PROGRAM_CACHE_MAGIC = 0x4E505231;
+
       bool checkCompilation(const unsigned int& shader_object);
       void logShaderInfoLog(const unsigned int& shader_object);
+      static std::string injectDefines(const std::string& source, const std::string& defines);
+      std::string readSource(const std::string& filename, const std::string& defines);
+      unsigned int compileShader(const GLenum type, const std::string& source, const std::string& filename);
+
+      static unsigned long long hashProgram(const std::string& vertex_source, const std::string& fragment_source, const std::string& geometry_source);
+      std::string getProgramCacheFile(const std::string& name) const;
+      std::shared_ptr<Shader> loadProgramCache(const std::string& name, const unsigned long long key);
+      void saveProgramCache(const std::string& name, const unsigned long long key, const Shader& shader);
     public:
       /**
        * Vertex Shader Extension
@@ -62,6 +87,18 @@ namespace Graphics {
        * @return     True if successful
        */
       [[scriptable]] bool loadShader(const std::string& name, const std::string& vertex_filename, const std::string& fragment_filename, const std::string& geometry_filename);
+      /**
+       * @brief      Loads a shader compiled with extra defines.
+       *
+       * @param[in]  name               The name
+       * @param[in]  vertex_filename    The vertex filename
+       * @param[in]  fragment_filename  The fragment filename
+       * @param[in]  geometry_filename  The geometry filename
+       * @param[in]  defines            Space separated names, or NAME=VALUE, defined in every stage after the #version line
+       *
+       * @return     True if successful
+       */
+      [[scriptable]] bool loadShader(const std::string& name, const std::string& vertex_filename, const std::string& fragment_filename, const std::string& geometry_filename, const std::string& defines);
 
       /**
        * @brief      looks up shader by name
@@ -80,6 +117,78 @@ namespace Graphics {
        */
       [[scriptable]] std::shared_ptr<Shader> getShader(const std::string& name) const;
 
+      /**
+       * @brief      Sets where linked programs are cached between launches.
+       *
+       * @detail     Programs are saved as driver binaries keyed by a hash of their sources and the
+       * driver, and loaded instead of compiling while both match. A binary the driver rejects is
+       * compiled from source and saved again.
+       *
+       * @param[in]  path  The directory, with a trailing slash, "" to always compile
+       */
+      [[scriptable]] void setProgramCachePath(const std::string& path) noexcept;
+      /**
+       * @brief      Gets where linked programs are cached.
+       *
+       * @return     The program cache directory, "" if programs aren't cached.
+       */
+      [[scriptable]] std::string getProgramCachePath() const noexcept;
+      /**
+       * @brief      Saves programs that finished linking to the program cache.
+       *
+       * @detail     Shaders are loaded without waiting for their link when the driver compiles in
+       * parallel, this is called every frame to save them once they're done.
+       */
+      void savePendingPrograms();
+
+      /**
+       * @brief      Sets the shader drawn with while a shader is still linking.
+       *
+       * @param[in]  name           The name of the shader
+       * @param[in]  fallback_name  The name of the fallback, it has to take the same vertices
+       */
+      [[scriptable]] void setFallbackShader(const std::string& name, const std::string& fallback_name);
+
+      /**
+       * @brief      Sets the source files variants of a shader are compiled from.
+       *
+       * @detail     Without this a variant of name is compiled from name.vert and name.frag.
+       *
+       * @param[in]  base_name          The name variants are requested with
+       * @param[in]  vertex_filename    The vertex filename
+       * @param[in]  fragment_filename  The fragment filename
+       * @param[in]  geometry_filename  The geometry filename, "" for none
+       */
+      [[scriptable]] void setVariantBase(const std::string& base_name, const std::string& vertex_filename, const std::string& fragment_filename, const std::string& geometry_filename);
+      /**
+       * @brief      Sets the shader variants of a shader draw with while they're still linking.
+       *
+       * @param[in]  base_name      The name variants are requested with
+       * @param[in]  fallback_name  The base name of the fallback, its variant with the same defines is used
+       */
+      [[scriptable]] void setVariantFallback(const std::string& base_name, const std::string& fallback_name);
+      /**
+       * @brief      Gets a variant of a shader, compiling it the first time it's asked for.
+       *
+       * @detail     Variants are cached by their base name and defines, so the order the defines
+       * are given in doesn't matter. A define can have a value as NAME=VALUE.
+       *
+       * @param[in]  base_name  The base name
+       * @param[in]  defines    Space separated defines
+       *
+       * @return     The variant.
+       */
+      [[scriptable]] std::shared_ptr<Shader> getVariant(const std::string& base_name, const std::string& defines);
+      /**
+       * @brief      Gets the name a variant is cached under.
+       *
+       * @param[in]  base_name  The base name
+       * @param[in]  defines    Space separated defines
+       *
+       * @return     The base name followed by the sorted defines, split by '.'.
+       */
+      static std::string getVariantName(const std::string& base_name, const std::string& defines);
+
       /**
        * @brief      Sets the uniform for all programs.
        *
@@ -0,0 +1,175 @@
+#include <easylogging++.h>
+#include <cstring>
+#include <stdexcept>
+#include "streaming_buffer.h"
+
+namespace Graphics {
+  StreamingBuffer::StreamingBuffer(const GLenum target, const unsigned int segment_size, const unsigned int segment_count) :
+    target(target), buffer(nullptr), segment_size(segment_size), segment_count(segment_count > 0 ? segment_count : 1),
+    current_segment(0), segment_head(0), fences(this->segment_count, nullptr), persistent(false), persistent_data(nullptr) {
+    createStorage();
+  }
+
+  StreamingBuffer::~StreamingBuffer() {
+    destroyStorage();
+  }
+
+  void StreamingBuffer::createStorage() {
+    buffer = GPUResourceRegistry::create(GPUResourceType::BUFFER);
+    glBindBuffer(target, buffer->getObject());
+
+    auto total_size = (GLsizeiptr)segment_size * segment_count;
+    buffer->setBytes(total_size);
+    persistent = false;
+    persistent_data = nullptr;
+
+    #ifndef __APPLE__
+      if(GLAD_GL_ARB_buffer_storage) {
+        auto flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(target, total_size, nullptr, flags);
+        persistent_data = (unsigned char*)glMapBufferRange(target, 0, total_size, flags);
+        persistent = persistent_data != nullptr;
+      }
+    #endif
+
+    if(!persistent)
+      glBufferData(target, total_size, nullptr, GL_STREAM_DRAW);
+
+    glBindBuffer(target, 0);
+  }
+
+  void StreamingBuffer::destroyStorage() {
+    for(auto& fence : fences) {
+      if(fence != nullptr)
+        glDeleteSync(fence);
+      fence = nullptr;
+    }
+
+    if(persistent) {
+      glBindBuffer(target, buffer->getObject());
+      glUnmapBuffer(target);
+      glBindBuffer(target, 0);
+    }
+
+    //Deleted at the end of the frame, draws of this frame may still read it
+    buffer.reset();
+    persistent_data = nullptr;
+  }
+
+  void StreamingBuffer::waitForSegment(const unsigned int segment) {
+    auto& fence = fences[segment];
+    if(fence == nullptr)
+      return;
+
+    GLbitfield flags = 0;
+    GLuint64 timeout = 0;
+    while(true) {
+      auto status = glClientWaitSync(fence, flags, timeout);
+      if(status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED)
+        break;
+      if(status == GL_WAIT_FAILED) {
+        LOG(WARNING)<<"Waiting on a streaming buffer segment failed";
+        break;
+      }
+      //Not done yet, flush so the fence can ever signal and block for a millisecond at a time
+      flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+      timeout = 1000000;
+    }
+
+    glDeleteSync(fence);
+    fence = nullptr;
+  }
+
+  void StreamingBuffer::orphan() {
+    if(persistent) {
+      //Immutable storage can't be orphaned, replace it instead
+      destroyStorage();
+      createStorage();
+    }
+    else {
+      glBindBuffer(target, buffer->getObject());
+      glBufferData(target, (GLsizeiptr)segment_size * segment_count, nullptr, GL_STREAM_DRAW);
+      glBindBuffer(target, 0);
+
+      for(auto& fence : fences) {
+        if(fence != nullptr)
+          glDeleteSync(fence);
+        fence = nullptr;
+      }
+    }
+
+    //The new storage isn't in use by anything, so the whole ring is free again
+    current_segment = 0;
+    segment_head = 0;
+  }
+
+  void StreamingBuffer::beginFrame() {
+    current_segment = (current_segment + 1) % segment_count;
+    segment_head = 0;
+    waitForSegment(current_segment);
+  }
+
+  void StreamingBuffer::endFrame() {
+    if(fences[current_segment] != nullptr)
+      glDeleteSync(fences[current_segment]);
+    fences[current_segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  }
+
+  StreamingBuffer::Allocation StreamingBuffer::upload(const void* data, const unsigned int size, const unsigned int alignment) {
+    if(alignment == 0)
+      throw std::invalid_argument("Streaming buffer alignment must be greater than 0");
+
+    auto offset = (segment_head + alignment - 1) / alignment * alignment;
+    if(offset + size > segment_size) {
+      if(size > segment_size) {
+        //Grow so a single allocation always fits in a segment
+        unsigned int new_size = segment_size > 0 ? segment_size : 1;
+        while(new_size < size)
+          new_size *= 2;
+        LOG(INFO)<<"Growing streaming buffer segments to "<<new_size<<" bytes";
+        destroyStorage();
+        segment_size = new_size;
+        createStorage();
+        current_segment = 0;
+        segment_head = 0;
+      }
+      else {
+        orphan();
+      }
+      offset = 0;
+    }
+
+    auto buffer_offset = current_segment * segment_size + offset;
+    if(size > 0) {
+      if(persistent) {
+        std::memcpy(persistent_data + buffer_offset, data, size);
+      }
+      else {
+        glBindBuffer(target, buffer->getObject());
+        auto mapped = glMapBufferRange(target, buffer_offset, size, GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+        if(mapped == nullptr) {
+          glBindBuffer(target, 0);
+          throw std::runtime_error("Could not map streaming buffer");
+        }
+        std::memcpy(mapped, data, size);
+        glUnmapBuffer(target);
+        glBindBuffer(target, 0);
+      }
+    }
+
+    segment_head = offset + size;
+    return Allocation { buffer->getObject(), buffer_offset, size };
+  }
+
+  unsigned int StreamingBuffer::getBufferObject() const noexcept {
+    return buffer != nullptr ? buffer->getObject() : 0;
+  }
+
+  unsigned int StreamingBuffer::getSegmentSize() const noexcept {
+    return segment_size;
+  }
+
+  bool StreamingBuffer::isPersistent() const noexcept {
+    return persistent;
+  }
+}
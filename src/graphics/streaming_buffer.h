@@ -0,0 +1,123 @@
+#ifndef STREAMING_BUFFER_H
+#define STREAMING_BUFFER_H
+#ifdef __APPLE__
+#include <OpenGL/gl3.h>
+#else
+#include <glad/glad.h>
+#endif
+#include <memory>
+#include <vector>
+#include "gpu_resource.h"
+
+namespace Graphics {
+  /**
+   * @brief      Ring of buffer segments for geometry that is rebuilt every frame.
+   *
+   * @detail     The buffer is split into one segment per frame in flight. Every frame suballocates from
+   * its own segment and fences it when the frame ends, so writing never waits on the GPU unless it
+   * is a full ring behind. Uses a persistently mapped buffer when GL_ARB_buffer_storage is available,
+   * unsynchronized range mapping otherwise. An allocation that doesn't fit in the current segment
+   * orphans the whole buffer instead of stalling.
+   */
+  class [[scriptable]] StreamingBuffer {
+    public:
+      /**
+       * @brief      A range of the buffer that was written this frame
+       */
+      struct Allocation {
+        unsigned int buffer_object;
+        unsigned int offset;
+        unsigned int size;
+      };
+
+    private:
+      GLenum target;
+      std::shared_ptr<GPUResource> buffer;
+      unsigned int segment_size;
+      unsigned int segment_count;
+      unsigned int current_segment;
+      unsigned int segment_head;
+      std::vector<GLsync> fences;
+      bool persistent;
+      unsigned char* persistent_data;
+
+      void createStorage();
+      void destroyStorage();
+      void waitForSegment(const unsigned int segment);
+      void orphan();
+
+    public:
+      StreamingBuffer() = delete;
+      /**
+       * @brief      StreamingBuffer constructor
+       *
+       * @param[in]  target         The buffer target, such as GL_ARRAY_BUFFER
+       * @param[in]  segment_size   The size of each frame's segment in bytes
+       * @param[in]  segment_count  The number of frames that can be in flight
+       */
+      StreamingBuffer(const GLenum target, const unsigned int segment_size, const unsigned int segment_count = 3);
+      /**
+       * @brief      Destroys the object.
+       */
+      ~StreamingBuffer();
+
+      //Remove copy constructor and assignment
+      StreamingBuffer(const StreamingBuffer&) = delete;
+      StreamingBuffer& operator=(const StreamingBuffer&) = delete;
+
+      /**
+       * @brief      Moves to the next segment, waiting only if the GPU still reads from it
+       */
+      void beginFrame();
+      /**
+       * @brief      Fences the current segment
+       */
+      void endFrame();
+
+      /**
+       * @brief      Copies data into the current frame's segment.
+       *
+       * @param[in]  data       The data
+       * @param[in]  size       The size in bytes
+       * @param[in]  alignment  The alignment of the returned offset in bytes
+       *
+       * @return     The buffer and offset the data was written to, valid until the end of the frame
+       */
+      Allocation upload(const void* data, const unsigned int size, const unsigned int alignment = 4);
+
+      /**
+       * @brief      Copies a vector into the current frame's segment.
+       *
+       * @param[in]  data  The data
+       *
+       * @tparam     T     Type of the elements
+       *
+       * @return     The buffer and offset the data was written to, valid until the end of the frame
+       */
+      template<typename T>
+      Allocation upload(const std::vector<T>& data) {
+        return upload(data.data(), data.size() * sizeof(T), sizeof(T) % 4 == 0 ? sizeof(T) : 4);
+      }
+
+      /**
+       * @brief      Gets the buffer object.
+       *
+       * @return     The buffer object.
+       */
+      unsigned int getBufferObject() const noexcept;
+      /**
+       * @brief      Gets the segment size.
+       *
+       * @return     The segment size in bytes.
+       */
+      unsigned int getSegmentSize() const noexcept;
+      /**
+       * @brief      Determines if the buffer is persistently mapped.
+       *
+       * @return     True if persistent, False otherwise.
+       */
+      bool isPersistent() const noexcept;
+  };
+}
+
+#endif
@@ -5,12 +5,15 @@
 #else
 #include <glad/glad.h>
 #endif
+#include <algorithm>
+#include <vector>
 #include "texture_manager.h"
+#include "gpu_resource.h"
 #include "exceptions/invalid_texture_name_exception.h"
 
 namespace Graphics {
 
-  TextureManager::TextureManager() {
+  TextureManager::TextureManager() : budget(0) {
 
   }
 
@@ -57,4 +60,82 @@ namespace Graphics {
     name = path.substr(start, end - start);
     return name;
   }
+
+  void TextureManager::addSceneTexture(const std::string& scene, const std::string& name) {
+    if(!scene.empty())
+      scene_textures[scene].insert(name);
+  }
+
+  void TextureManager::activateScene(const std::string& scene) {
+    active_scenes.insert(scene);
+    for(auto& name : scene_textures[scene]) {
+      auto texture = textures_to_names.find(name);
+      if(texture != textures_to_names.end() && !texture->second->makeResident())
+        LOG(WARNING)<<"Texture: "<<name<<" of scene: "<<scene<<" could not be made resident";
+    }
+    enforceBudget();
+  }
+
+  void TextureManager::deactivateScene(const std::string& scene) {
+    active_scenes.erase(scene);
+    enforceBudget();
+  }
+
+  void TextureManager::setBudget(const size_t bytes) {
+    budget = bytes;
+    enforceBudget();
+  }
+
+  size_t TextureManager::getBudget() const noexcept {
+    return budget;
+  }
+
+  bool TextureManager::usedByActiveScene(const std::string& texture_name) const noexcept {
+    for(auto& scene : active_scenes) {
+      auto textures = scene_textures.find(scene);
+      if(textures != scene_textures.end() && textures->second.count(texture_name) > 0)
+        return true;
+    }
+    return false;
+  }
+
+  void TextureManager::enforceBudget() {
+    if(budget == 0 || GPUResourceRegistry::getTotalBytes() <= budget)
+      return;
+
+    //Only textures of scenes are candidates, anything else may be needed at any time
+    std::set<std::string> candidate_names;
+    for(auto& scene : scene_textures) {
+      candidate_names.insert(scene.second.begin(), scene.second.end());
+    }
+
+    std::vector<std::shared_ptr<BaseTexture>> candidates;
+    for(auto& name : candidate_names) {
+      auto texture = textures_to_names.find(name);
+      if(texture != textures_to_names.end() && texture->second->isEvictable() && !usedByActiveScene(name))
+        candidates.push_back(texture->second);
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const std::shared_ptr<BaseTexture>& lhs, const std::shared_ptr<BaseTexture>& rhs) {
+      return lhs->getLastUsedFrame() < rhs->getLastUsedFrame();
+    });
+
+    for(auto& texture : candidates) {
+      if(GPUResourceRegistry::getTotalBytes() <= budget)
+        return;
+      LOG(INFO)<<"Evicting texture: "<<texture->getName()<<" ("<<texture->getBytes()<<" bytes)";
+      texture->evict();
+    }
+
+    if(GPUResourceRegistry::getTotalBytes() > budget)
+      LOG(WARNING)<<"GPU memory in use: "<<GPUResourceRegistry::getTotalBytes()<<" bytes is over the budget: "<<budget<<" bytes with nothing left to evict";
+  }
+
+  size_t TextureManager::getResidentBytes() const noexcept {
+    size_t bytes = 0;
+    for(auto& texture : textures_to_names) {
+      bytes += texture.second->getBytes();
+    }
+    return bytes;
+  }
 }
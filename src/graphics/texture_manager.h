@@ -2,16 +2,27 @@
 #define TEXTURE_MANAGER_H
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include "base_texture.h"
 
 namespace Graphics {
   /**
    * @brief      Class for texture manager.
+   *
+   * @detail     Textures are tracked by the scenes using them. Under a VRAM budget, textures that
+   * only inactive scenes use are evicted least recently bound first, and loaded again when one
+   * of their scenes is activated.
    */
   class [[scriptable]] TextureManager {
     private:
       std::map<std::string, std::shared_ptr<BaseTexture>> textures_to_names;
+      std::map<std::string, std::set<std::string>> scene_textures;
+      std::set<std::string> active_scenes;
+      //In bytes, 0 for no budget
+      size_t budget;
+
+      bool usedByActiveScene(const std::string& texture_name) const noexcept;
     public:
       /**
        * @brief      TextureManager constructor
@@ -65,6 +76,51 @@ namespace Graphics {
        * @return     The name from path.
        */
       static std::string getNameFromPath(const std::string& path) noexcept;
+
+      /**
+       * @brief      Records that a scene uses a texture.
+       *
+       * @param[in]  scene  The scene name
+       * @param[in]  name   The texture name
+       */
+      [[scriptable]] void addSceneTexture(const std::string& scene, const std::string& name);
+      /**
+       * @brief      Makes the textures of a scene resident, then evicts down to the budget.
+       *
+       * @param[in]  scene  The scene name
+       */
+      [[scriptable]] void activateScene(const std::string& scene);
+      /**
+       * @brief      Lets the textures of a scene be evicted, then evicts down to the budget.
+       *
+       * @param[in]  scene  The scene name
+       */
+      [[scriptable]] void deactivateScene(const std::string& scene);
+
+      /**
+       * @brief      Sets the VRAM budget.
+       *
+       * @param[in]  bytes  The budget in bytes, 0 for none
+       */
+      [[scriptable]] void setBudget(const size_t bytes);
+      /**
+       * @brief      Gets the VRAM budget.
+       *
+       * @return     The budget in bytes, 0 for none.
+       */
+      [[scriptable]] size_t getBudget() const noexcept;
+      /**
+       * @brief      Evicts textures only inactive scenes use until the GPU memory in use fits the budget.
+       *
+       * @detail     The GPU memory in use counts everything GPUResourceRegistry tracks, geometry included.
+       */
+      [[scriptable]] void enforceBudget();
+      /**
+       * @brief      Gets the GPU memory of the resident textures.
+       *
+       * @return     The bytes.
+       */
+      [[scriptable]] size_t getResidentBytes() const noexcept;
   };
 }
 
@@ -1,10 +1,12 @@
 #ifndef TILE_ANIMATOR_H
 #define TILE_ANIMATOR_H
 #include <glm/glm.hpp>
+#include <easylogging++.h>
 #include "../component.h"
+#include "../entity.h"
 #include "vertex_data.h"
 #include "../events/subject.h"
-#include "set_uniform_event.h"
+#include "renderable.h"
 #include "../set_active_event.h"
 #include "../game/animation_trigger_event.hpp"
 #include "../cloneable.hpp"
@@ -12,6 +14,8 @@
 namespace Graphics {
   /**
    * @brief      Class for tile animator.
+   *
+   * @detail     Writes the current frame straight into the uniforms of the renderable on its entity.
    */
   template<typename StateType>
   class TileAnimator : public Component, public Cloneable<TileAnimator<StateType>> {
@@ -27,6 +31,10 @@ namespace Graphics {
       std::map<StateType, std::list<std::pair<glm::ivec2, unsigned int>>> triggerable_animations;
       StateType current_state;
 
+      //Resolved from the entity in onStart
+      std::weak_ptr<Renderable> renderable;
+      unsigned int tile_coord_slot;
+
     public:
       TileAnimator() = delete;
       /**
@@ -37,7 +45,7 @@ namespace Graphics {
        * @param[in]  tile_width_pixels   The tile width pixels
        * @param[in]  tile_height_pixels  The tile height pixels
        */
-      TileAnimator(const unsigned int tileset_width, const unsigned int tileset_height, const unsigned int tile_width_pixels, const unsigned int tile_height_pixels)  : current_state((StateType)0), frame_time_accumulator(0.0), tile_width(tile_width_pixels), tile_height(tile_height_pixels), tileset_width(tileset_width), tileset_height(tileset_height) {
+      TileAnimator(const unsigned int tileset_width, const unsigned int tileset_height, const unsigned int tile_width_pixels, const unsigned int tile_height_pixels)  : current_state((StateType)0), frame_time_accumulator(0.0), tile_width(tile_width_pixels), tile_height(tile_height_pixels), tileset_width(tileset_width), tileset_height(tileset_height), tile_coord_slot(0) {
       }
       /**
        * @brief      Factory function for TileAnimator
@@ -124,19 +132,23 @@ namespace Graphics {
       virtual void onStart() override  {
         frame_time_accumulator = 0.0;
 
-        if(triggerable_animations[current_state].size() > 0) {
-          Uniform tile_coord;
-          tile_coord.setData("tile_coord", triggerable_animations[current_state].front().first);
-          notify(SetUniformEvent::create(tile_coord));
+        auto owner = entity.lock();
+        auto sibling = owner != nullptr ? owner->getComponent<Renderable>() : nullptr;
+        renderable = sibling;
+        if(sibling == nullptr) {
+          LOG(WARNING)<<"TileAnimator "<<getId()<<" has no renderable on its entity to animate";
+          return;
+        }
 
-          float normalized_width = float(tile_width) / float(tileset_width);
-          float normalized_height = float(tile_height) / float(tileset_height);
-          multiplier = glm::vec2(normalized_width, normalized_height);
+        //The multiplier is the same for every state, a state without frames can still be switched to one with frames
+        float normalized_width = float(tile_width) / float(tileset_width);
+        float normalized_height = float(tile_height) / float(tileset_height);
+        multiplier = glm::vec2(normalized_width, normalized_height);
+        sibling->setUniformSlot(sibling->getUniformSlot("tile_coord_multiplier", multiplier), multiplier);
 
-          Uniform tile_coord_multiplier;
-          tile_coord_multiplier.setData("tile_coord_multiplier", multiplier);
-          notify(SetUniformEvent::create(tile_coord_multiplier));
-        }
+        tile_coord_slot = sibling->getUniformSlot("tile_coord", glm::ivec2(0, 0));
+        if(triggerable_animations[current_state].size() > 0)
+          sibling->setUniformSlot(tile_coord_slot, triggerable_animations[current_state].front().first);
       }
 
       virtual bool onUpdate(const double delta) override  {
@@ -153,12 +165,10 @@ namespace Graphics {
             triggerable_animations[current_state].push_back(triggerable_animations[current_state].front());
             triggerable_animations[current_state].pop_front();
             frame_time_accumulator = 0.0;
-            Uniform tile_coord;
-            tile_coord.setData(std::string("tile_coord"), triggerable_animations[current_state].front().first);
-            notifyNow(SetUniformEvent::create(tile_coord));
-            Uniform tile_coord_multiplier;
-            tile_coord_multiplier.setData(std::string("tile_coord_multiplier"), multiplier);
-            notifyNow(SetUniformEvent::create(tile_coord_multiplier));
+
+            auto sibling = renderable.lock();
+            if(sibling != nullptr)
+              sibling->setUniformSlot(tile_coord_slot, triggerable_animations[current_state].front().first);
           }
         }
         return true;
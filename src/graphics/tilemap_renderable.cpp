@@ -0,0 +1,66 @@
+#include <sstream>
+#include "tilemap_renderable.h"
+
+namespace Graphics {
+  TilemapRenderable::TilemapRenderable(std::shared_ptr<GPUResource> vertex_array, const VertexRecord& vertex_record) : Renderable(vertex_array, vertex_record) {
+  }
+
+  std::shared_ptr<TilemapRenderable> TilemapRenderable::create(const unsigned int width_in_tiles, const unsigned int height_in_tiles) {
+    auto quad = generateLayerQuad(width_in_tiles, height_in_tiles);
+    return std::make_shared<TilemapRenderable>(quad.generateVertexArrayObject(), quad.getRecord());
+  }
+
+  TilemapRenderable::QuadLayout TilemapRenderable::generateLayerQuad(const unsigned int width_in_tiles, const unsigned int height_in_tiles) {
+    float width = (float)width_in_tiles;
+    float height = (float)height_in_tiles;
+
+    std::vector<glm::vec3> verts {
+      glm::vec3(0.0, 0.0, 0.0),
+      glm::vec3(0.0, height, 0.0),
+      glm::vec3(width, height, 0.0),
+      glm::vec3(0.0, 0.0, 0.0),
+      glm::vec3(width, height, 0.0),
+      glm::vec3(width, 0.0, 0.0)
+    };
+
+    std::vector<glm::vec2> texs {
+      glm::vec2(0.0, 0.0),
+      glm::vec2(0.0, 1.0),
+      glm::vec2(1.0, 1.0),
+      glm::vec2(0.0, 0.0),
+      glm::vec2(1.0, 1.0),
+      glm::vec2(1.0, 0.0)
+    };
+
+    return QuadLayout::fromVectors(GL_TRIANGLES, verts, texs);
+  }
+
+  void TilemapRenderable::setTileMap(std::shared_ptr<BaseTexture> tile_map) noexcept {
+    addTexture(TILE_MAP_UNIT, "tile_map", tile_map);
+  }
+
+  void TilemapRenderable::addTileset(const unsigned int unit, std::shared_ptr<BaseTexture> tileset, const unsigned int tile_width, const unsigned int tile_height) noexcept {
+    std::stringstream sampler_name;
+    sampler_name << "tileset" << unit;
+    addTexture(unit, sampler_name.str(), tileset);
+
+    tile_uv_sizes[unit] = glm::vec2((float)tile_width / (float)tileset->getWidth(), (float)tile_height / (float)tileset->getHeight());
+  }
+
+  std::string TilemapRenderable::className() const noexcept {
+    return "Graphics::TilemapRenderable";
+  }
+
+  void TilemapRenderable::onStart() {
+    Renderable::onStart();
+
+    for(auto& tile_uv_size : tile_uv_sizes) {
+      std::stringstream uniform_name;
+      uniform_name << "tile_uv_size[" << tile_uv_size.first << "]";
+
+      Uniform uniform;
+      uniform.setData<glm::vec2>(uniform_name.str(), tile_uv_size.second);
+      setUniform(uniform);
+    }
+  }
+}
@@ -0,0 +1,80 @@
+#ifndef TILEMAP_RENDERABLE_H
+#define TILEMAP_RENDERABLE_H
+#include <glm/glm.hpp>
+#include <map>
+#include <memory>
+#include "renderable.h"
+#include "base_texture.h"
+
+namespace Graphics {
+  /**
+   * @brief      Renderable that draws a whole tile layer as a single quad.
+   *
+   * @detail     The layer is stored in an integer tile map texture with one texel per cell holding
+   * (tile x, tile y, tileset unit + 1, flip bits). The fragment shader resolves the tile under every
+   * pixel, so the cost of the layer does not depend on how many tiles it has.
+   */
+  class [[scriptable]] TilemapRenderable : public Renderable {
+    public:
+      /**
+       * @brief      Flip bits as stored in the alpha channel of the tile map
+       */
+      enum FlipBits : unsigned short {
+        FLIP_HORIZONTAL = 1,
+        FLIP_VERTICAL = 2,
+        FLIP_DIAGONAL = 4
+      };
+
+      /**
+       * The texture unit the tile map is bound to, after the tileset units
+       */
+      static const unsigned int TILE_MAP_UNIT = 12;
+
+    private:
+      std::map<unsigned int, glm::vec2> tile_uv_sizes;
+
+      typedef VertexLayout<Position3f, UV2f> QuadLayout;
+
+      static QuadLayout generateLayerQuad(const unsigned int width_in_tiles, const unsigned int height_in_tiles);
+
+    public:
+      /**
+       * @brief      TilemapRenderable constructor
+       *
+       * @param[in]  vertex_array   The vertex array object
+       * @param[in]  vertex_record  The record of the layer quad
+       */
+      TilemapRenderable(std::shared_ptr<GPUResource> vertex_array, const VertexRecord& vertex_record);
+      /**
+       * @brief      TilemapRenderable factory function
+       *
+       * @param[in]  width_in_tiles   The layer width in tiles
+       * @param[in]  height_in_tiles  The layer height in tiles
+       *
+       * @return     newly created TilemapRenderable
+       */
+      static std::shared_ptr<TilemapRenderable> create(const unsigned int width_in_tiles, const unsigned int height_in_tiles);
+
+      /**
+       * @brief      Sets the tile map texture.
+       *
+       * @param[in]  tile_map  The tile map, a GL_RGBA16UI texture with one texel per cell
+       */
+      [[scriptable]] void setTileMap(std::shared_ptr<BaseTexture> tile_map) noexcept;
+      /**
+       * @brief      Adds a tileset.
+       *
+       * @param[in]  unit         The unit referenced by the tile map
+       * @param[in]  tileset      The tileset texture
+       * @param[in]  tile_width   The tile width in pixels
+       * @param[in]  tile_height  The tile height in pixels
+       */
+      [[scriptable]] void addTileset(const unsigned int unit, std::shared_ptr<BaseTexture> tileset, const unsigned int tile_width, const unsigned int tile_height) noexcept;
+
+      [[scriptable]] virtual std::string className() const noexcept override;
+
+      virtual void onStart() override;
+  };
+}
+
+#endif
@@ -0,0 +1,57 @@
+#include <easylogging++.h>
+#include <IL/il.h>
+#include "tileset_alpha.h"
+
+namespace Graphics {
+  TilesetAlpha::TilesetAlpha(const unsigned char* rgba, const unsigned int width, const unsigned int height, const unsigned int tile_width, const unsigned int tile_height) :
+    width_in_tiles(tile_width > 0 ? width / tile_width : 0) {
+    unsigned int height_in_tiles = tile_height > 0 ? height / tile_height : 0;
+
+    for(unsigned int tile_y = 0; tile_y < height_in_tiles; tile_y++) {
+      for(unsigned int tile_x = 0; tile_x < width_in_tiles; tile_x++) {
+        //Tile rows count from the top, image rows from the bottom, the same way the texture coordinates are generated
+        alpha_modes.push_back(classify(rgba, width, tile_x * tile_width, (height_in_tiles - 1 - tile_y) * tile_height, tile_width, tile_height));
+      }
+    }
+  }
+
+  std::shared_ptr<TilesetAlpha> TilesetAlpha::load(const std::string& filename, const unsigned int tile_width, const unsigned int tile_height) {
+    unsigned int image_id;
+    ilGenImages(1, &image_id);
+    ilBindImage(image_id);
+    ilEnable(IL_ORIGIN_SET);
+    ilOriginFunc(IL_ORIGIN_LOWER_LEFT);
+
+    std::shared_ptr<TilesetAlpha> tileset_alpha = nullptr;
+    if(ilLoadImage((const ILstring)filename.c_str()) && ilConvertImage(IL_RGBA, IL_UNSIGNED_BYTE)) {
+      tileset_alpha = std::make_shared<TilesetAlpha>(ilGetData(), ilGetInteger(IL_IMAGE_WIDTH), ilGetInteger(IL_IMAGE_HEIGHT), tile_width, tile_height);
+    }
+    else {
+      LOG(WARNING)<<"Tileset image: "<<filename<<" could not be classified, its tiles are treated as translucent";
+    }
+
+    ilDeleteImages(1, &image_id);
+    return tileset_alpha;
+  }
+
+  Renderable::AlphaMode TilesetAlpha::classify(const unsigned char* rgba, const unsigned int width, const unsigned int x, const unsigned int y, const unsigned int w, const unsigned int h) noexcept {
+    auto mode = Renderable::AlphaMode::OPAQUE;
+    for(unsigned int row = y; row < y + h; row++) {
+      for(unsigned int column = x; column < x + w; column++) {
+        auto alpha = rgba[(row * width + column) * 4 + 3];
+        if(alpha == 255)
+          continue;
+        if(alpha >= DISCARD_ALPHA)
+          return Renderable::AlphaMode::TRANSLUCENT;
+        mode = Renderable::AlphaMode::CUTOUT;
+      }
+    }
+    return mode;
+  }
+
+  Renderable::AlphaMode TilesetAlpha::getAlphaMode(const int tile_id) const noexcept {
+    if(tile_id < 0 || (unsigned int)tile_id >= alpha_modes.size())
+      return Renderable::AlphaMode::TRANSLUCENT;
+    return alpha_modes[tile_id];
+  }
+}
@@ -0,0 +1,72 @@
+#ifndef TILESET_ALPHA_H
+#define TILESET_ALPHA_H
+#include <memory>
+#include <string>
+#include <vector>
+#include "renderable.h"
+
+namespace Graphics {
+  /**
+   * @brief      Alpha mode of every tile in a tileset image.
+   *
+   * @detail     A tile is opaque when all of its texels are fully opaque, cutout when every texel is
+   * either fully opaque or below the shaders' discard threshold, and translucent otherwise. Tile ids
+   * count left to right from the top row, the same as Tiled.
+   */
+  class TilesetAlpha {
+    private:
+      unsigned int width_in_tiles;
+      std::vector<Renderable::AlphaMode> alpha_modes;
+
+      //Texels below this are discarded by the shaders, see `if(texel.a < 0.1)`
+      static const unsigned char DISCARD_ALPHA = 26;
+
+    public:
+      /**
+       * @brief      TilesetAlpha constructor
+       *
+       * @param[in]  rgba         The image as 8 bit RGBA rows, bottom row first
+       * @param[in]  width        The image width
+       * @param[in]  height       The image height
+       * @param[in]  tile_width   The tile width
+       * @param[in]  tile_height  The tile height
+       */
+      TilesetAlpha(const unsigned char* rgba, const unsigned int width, const unsigned int height, const unsigned int tile_width, const unsigned int tile_height);
+
+      /**
+       * @brief      Loads a tileset image and classifies its tiles.
+       *
+       * @param[in]  filename     The image file
+       * @param[in]  tile_width   The tile width
+       * @param[in]  tile_height  The tile height
+       *
+       * @return     The classified tileset, nullptr if the image couldn't be loaded.
+       */
+      static std::shared_ptr<TilesetAlpha> load(const std::string& filename, const unsigned int tile_width, const unsigned int tile_height);
+
+      /**
+       * @brief      Classifies a rectangle of an image.
+       *
+       * @param[in]  rgba    The image as 8 bit RGBA rows
+       * @param[in]  width   The image width
+       * @param[in]  x       The rectangle x
+       * @param[in]  y       The rectangle y
+       * @param[in]  w       The rectangle width
+       * @param[in]  h       The rectangle height
+       *
+       * @return     The alpha mode of the rectangle.
+       */
+      static Renderable::AlphaMode classify(const unsigned char* rgba, const unsigned int width, const unsigned int x, const unsigned int y, const unsigned int w, const unsigned int h) noexcept;
+
+      /**
+       * @brief      Gets the alpha mode of a tile.
+       *
+       * @param[in]  tile_id  The tile id
+       *
+       * @return     The alpha mode, translucent for ids outside the image.
+       */
+      Renderable::AlphaMode getAlphaMode(const int tile_id) const noexcept;
+  };
+}
+
+#endif
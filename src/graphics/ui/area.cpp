@@ -4,7 +4,7 @@
 namespace Graphics {
   namespace UI {
 
-    Area::Area(VertexData vertex_data, std::shared_ptr<Skin> skin, const unsigned int layer) : Element(vertex_data, skin, layer) {
+    Area::Area(const VertexData& vertex_data, std::shared_ptr<Skin> skin, const unsigned int layer) : Element(vertex_data, skin, layer) {
     }
 
     std::shared_ptr<Area> Area::create(std::shared_ptr<Skin> skin, glm::vec4 color, float screen_width, float screen_height, float x_pos, float y_pos, float width, float height, const unsigned int layer) {
@@ -19,7 +19,7 @@ namespace Graphics {
          * @param[in]  vertex_data  The vertex data
          * @param[in]  skin         The skin
          */
-        [[scriptable]] Area(VertexData vertex_data, std::shared_ptr<Skin> skin, const unsigned int layer);
+        [[scriptable]] Area(const VertexData& vertex_data, std::shared_ptr<Skin> skin, const unsigned int layer);
         /**
          * @brief      Area factory function.
          *
@@ -22,7 +22,7 @@ namespace Graphics {
          * @param[in]  vertex_data  The vertex data
          * @param[in]  skin         The skin
          */
-        [[scriptable]] Button(std::shared_ptr<WrappableText> text, VertexData vertex_data, std::shared_ptr<Skin> skin, const unsigned int layer);
+        [[scriptable]] Button(std::shared_ptr<WrappableText> text, const VertexData& vertex_data, std::shared_ptr<Skin> skin, const unsigned int layer);
         /**
          * @brief      Factory function for Button
          *
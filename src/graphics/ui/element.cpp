@@ -13,7 +13,7 @@
 namespace Graphics {
   namespace UI {
 
-    Element::Element(VertexData vertex_data, std::shared_ptr<Skin> skin, const unsigned int layer) : Renderable(vertex_data.generateVertexArrayObject(), vertex_data), skin(skin), anchor_point(glm::vec2(0.0, 0.0)), width(0), height(0), text_padding(0), cursor_within(false), color(glm::vec4(1.0)), layer(layer) {
+    Element::Element(const VertexData& vertex_data, std::shared_ptr<Skin> skin, const unsigned int layer) : Renderable(vertex_data.generateVertexArrayObject(), vertex_data), skin(skin), anchor_point(glm::vec2(0.0, 0.0)), width(0), height(0), text_padding(0), cursor_within(false), color(glm::vec4(1.0)), layer(layer) {
       setShader(skin->getShader());
       addTexture(0, "skin0", skin->getTexture());
       getTransform()->translate(glm::vec3(0.0, 0.0, -(float)layer));
@@ -31,7 +31,7 @@ namespace Graphics {
          * @param[in]  vertex_data  The vertex data
          * @param[in]  skin         The UI skin
          */
-        Element(VertexData vertex_data, std::shared_ptr<Skin> skin, const unsigned int layer);
+        Element(const VertexData& vertex_data, std::shared_ptr<Skin> skin, const unsigned int layer);
         /**
          * @brief      Destroys element.
          */
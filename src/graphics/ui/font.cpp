@@ -1,23 +1,61 @@
+#include <easylogging++.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
 #include "font.h"
 
 namespace Graphics {
   namespace UI {
-    Font::Font(const unsigned int size, const unsigned int pixels_per_unit) : size(size), pixels_per_unit(pixels_per_unit) {
+    Font::Font(const unsigned int size, const unsigned int pixels_per_unit, std::shared_ptr<GlyphRasterizer> rasterizer) :
+      rasterizer(rasterizer), size(size), pixels_per_unit(pixels_per_unit), page_size(64), glyph_cache_dirty(false) {
+      //A page fits a 12x12 grid of padded glyphs, enough for the characters most texts use
+      while(page_size < 12 * (size + 2))
+        page_size *= 2;
+    }
 
+    void Font::addCharacter(const unsigned int codepoint, const Character& character) {
+      characters[codepoint] = character;
     }
 
-    void Font::addCharacter(const char text_char, const Character& character) {
-      characters[text_char] = character;
+    const Character& Font::getCharacter(const unsigned int codepoint) {
+      auto character = characters.find(codepoint);
+      if(character != characters.end())
+        return character->second;
+
+      rasterizeCharacter(codepoint);
+      return characters[codepoint];
     }
 
-    Character Font::getCharacter(const char text_char) {
-      return characters[text_char];
+    void Font::rasterizeCharacter(const unsigned int codepoint) {
+      //Characters that can't be rendered are still stored so they're only tried once
+      Character character = {};
+      GlyphBitmap bitmap;
+
+      if(rasterizer != nullptr && rasterizer->rasterize(codepoint, bitmap)) {
+        character.position = bitmap.position;
+        character.size = bitmap.size;
+        character.advance = bitmap.advance;
+
+        if(pages.empty() || !pages.back()->addGlyph(bitmap.width, bitmap.height, bitmap.pixels.data(), character.uv_position, character.uv_size)) {
+          pages.push_back(std::make_shared<GlyphAtlas>(std::max(page_size, bitmap.width + 2), std::max(page_size, bitmap.height + 2)));
+          pages.back()->addGlyph(bitmap.width, bitmap.height, bitmap.pixels.data(), character.uv_position, character.uv_size);
+        }
+        character.page = pages.size() - 1;
+        character.texture_handle = pages.back()->getTextureHandle();
+      }
+
+      characters[codepoint] = character;
+      glyph_cache_dirty = true;
     }
 
-    std::map<char, Character> Font::getCharacters() const {
+    std::map<unsigned int, Character> Font::getCharacters() const {
       return characters;
     }
 
+    std::vector<std::shared_ptr<GlyphAtlas>> Font::getPages() const {
+      return pages;
+    }
+
     unsigned int Font::getSize() const noexcept {
       return size;
     }
@@ -25,5 +63,106 @@ namespace Graphics {
     float Font::getOpenGLSize() const noexcept {
       return (float)size / (float)pixels_per_unit;
     }
+
+    unsigned long long Font::hashTTFFile() const {
+      if(rasterizer == nullptr)
+        return 0;
+
+      std::ifstream ttf_file(rasterizer->getTTFPath(), std::ios::binary);
+      //FNV-1a
+      unsigned long long hash = 14695981039346656037ULL;
+      std::istreambuf_iterator<char> end;
+      for(std::istreambuf_iterator<char> byte(ttf_file); byte != end; byte++) {
+        hash ^= (unsigned char)*byte;
+        hash *= 1099511628211ULL;
+      }
+      return hash;
+    }
+
+    bool Font::saveGlyphCache(const std::string& path) {
+      std::ofstream file(path, std::ios::binary | std::ios::trunc);
+      if(!file) {
+        LOG(WARNING)<<"Could not write glyph cache: "<<path;
+        return false;
+      }
+
+      unsigned int header[5] = {GLYPH_CACHE_MAGIC, size, pixels_per_unit, (unsigned int)pages.size(), (unsigned int)characters.size()};
+      unsigned long long ttf_hash = hashTTFFile();
+      file.write((const char*)header, sizeof(header));
+      file.write((const char*)&ttf_hash, sizeof(ttf_hash));
+
+      for(auto& page : pages) {
+        page->write(file);
+      }
+
+      for(auto& character : characters) {
+        file.write((const char*)&character.first, sizeof(character.first));
+        file.write((const char*)&character.second.page, sizeof(character.second.page));
+        file.write((const char*)&character.second.position, sizeof(character.second.position));
+        file.write((const char*)&character.second.size, sizeof(character.second.size));
+        file.write((const char*)&character.second.advance, sizeof(character.second.advance));
+        file.write((const char*)&character.second.uv_position, sizeof(character.second.uv_position));
+        file.write((const char*)&character.second.uv_size, sizeof(character.second.uv_size));
+      }
+
+      if(!file) {
+        LOG(WARNING)<<"Could not write glyph cache: "<<path;
+        return false;
+      }
+
+      glyph_cache_dirty = false;
+      return true;
+    }
+
+    bool Font::loadGlyphCache(const std::string& path) {
+      std::ifstream file(path, std::ios::binary);
+      if(!file)
+        return false;
+
+      unsigned int header[5];
+      unsigned long long ttf_hash;
+      if(!file.read((char*)header, sizeof(header)) || !file.read((char*)&ttf_hash, sizeof(ttf_hash)))
+        return false;
+      if(header[0] != GLYPH_CACHE_MAGIC || header[1] != size || header[2] != pixels_per_unit || ttf_hash != hashTTFFile()) {
+        LOG(INFO)<<"Glyph cache "<<path<<" is out of date";
+        return false;
+      }
+
+      std::vector<std::shared_ptr<GlyphAtlas>> loaded_pages;
+      for(unsigned int i = 0; i < header[3]; i++) {
+        auto page = GlyphAtlas::read(file);
+        if(page == nullptr)
+          return false;
+        loaded_pages.push_back(page);
+      }
+
+      std::map<unsigned int, Character> loaded_characters;
+      for(unsigned int i = 0; i < header[4]; i++) {
+        unsigned int codepoint;
+        Character character = {};
+        file.read((char*)&codepoint, sizeof(codepoint));
+        file.read((char*)&character.page, sizeof(character.page));
+        file.read((char*)&character.position, sizeof(character.position));
+        file.read((char*)&character.size, sizeof(character.size));
+        file.read((char*)&character.advance, sizeof(character.advance));
+        file.read((char*)&character.uv_position, sizeof(character.uv_position));
+        file.read((char*)&character.uv_size, sizeof(character.uv_size));
+        if(!file)
+          return false;
+
+        if(character.page < loaded_pages.size())
+          character.texture_handle = loaded_pages[character.page]->getTextureHandle();
+        loaded_characters[codepoint] = character;
+      }
+
+      pages = loaded_pages;
+      characters = loaded_characters;
+      glyph_cache_dirty = false;
+      return true;
+    }
+
+    bool Font::isGlyphCacheDirty() const noexcept {
+      return glyph_cache_dirty;
+    }
   }
 }
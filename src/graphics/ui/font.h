@@ -1,8 +1,12 @@
 #ifndef FONT_H
 #define FONT_H
 #include <map>
+#include <memory>
+#include <string>
+#include <vector>
 #include <glm/glm.hpp>
-#include "../vertex_data.h"
+#include "glyph_atlas.h"
+#include "glyph_rasterizer.h"
 
 namespace Graphics {
   namespace UI {
@@ -11,9 +15,13 @@ namespace Graphics {
      */
     struct [[scriptable]] Character {
       /**
-       * The character's opengl texture handle.
+       * The opengl texture handle of the atlas page holding the character.
        */
       unsigned int texture_handle;
+      /**
+       * The index of the atlas page holding the character.
+       */
+      unsigned int page;
       /**
        * The character's position as specified by FT2 and transformed into our system
        */
@@ -27,53 +35,73 @@ namespace Graphics {
        */
       float advance;
       /**
-       * The character's vertex data.
+       * The texture coordinate of the character's top left corner in the atlas.
        */
-      VertexData vertex_data;
+      glm::vec2 uv_position;
       /**
-       * The character's vao.
+       * The character's size in the atlas in texture coordinates.
        */
-      unsigned int vertex_array_object;
+      glm::vec2 uv_size;
     };
 
     /**
      * @brief      Class for font.
+     *
+     * @detail     Characters are keyed by unicode codepoint and rasterized the first time they are asked
+     * for. They are packed into atlas pages, a new page is added whenever the last one is full. The
+     * characters and pages can be saved to a glyph cache file and loaded back on a later launch.
      */
     class [[scriptable]] Font {
       private:
-        std::map<char, Character> characters;
+        std::map<unsigned int, Character> characters;
+        std::vector<std::shared_ptr<GlyphAtlas>> pages;
+        std::shared_ptr<GlyphRasterizer> rasterizer;
         unsigned int size;
         unsigned int pixels_per_unit;
+        unsigned int page_size;
+        bool glyph_cache_dirty;
+
+        void rasterizeCharacter(const unsigned int codepoint);
+        unsigned long long hashTTFFile() const;
+
+        static const unsigned int GLYPH_CACHE_MAGIC = 0x4E474331;
       public:
         /**
          * @brief      Font constructor
          *
          * @param[in]  size             The size
          * @param[in]  pixels_per_unit  The pixels per unit
+         * @param[in]  rasterizer       The rasterizer missing characters come from, nullptr if they are all added
          */
-        Font(const unsigned int size = 12, const unsigned int pixels_per_unit = 32);
+        Font(const unsigned int size = 12, const unsigned int pixels_per_unit = 32, std::shared_ptr<GlyphRasterizer> rasterizer = nullptr);
 
         /**
          * @brief      Adds a character.
          *
-         * @param[in]  text_char  The text character
+         * @param[in]  codepoint  The unicode codepoint
          * @param[in]  character  The engine character
          */
-        [[scriptable]] void addCharacter(const char text_char, const Character& character);
+        [[scriptable]] void addCharacter(const unsigned int codepoint, const Character& character);
         /**
-         * @brief      Gets the character.
+         * @brief      Gets the character, rasterizing it if it wasn't used before.
          *
-         * @param[in]  text_char  The text character
+         * @param[in]  codepoint  The unicode codepoint
          *
          * @return     The character.
          */
-        [[scriptable]] Character getCharacter(const char text_char);
+        [[scriptable]] const Character& getCharacter(const unsigned int codepoint);
         /**
          * @brief      Gets the characters.
          *
          * @return     The characters.
          */
-        [[scriptable]] std::map<char, Character> getCharacters() const;
+        [[scriptable]] std::map<unsigned int, Character> getCharacters() const;
+        /**
+         * @brief      Gets the atlas pages.
+         *
+         * @return     The pages.
+         */
+        std::vector<std::shared_ptr<GlyphAtlas>> getPages() const;
         /**
          * @brief      Gets the size.
          *
@@ -86,6 +114,32 @@ namespace Graphics {
          * @return     The open gl size.
          */
         [[scriptable]] float getOpenGLSize() const noexcept;
+
+        /**
+         * @brief      Saves the characters and atlas pages.
+         *
+         * @param[in]  path  The glyph cache file
+         *
+         * @return     False if the file couldn't be written, True otherwise.
+         */
+        [[scriptable]] bool saveGlyphCache(const std::string& path);
+        /**
+         * @brief      Loads characters and atlas pages saved by saveGlyphCache.
+         *
+         * @detail     Replaces the current characters. Files written for a different size or for different
+         * ttf file contents are ignored.
+         *
+         * @param[in]  path  The glyph cache file
+         *
+         * @return     True if the cache was loaded, False otherwise.
+         */
+        [[scriptable]] bool loadGlyphCache(const std::string& path);
+        /**
+         * @brief      Determines if characters were rasterized since the glyph cache was last saved or loaded.
+         *
+         * @return     True if glyph cache dirty, False otherwise.
+         */
+        [[scriptable]] bool isGlyphCacheDirty() const noexcept;
     };
   }
 }
@@ -11,13 +11,20 @@ namespace Graphics {
   namespace UI {
     /**
      * @brief      Class for font generator.
+     *
+     * @detail     Fonts rasterize their glyphs on first use. When a glyph cache path is set, fonts are
+     * loaded from their cache file if it is up to date, and fonts that rasterized new glyphs are saved
+     * back when the generator is destroyed.
      */
     class [[scriptable]] FontGenerator {
       private:
-        FT_Library freetype;
+        std::shared_ptr<FT_LibraryRec_> freetype;
         std::string font_path;
         unsigned int pixels_per_unit;
+        std::string glyph_cache_path;
         std::map<std::string, std::shared_ptr<Font>> fonts;
+
+        std::string getGlyphCacheFile(const std::string& name, const unsigned int size) const;
       public:
         /**
          * @brief      Font generator constructor
@@ -44,6 +51,23 @@ namespace Graphics {
          */
         [[scriptable]] std::string getFontPath() const noexcept;
 
+        /**
+         * @brief      Sets the directory glyph caches are kept in.
+         *
+         * @param[in]  glyph_cache_path  The glyph cache path, empty to not cache glyphs
+         */
+        [[scriptable]] void setGlyphCachePath(const std::string& glyph_cache_path) noexcept;
+        /**
+         * @brief      Gets the directory glyph caches are kept in.
+         *
+         * @return     The glyph cache path.
+         */
+        [[scriptable]] std::string getGlyphCachePath() const noexcept;
+        /**
+         * @brief      Saves the glyph cache of every font that rasterized glyphs since it was loaded.
+         */
+        [[scriptable]] void saveGlyphCaches();
+
         /**
          * @brief      Loads a font.
          *
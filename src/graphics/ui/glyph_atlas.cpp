@@ -0,0 +1,111 @@
+#ifdef __APPLE__
+#include <OpenGL/gl3.h>
+#else
+#include <glad/glad.h>
+#endif
+#include <algorithm>
+#include <vector>
+#include "glyph_atlas.h"
+
+namespace Graphics {
+  namespace UI {
+    GlyphAtlas::GlyphAtlas(const unsigned int width, const unsigned int height, const unsigned char* pixels) : texture(GPUResourceRegistry::create(GPUResourceType::TEXTURE)), width(width), height(height), shelf_x(0), shelf_y(0), shelf_height(0) {
+      //Start out cleared so padding and unused space never sample garbage
+      if(pixels != nullptr)
+        this->pixels.assign(pixels, pixels + width * height);
+      else
+        this->pixels.assign(width * height, 0);
+
+      int unpack_alignment_before;
+      glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpack_alignment_before);
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+      glBindTexture(GL_TEXTURE_2D, texture->getObject());
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, &this->pixels[0]);
+      texture->setBytes(width * height);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+      glBindTexture(GL_TEXTURE_2D, 0);
+
+      glPixelStorei(GL_UNPACK_ALIGNMENT, unpack_alignment_before);
+    }
+
+    bool GlyphAtlas::addGlyph(const unsigned int glyph_width, const unsigned int glyph_height, const unsigned char* pixels, glm::vec2& uv_position, glm::vec2& uv_size) {
+      if(glyph_width == 0 || glyph_height == 0) {
+        uv_position = glm::vec2(0.0);
+        uv_size = glm::vec2(0.0);
+        return true;
+      }
+
+      auto padded_width = glyph_width + PADDING * 2;
+      auto padded_height = glyph_height + PADDING * 2;
+
+      if(shelf_x + padded_width > width) {
+        shelf_y += shelf_height;
+        shelf_x = 0;
+        shelf_height = 0;
+      }
+      if(padded_width > width || shelf_y + padded_height > height)
+        return false;
+
+      auto x = shelf_x + PADDING;
+      auto y = shelf_y + PADDING;
+
+      int unpack_alignment_before;
+      glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpack_alignment_before);
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+      glBindTexture(GL_TEXTURE_2D, texture->getObject());
+      glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, glyph_width, glyph_height, GL_RED, GL_UNSIGNED_BYTE, pixels);
+      glBindTexture(GL_TEXTURE_2D, 0);
+      glPixelStorei(GL_UNPACK_ALIGNMENT, unpack_alignment_before);
+
+      for(unsigned int row = 0; row < glyph_height; row++) {
+        std::copy(pixels + row * glyph_width, pixels + (row + 1) * glyph_width, this->pixels.begin() + (y + row) * width + x);
+      }
+
+      shelf_x += padded_width;
+      if(padded_height > shelf_height)
+        shelf_height = padded_height;
+
+      uv_position = glm::vec2((float)x / (float)width, (float)y / (float)height);
+      uv_size = glm::vec2((float)glyph_width / (float)width, (float)glyph_height / (float)height);
+      return true;
+    }
+
+    void GlyphAtlas::write(std::ostream& stream) const {
+      unsigned int header[5] = {width, height, shelf_x, shelf_y, shelf_height};
+      stream.write((const char*)header, sizeof(header));
+      stream.write((const char*)&pixels[0], pixels.size());
+    }
+
+    std::shared_ptr<GlyphAtlas> GlyphAtlas::read(std::istream& stream) {
+      unsigned int header[5];
+      if(!stream.read((char*)header, sizeof(header)) || header[0] == 0 || header[1] == 0 || header[0] > MAX_SIZE || header[1] > MAX_SIZE)
+        return nullptr;
+
+      std::vector<unsigned char> data(header[0] * header[1]);
+      if(!stream.read((char*)&data[0], data.size()))
+        return nullptr;
+
+      auto atlas = std::make_shared<GlyphAtlas>(header[0], header[1], &data[0]);
+      atlas->shelf_x = header[2];
+      atlas->shelf_y = header[3];
+      atlas->shelf_height = header[4];
+      return atlas;
+    }
+
+    unsigned int GlyphAtlas::getTextureHandle() const noexcept {
+      return texture->getObject();
+    }
+
+    unsigned int GlyphAtlas::getWidth() const noexcept {
+      return width;
+    }
+
+    unsigned int GlyphAtlas::getHeight() const noexcept {
+      return height;
+    }
+  }
+}
@@ -0,0 +1,97 @@
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+#include <glm/glm.hpp>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "../gpu_resource.h"
+
+namespace Graphics {
+  namespace UI {
+    /**
+     * @brief      Single channel texture that glyph bitmaps are packed into.
+     *
+     * @detail     Glyphs are placed left to right on shelves as tall as the tallest glyph on them, a new
+     * shelf is started when the current one runs out of width. Every glyph is padded by a texel so
+     * linear filtering doesn't bleed its neighbours in. A copy of the pixels is kept so the atlas can be
+     * written to disk and read back without rasterizing the glyphs again.
+     */
+    class [[scriptable]] GlyphAtlas {
+      private:
+        std::shared_ptr<GPUResource> texture;
+        unsigned int width;
+        unsigned int height;
+        unsigned int shelf_x;
+        unsigned int shelf_y;
+        unsigned int shelf_height;
+        std::vector<unsigned char> pixels;
+
+        static const unsigned int PADDING = 1;
+        static const unsigned int MAX_SIZE = 8192;
+
+      public:
+        GlyphAtlas() = delete;
+        /**
+         * @brief      GlyphAtlas constructor
+         *
+         * @param[in]  width   The width in pixels
+         * @param[in]  height  The height in pixels
+         * @param[in]  pixels  The initial 8 bit pixels, width * height of them, or nullptr for an empty atlas
+         */
+        GlyphAtlas(const unsigned int width, const unsigned int height, const unsigned char* pixels = nullptr);
+
+        //Remove copy constructor and assignment
+        GlyphAtlas(const GlyphAtlas&) = delete;
+        GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+        /**
+         * @brief      Packs a glyph bitmap into the atlas.
+         *
+         * @param[in]  glyph_width   The glyph width in pixels
+         * @param[in]  glyph_height  The glyph height in pixels
+         * @param[in]  pixels        The tightly packed 8 bit coverage of the glyph, top row first
+         * @param[out] uv_position   The texture coordinate of the glyph's top left corner
+         * @param[out] uv_size       The size of the glyph in texture coordinates
+         *
+         * @return     False if the atlas is full, True otherwise.
+         */
+        bool addGlyph(const unsigned int glyph_width, const unsigned int glyph_height, const unsigned char* pixels, glm::vec2& uv_position, glm::vec2& uv_size);
+
+        /**
+         * @brief      Writes the atlas, including where the next glyph goes.
+         *
+         * @param      stream  The binary stream
+         */
+        void write(std::ostream& stream) const;
+        /**
+         * @brief      Reads an atlas written by write.
+         *
+         * @param      stream  The binary stream
+         *
+         * @return     The atlas, nullptr if the stream is truncated.
+         */
+        static std::shared_ptr<GlyphAtlas> read(std::istream& stream);
+
+        /**
+         * @brief      Gets the texture handle.
+         *
+         * @return     The texture handle.
+         */
+        [[scriptable]] unsigned int getTextureHandle() const noexcept;
+        /**
+         * @brief      Gets the width.
+         *
+         * @return     The width in pixels.
+         */
+        [[scriptable]] unsigned int getWidth() const noexcept;
+        /**
+         * @brief      Gets the height.
+         *
+         * @return     The height in pixels.
+         */
+        [[scriptable]] unsigned int getHeight() const noexcept;
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,50 @@
+#include <easylogging++.h>
+#include <algorithm>
+#include "glyph_rasterizer.h"
+#include "exceptions/invalid_filename_exception.h"
+
+namespace Graphics {
+  namespace UI {
+    GlyphRasterizer::GlyphRasterizer(std::shared_ptr<FT_LibraryRec_> freetype, const std::string& ttf_path, const unsigned int size, const unsigned int pixels_per_unit) :
+      freetype(freetype), ttf_path(ttf_path), size(size), pixels_per_unit(pixels_per_unit), face(nullptr) {
+    }
+
+    GlyphRasterizer::~GlyphRasterizer() {
+      if(face != nullptr)
+        FT_Done_Face(face);
+    }
+
+    bool GlyphRasterizer::rasterize(const unsigned int codepoint, GlyphBitmap& bitmap) {
+      if(face == nullptr) {
+        if(FT_New_Face(freetype.get(), ttf_path.c_str(), 0, &face)) {
+          face = nullptr;
+          throw Exceptions::InvalidFilenameException(ttf_path);
+        }
+        FT_Set_Pixel_Sizes(face, 0, size);
+      }
+
+      if(FT_Load_Char(face, codepoint, FT_LOAD_RENDER)) {
+        LOG(WARNING)<<"Freetype failed to load Glyph: "<<codepoint;
+        return false;
+      }
+
+      auto& glyph_bitmap = face->glyph->bitmap;
+      bitmap.width = glyph_bitmap.width;
+      bitmap.height = glyph_bitmap.rows;
+      bitmap.pixels.resize(bitmap.width * bitmap.height);
+      //Rows can be padded, copy them tightly packed
+      for(unsigned int row = 0; row < bitmap.height; row++) {
+        std::copy(glyph_bitmap.buffer + row * glyph_bitmap.pitch, glyph_bitmap.buffer + row * glyph_bitmap.pitch + bitmap.width, bitmap.pixels.begin() + row * bitmap.width);
+      }
+
+      bitmap.advance = (face->glyph->advance.x >> 6) / (float)pixels_per_unit;
+      bitmap.position = glm::vec2(face->glyph->bitmap_left / (float)pixels_per_unit, ((float)face->glyph->bitmap_top - (float)glyph_bitmap.rows) / (float)pixels_per_unit);
+      bitmap.size = glm::vec2(glyph_bitmap.width / (float)pixels_per_unit, glyph_bitmap.rows / (float)pixels_per_unit);
+      return true;
+    }
+
+    std::string GlyphRasterizer::getTTFPath() const noexcept {
+      return ttf_path;
+    }
+  }
+}
@@ -0,0 +1,78 @@
+#ifndef GLYPH_RASTERIZER_H
+#define GLYPH_RASTERIZER_H
+#include <glm/glm.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+namespace Graphics {
+  namespace UI {
+    /**
+     * @brief      Rendered glyph bitmap and its metrics in our system
+     */
+    struct GlyphBitmap {
+      unsigned int width;
+      unsigned int height;
+      std::vector<unsigned char> pixels;
+      glm::vec2 position;
+      glm::vec2 size;
+      float advance;
+    };
+
+    /**
+     * @brief      Renders single glyphs of a font face with FreeType.
+     *
+     * @detail     The face is only opened when the first glyph is asked for, so fonts whose glyphs
+     * all come from a glyph cache never touch FreeType.
+     */
+    class GlyphRasterizer {
+      private:
+        std::shared_ptr<FT_LibraryRec_> freetype;
+        std::string ttf_path;
+        unsigned int size;
+        unsigned int pixels_per_unit;
+        FT_Face face;
+
+      public:
+        GlyphRasterizer() = delete;
+        /**
+         * @brief      GlyphRasterizer constructor
+         *
+         * @param[in]  freetype         The FreeType library
+         * @param[in]  ttf_path         The ttf path
+         * @param[in]  size             The pixel size
+         * @param[in]  pixels_per_unit  The pixels per unit
+         */
+        GlyphRasterizer(std::shared_ptr<FT_LibraryRec_> freetype, const std::string& ttf_path, const unsigned int size, const unsigned int pixels_per_unit);
+        /**
+         * @brief      Closes the face if it was opened.
+         */
+        ~GlyphRasterizer();
+
+        //Remove copy constructor and assignment
+        GlyphRasterizer(const GlyphRasterizer&) = delete;
+        GlyphRasterizer& operator=(const GlyphRasterizer&) = delete;
+
+        /**
+         * @brief      Renders a glyph.
+         *
+         * @param[in]  codepoint  The unicode codepoint
+         * @param[out] bitmap     The rendered glyph
+         *
+         * @return     False if FreeType couldn't render the glyph, True otherwise.
+         */
+        bool rasterize(const unsigned int codepoint, GlyphBitmap& bitmap);
+
+        /**
+         * @brief      Gets the ttf path.
+         *
+         * @return     The ttf path.
+         */
+        std::string getTTFPath() const noexcept;
+    };
+  }
+}
+
+#endif
@@ -5,7 +5,7 @@
 namespace Graphics {
   namespace UI {
 
-    QuitButton::QuitButton(std::shared_ptr<WrappableText> text, VertexData vertex_data, std::shared_ptr<Skin> skin, const unsigned int layer) : Button(text, vertex_data, skin, layer) {
+    QuitButton::QuitButton(std::shared_ptr<WrappableText> text, const VertexData& vertex_data, std::shared_ptr<Skin> skin, const unsigned int layer) : Button(text, vertex_data, skin, layer) {
       setTextPadding(0.0);
     }
 
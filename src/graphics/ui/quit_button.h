@@ -18,7 +18,7 @@ namespace Graphics {
          * @param[in]  vertex_data  The vertex data
          * @param[in]  skin         The skin
          */
-        [[scriptable]] QuitButton(std::shared_ptr<WrappableText> text, VertexData vertex_data, std::shared_ptr<Skin> skin, const unsigned int layer);
+        [[scriptable]] QuitButton(std::shared_ptr<WrappableText> text, const VertexData& vertex_data, std::shared_ptr<Skin> skin, const unsigned int layer);
         /**
          * @brief      Quit Button factory function
          *
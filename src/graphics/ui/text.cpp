@@ -1,21 +1,28 @@
 #include <easylogging++.h>
+#include <algorithm>
+#include <cstddef>
 #include <glm/ext.hpp>
 #include "text.h"
 #include "graphics/uniform.h"
+#include "utility/utility_functions.h"
 
 namespace Graphics {
   namespace UI {
 
-    Text::Text() : text("text"), font(nullptr), color(1.0), kerning(0.0) {
+    Text::Text() : text("text"), font(nullptr), color(1.0), kerning(0.0), glyphs_dirty(true), first_dirty_vertex(0), vertex_array(nullptr), vertex_buffer(nullptr), vertex_buffer_capacity(0), uploaded_vertex_count(0), streaming_buffer(nullptr), stale_vertex(0), glyphs_streamed(false) {
 
     }
 
     void Text::setFont(const std::shared_ptr<Font> font) {
       this->font = font;
+      invalidateLayout();
     }
 
     void Text::setText(const std::string& text) {
+      if(text == this->text)
+        return;
       this->text = text;
+      invalidateLayout();
     }
 
     std::string Text::getText() const noexcept {
@@ -36,12 +43,17 @@ namespace Graphics {
 
     void Text::setKerning(const float amount) noexcept {
       this->kerning = amount;
+      invalidateLayout();
     }
 
     float Text::getKerning() const noexcept {
       return kerning;
     }
 
+    void Text::setStreamingBuffer(std::shared_ptr<StreamingBuffer> streaming_buffer) {
+      this->streaming_buffer = streaming_buffer;
+    }
+
     std::string Text::to_string() const noexcept {
       std::stringstream str;
       str << Component::to_string() << "Text: "<<text<<" Color: "<<glm::to_string(color)<<" Kerning: "<<kerning;
@@ -52,25 +64,134 @@ namespace Graphics {
       return (unsigned long long)getTransform()->getAbsoluteTranslation().z;
     }
 
-    void Text::renderCharacter(unsigned char character, Transform transform) {
-      Uniform text_texture_uniform;
-      text_texture_uniform.setData<int>("text_texture", 0);
-      shader->setUniform(text_texture_uniform);
+    void Text::appendGlyph(const unsigned int codepoint, const glm::vec2& pen) {
+      auto& glyph = font->getCharacter(codepoint);
+      if(glyph.size.x <= 0.0 || glyph.size.y <= 0.0)
+        return;
 
-      Uniform transform_uniform;
-      transform_uniform.setData<glm::mat4>("transform", getTransform()->getAbsoluteTransformationMatrix() * transform.getAbsoluteTransformationMatrix());
-      shader->setUniform(transform_uniform);
+      auto bottom_left = pen + glyph.position;
+      auto top_right = bottom_left + glyph.size;
+      GlyphVertex top_left_vertex {glm::vec3(bottom_left.x, top_right.y, -0.7), glyph.uv_position};
+      GlyphVertex bottom_left_vertex {glm::vec3(bottom_left.x, bottom_left.y, -0.7), glyph.uv_position + glm::vec2(0.0, glyph.uv_size.y)};
+      GlyphVertex bottom_right_vertex {glm::vec3(top_right.x, bottom_left.y, -0.7), glyph.uv_position + glyph.uv_size};
+      GlyphVertex top_right_vertex {glm::vec3(top_right.x, top_right.y, -0.7), glyph.uv_position + glm::vec2(glyph.uv_size.x, 0.0)};
 
-      glActiveTexture(GL_TEXTURE0);
-      glBindTexture(GL_TEXTURE_2D, font->getCharacter(character).texture_handle);
+      glyph_vertices.push_back(top_left_vertex);
+      glyph_vertices.push_back(bottom_left_vertex);
+      glyph_vertices.push_back(bottom_right_vertex);
+      glyph_vertices.push_back(top_left_vertex);
+      glyph_vertices.push_back(bottom_right_vertex);
+      glyph_vertices.push_back(top_right_vertex);
+      glyph_textures.push_back(glyph.texture_handle);
+    }
+
+    void Text::invalidateLayout() {
+      glyphs_dirty = true;
+    }
 
-      glBindVertexArray(font->getCharacter(character).vertex_array_object);
+    void Text::layoutGlyphs() {
+      first_dirty_vertex = 0;
+      glyph_vertices.clear();
+      glyph_textures.clear();
+      glm::vec2 pen(0.0);
+      for(auto codepoint : Utility::decodeUTF8(text)) {
+        appendGlyph(codepoint, pen);
+        pen.x += font->getCharacter(codepoint).advance + kerning;
+      }
+    }
+
+    void Text::pointGlyphAttributes(const unsigned int buffer_object, const unsigned int offset) {
+      glBindVertexArray(vertex_array->getObject());
+      glBindBuffer(GL_ARRAY_BUFFER, buffer_object);
+      glVertexAttribPointer(VertexData::DATA_TYPE::GEOMETRY, 3, GL_FLOAT, GL_FALSE, sizeof(GlyphVertex), (void*)(offset + offsetof(GlyphVertex, position)));
+      glVertexAttribPointer(VertexData::DATA_TYPE::TEX_COORDS, 2, GL_FLOAT, GL_FALSE, sizeof(GlyphVertex), (void*)(offset + offsetof(GlyphVertex, uv)));
+      glBindBuffer(GL_ARRAY_BUFFER, 0);
+      glBindVertexArray(0);
+    }
+
+    void Text::writeVertexBuffer() {
+      glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer->getObject());
+      if(glyph_vertices.size() > vertex_buffer_capacity) {
+        vertex_buffer_capacity = glyph_vertices.size();
+        glBufferData(GL_ARRAY_BUFFER, vertex_buffer_capacity * sizeof(GlyphVertex), &glyph_vertices[0], GL_DYNAMIC_DRAW);
+        vertex_buffer->setBytes(vertex_buffer_capacity * sizeof(GlyphVertex));
+      }
+      else if(glyph_vertices.size() > stale_vertex) {
+        glBufferSubData(GL_ARRAY_BUFFER, stale_vertex * sizeof(GlyphVertex), (glyph_vertices.size() - stale_vertex) * sizeof(GlyphVertex), &glyph_vertices[stale_vertex]);
+      }
+      glBindBuffer(GL_ARRAY_BUFFER, 0);
+      stale_vertex = glyph_vertices.size();
+
+      if(glyphs_streamed) {
+        pointGlyphAttributes(vertex_buffer->getObject(), 0);
+        glyphs_streamed = false;
+      }
+    }
+
+    void Text::uploadGlyphs() {
+      if(vertex_array == nullptr) {
+        vertex_array = GPUResourceRegistry::create(GPUResourceType::VERTEX_ARRAY);
+        vertex_buffer = GPUResourceRegistry::create(GPUResourceType::BUFFER);
+
+        glBindVertexArray(vertex_array->getObject());
+        glEnableVertexAttribArray(VertexData::DATA_TYPE::GEOMETRY);
+        glEnableVertexAttribArray(VertexData::DATA_TYPE::TEX_COORDS);
+        glBindVertexArray(0);
+        pointGlyphAttributes(vertex_buffer->getObject(), 0);
+      }
 
-      if(font->getCharacter(character).vertex_data.getIndexCount() > 0) {
-        glDrawElements(GL_TRIANGLES, font->getCharacter(character).vertex_data.getIndexCount(), GL_UNSIGNED_INT, 0);
+      //Streamed vertices are only valid this frame, the vertex buffer is written once the text stops changing
+      stale_vertex = std::min(stale_vertex, first_dirty_vertex);
+      if(streaming_buffer != nullptr) {
+        auto allocation = streaming_buffer->upload(glyph_vertices);
+        pointGlyphAttributes(allocation.buffer_object, allocation.offset);
+        glyphs_streamed = true;
       }
       else {
-        glDrawArrays(GL_TRIANGLES, 0, font->getCharacter(character).vertex_data.getVertexCount());
+        writeVertexBuffer();
+      }
+
+      uploaded_vertex_count = glyph_vertices.size();
+
+      //Batches before the first changed vertex are still valid, the last of them may need trimming
+      while(!glyph_batches.empty() && glyph_batches.back().first_vertex >= first_dirty_vertex)
+        glyph_batches.pop_back();
+      if(!glyph_batches.empty() && glyph_batches.back().first_vertex + glyph_batches.back().vertex_count > first_dirty_vertex)
+        glyph_batches.back().vertex_count = first_dirty_vertex - glyph_batches.back().first_vertex;
+
+      for(unsigned int quad = first_dirty_vertex / 6; quad < glyph_textures.size(); quad++) {
+        if(glyph_batches.empty() || glyph_batches.back().texture_handle != glyph_textures[quad])
+          glyph_batches.push_back(GlyphBatch {glyph_textures[quad], quad * 6, 0});
+        glyph_batches.back().vertex_count += 6;
+      }
+    }
+
+    void Text::renderGlyphs() {
+      if(font == nullptr)
+        return;
+
+      if(glyphs_dirty) {
+        layoutGlyphs();
+        uploadGlyphs();
+        glyphs_dirty = false;
+      }
+      else if(glyphs_streamed) {
+        writeVertexBuffer();
+      }
+
+      if(uploaded_vertex_count == 0)
+        return;
+
+      shader->setUniform<int>("text_texture", 0);
+      shader->setUniform<glm::vec4>("color", color);
+      shader->setUniform<glm::mat4>("transform", getTransform()->getAbsoluteTransformationMatrix());
+      shader->useProgram();
+
+      glActiveTexture(GL_TEXTURE0);
+      glBindVertexArray(vertex_array->getObject());
+      for(auto& batch : glyph_batches) {
+        glBindTexture(GL_TEXTURE_2D, batch.texture_handle);
+        glDrawArrays(GL_TRIANGLES, batch.first_vertex, batch.vertex_count);
       }
     }
 
@@ -90,21 +211,9 @@ namespace Graphics {
     }
 
     bool Text::onUpdate(const double delta) {
-      Uniform color_uniform;
-      color_uniform.setData<glm::vec4>("color", color);
-      shader->setUniform(color_uniform);
-
       if(isActive()) {
         if(shader != nullptr) {
-
-          auto character_transform = *getTransform();
-
-          shader->useProgram();
-
-          for(auto character : text) {
-            renderCharacter(character, character_transform);
-            character_transform.translate(glm::vec2(font->getCharacter(character).advance + kerning, 0.0));
-          }
+          renderGlyphs();
         }
         else {
           LOG(WARNING)<<"Trying to render renderable with nullptr shader";
@@ -2,32 +2,103 @@
 #define TEXT_H
 #include <glm/glm.hpp>
 #include <memory>
+#include <vector>
 #include "../../component.h"
 #include "../../transform.h"
 #include "font.h"
 #include "../vertex_data.h"
 #include "../shader.h"
+#include "../gpu_resource.h"
+#include "../streaming_buffer.h"
 
 namespace Graphics {
   namespace UI {
     /**
      * @brief      Class for text.
+     *
+     * @detail     The text is UTF-8. The glyph quads of the whole text are kept in one vertex buffer that
+     * samples the font's atlas pages, so drawing a text is one draw call per page it uses. The buffer
+     * is only rebuilt after the text or anything affecting its layout changes. With a StreamingBuffer,
+     * the quads of a frame the text changed in are written to it instead, and the text's own buffer
+     * catches up on the next frame it doesn't change.
      */
     class [[scriptable]] Text : public Component {
       protected:
+        /**
+         * @brief      Vertex of a glyph quad, in the text's local space
+         */
+        struct GlyphVertex {
+          glm::vec3 position;
+          glm::vec2 uv;
+        };
+
         std::shared_ptr<Font> font;
         std::string text;
         glm::vec4 color;
         std::shared_ptr<Shader> shader;
         float kerning;
 
-        void renderCharacter(const unsigned char character, Transform transform);
+        std::vector<GlyphVertex> glyph_vertices;
+        //Atlas page texture of every quad in glyph_vertices
+        std::vector<unsigned int> glyph_textures;
+        bool glyphs_dirty;
+        //Vertices before this one were kept by the last layout and don't need uploading again
+        unsigned int first_dirty_vertex;
+
+        /**
+         * @brief      Appends the quad of a character to the glyph vertices.
+         *
+         * @param[in]  codepoint  The unicode codepoint of the character
+         * @param[in]  pen        The pen position the character is placed at
+         */
+        void appendGlyph(const unsigned int codepoint, const glm::vec2& pen);
+        /**
+         * @brief      Rebuilds the glyph vertices from the text.
+         */
+        virtual void layoutGlyphs();
+        /**
+         * @brief      Marks the whole layout as out of date.
+         */
+        virtual void invalidateLayout();
+        /**
+         * @brief      Lays out and uploads the glyphs if they changed, then draws them.
+         */
+        void renderGlyphs();
+
+      private:
+        /**
+         * @brief      Run of quads sampling the same atlas page
+         */
+        struct GlyphBatch {
+          unsigned int texture_handle;
+          unsigned int first_vertex;
+          unsigned int vertex_count;
+        };
+
+        std::vector<GlyphBatch> glyph_batches;
+        std::shared_ptr<GPUResource> vertex_array;
+        std::shared_ptr<GPUResource> vertex_buffer;
+        unsigned int vertex_buffer_capacity;
+        unsigned int uploaded_vertex_count;
+        std::shared_ptr<StreamingBuffer> streaming_buffer;
+        //Vertices from this one on are newer than what the vertex buffer holds
+        unsigned int stale_vertex;
+        //The vertex array points into the streaming buffer
+        bool glyphs_streamed;
+
+        void uploadGlyphs();
+        void writeVertexBuffer();
+        void pointGlyphAttributes(const unsigned int buffer_object, const unsigned int offset);
 
       public:
         /**
          * @brief      Constructor for Text
          */
         [[scriptable]] Text();
+
+        //Remove copy constructor and assignment
+        Text(const Text&) = delete;
+        Text& operator=(const Text&) = delete;
         /**
          * @brief      Sets the font.
          *
@@ -76,6 +147,12 @@ namespace Graphics {
          * @return     The kerning.
          */
         [[scriptable]] float getKerning() const noexcept;
+        /**
+         * @brief      Sets the buffer the glyphs of a frame the text changed in are streamed through.
+         *
+         * @param[in]  streaming_buffer  The streaming buffer, nullptr to always write the text's own buffer
+         */
+        [[scriptable]] void setStreamingBuffer(std::shared_ptr<StreamingBuffer> streaming_buffer);
         /**
          * @brief      Returns a string representation of the object.
          *
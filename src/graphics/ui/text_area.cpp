@@ -5,7 +5,7 @@
 namespace Graphics {
   namespace UI {
 
-    TextArea::TextArea(std::shared_ptr<WrappableText> text, VertexData vertex_data, std::shared_ptr<Skin> skin, const unsigned int layer) : Area(vertex_data, skin, layer), text(text) {
+    TextArea::TextArea(std::shared_ptr<WrappableText> text, const VertexData& vertex_data, std::shared_ptr<Skin> skin, const unsigned int layer) : Area(vertex_data, skin, layer), text(text) {
       getTransform()->addChild(text->getTransform());
     }
 
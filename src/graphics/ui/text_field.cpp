@@ -11,7 +11,7 @@
 namespace Graphics {
   namespace UI {
 
-    TextField::TextField(std::shared_ptr<WrappableText> default_text, std::shared_ptr<WrappableText> typed_text, VertexData vertex_data, std::shared_ptr<Skin> skin, const unsigned int layer) : TextArea(default_text, vertex_data, skin, layer), typed_text(typed_text), default_text(default_text), caret(">"), blink_speed(0.5), in_focus(false), current_typed("") {
+    TextField::TextField(std::shared_ptr<WrappableText> default_text, std::shared_ptr<WrappableText> typed_text, const VertexData& vertex_data, std::shared_ptr<Skin> skin, const unsigned int layer) : TextArea(default_text, vertex_data, skin, layer), typed_text(typed_text), default_text(default_text), caret(">"), blink_speed(0.5), in_focus(false), current_typed("") {
       typed_color = typed_text->getColor();
       setText(default_text);
     }
@@ -118,7 +118,7 @@ namespace Graphics {
 
       if(in_focus) {
         if(key == GLFW_KEY_BACKSPACE) {
-          typed_text->setText(typed_text->getText().substr(0, typed_text->getText().size() - 1));
+          eraseLastCharacter();
         }
         else if(key == GLFW_KEY_ENTER) {
           notifyNow(Utility::DebugCommandEvent::create(typed_text->getText()));
@@ -128,13 +128,25 @@ namespace Graphics {
       }
     }
 
+    void TextField::eraseLastCharacter() {
+      auto text = typed_text->getText();
+      if(text.empty())
+        return;
+
+      //Drop the whole UTF-8 sequence, not just its last byte
+      auto end = text.size() - 1;
+      while(end > 0 && ((unsigned char)text[end] & 0xC0) == 0x80)
+        end--;
+      typed_text->setText(text.substr(0, end));
+    }
+
     void TextField::onKeyUp(const int key) {
     }
 
     void TextField::onKeyRepeat(const int key) {
       if(in_focus) {
         if(key == GLFW_KEY_BACKSPACE) {
-          typed_text->setText(typed_text->getText().substr(0, typed_text->getText().size() - 1));
+          eraseLastCharacter();
         }
       }
     }
@@ -19,6 +19,7 @@ namespace Graphics {
         glm::vec4 typed_color;
 
         void reset();
+        void eraseLastCharacter();
       protected:
         const glm::vec4 mouse_over_dim = glm::vec4(0.1, 0.1, 0.1, 0.0);
       public:
@@ -31,7 +32,7 @@ namespace Graphics {
          * @param[in]  vertex_data   The vertex data
          * @param[in]  skin          The skin
          */
-        [[scriptable]] TextField(std::shared_ptr<WrappableText> default_text, std::shared_ptr<WrappableText> typed_text, VertexData vertex_data, std::shared_ptr<Skin> skin, const unsigned int layer);
+        [[scriptable]] TextField(std::shared_ptr<WrappableText> default_text, std::shared_ptr<WrappableText> typed_text, const VertexData& vertex_data, std::shared_ptr<Skin> skin, const unsigned int layer);
         /**
          * @brief      TextField factory function
          *
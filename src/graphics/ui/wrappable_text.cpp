@@ -1,143 +1,127 @@
 #include <easylogging++.h>
 #include <glm/ext.hpp>
 #include "graphics/ui/wrappable_text.h"
+#include "utility/utility_functions.h"
 
 namespace Graphics {
   namespace UI {
-    WrappableText::WrappableText() : line_spacing(0.175), horizontal_alignment(HorizontalAlignment::LEFT), vertical_alignment(VerticalAlignment::TOP), horizontal_alignment_transform(Transform()), vertical_alignment_transform(Transform()) {
+    WrappableText::WrappableText() : width(0.0), height(0.0), line_spacing(0.175), horizontal_alignment(HorizontalAlignment::LEFT), vertical_alignment(VerticalAlignment::TOP), relayout_from(0) {
 
     }
 
     void WrappableText::setHorizontalAlignment(const HorizontalAlignment& alignment) {
       this->horizontal_alignment = alignment;
+      invalidateLayout();
     }
 
     void WrappableText::setVerticalAlignment(const VerticalAlignment& alignment) {
       this->vertical_alignment = alignment;
+      invalidateLayout();
     }
 
     void WrappableText::setSize(float width, float height) {
       this->width = width;
       this->height = height;
+      invalidateLayout();
     }
 
     void WrappableText::setLineSpacing(float spacing) {
       this->line_spacing = spacing;
+      invalidateLayout();
     }
 
-    std::vector<std::pair<float, std::vector<Character>>> WrappableText::splitTextIntoLines() {
-      std::vector<std::pair<float, std::vector<Character>>> lines;
-      std::vector<Character> line;
-      float current_line_width = 0.0;
-      for(auto character : text) {
-        if((character != '\n' && current_line_width + font->getCharacter(character).advance + kerning > width) || character == '\n') {
-          lines.push_back(std::pair<float, std::vector<Character>>(current_line_width, line));
-          line.clear();
-          if(character != '\n') {
-            line.push_back(font->getCharacter(character));
-            current_line_width = font->getCharacter(character).advance + kerning;
-          }
-          else {
-            current_line_width = 0.0;
-          }
-        }
-        else {
-          line.push_back(font->getCharacter(character));
-          current_line_width += font->getCharacter(character).advance + kerning;
-        }
-      }
-      lines.push_back(std::pair<float, std::vector<Character>>(current_line_width, line));
-      return lines;
+    void WrappableText::invalidateLayout() {
+      Text::invalidateLayout();
+      relayout_from = 0;
     }
 
-
     void WrappableText::setText(const std::string& text) {
-      this->text = text;
-      character_transforms.clear();
+      if(text == this->text)
+        return;
 
-      unsigned int number_of_lines = 0;
+      auto new_codepoints = Utility::decodeUTF8(text);
+      unsigned int common_prefix = 0;
+      while(common_prefix < codepoints.size() && common_prefix < new_codepoints.size() && codepoints[common_prefix] == new_codepoints[common_prefix])
+        common_prefix++;
 
-      std::string text_without_newlines = text;
-      while(text_without_newlines.find_first_of('\n') != std::string::npos) {
-        text_without_newlines.erase(text_without_newlines.find_first_of('\n'), 1);
-      }
+      this->text = text;
+      codepoints.swap(new_codepoints);
+      if(common_prefix < relayout_from)
+        relayout_from = common_prefix;
+      glyphs_dirty = true;
+    }
 
-      if(horizontal_alignment == HorizontalAlignment::LEFT) {
-        Transform t;
-        float current_width = 0.0;
-        number_of_lines = 1;
-        t.translate(glm::vec2(-width / 2.0, 0.0));
-        for(auto character : this->text) {
-          if(current_width + font->getCharacter(character).size.x > width || character == '\n') {
-            current_width = 0.0;
-            t.translate(glm::vec2(-t.getAbsoluteTranslation().x - width / 2.0, -font->getOpenGLSize() - line_spacing));
-            number_of_lines++;
-          }
-          character_transforms.insert(std::pair<unsigned char, Transform>(character, t));
-          t.translate(glm::vec2(font->getCharacter(character).advance + kerning, 0.0));
-          current_width += font->getCharacter(character).advance;
-        }
-      }
-      else if(horizontal_alignment == HorizontalAlignment::HCENTER) {
-        auto lines = splitTextIntoLines();
-
-        unsigned int character_index = 0;
-        unsigned int line_number = 0;
-        for(auto line : lines) {
-          Transform character_transform;
-          character_transform.translate(glm::vec2(-line.first / 2.0, -(font->getOpenGLSize() + line_spacing) * line_number));
-          for(auto character : line.second) {
-            character_transforms.insert(std::pair<unsigned char, Transform>(text_without_newlines[character_index], character_transform));
-            character_index++;
-            character_transform.translate(glm::vec2(character.advance + kerning, 0.0));
-          }
-          line_number++;
-        }
-        number_of_lines = line_number;
-      }
-      else {
-        auto lines = splitTextIntoLines();
-        unsigned int line_number = 0;
-        std::string line_text= text.substr(0, lines[0].second.size());
-        unsigned int last_position = 0;
-
-        for(auto line : lines) {
-          Transform character_transform;
-
-          character_transform.translate(glm::vec2(width / 2.0, -font->getOpenGLSize() * line_number - line_spacing));
-
-          if(line_number > 0) {
-            line_text = text.substr(last_position, line.second.size());
-          }
-
-          for(struct {std::vector<Character>::reverse_iterator character; std::string::reverse_iterator text_char;} iter = {line.second.rbegin(), line_text.rbegin()};
-                      iter.character != line.second.rend() && iter.text_char != line_text.rend(); iter.character++, iter.text_char++) {
-            character_transform.translate(glm::vec2(-iter.character->advance - kerning, 0.0));
-            character_transforms.insert(std::pair<unsigned char, Transform>(*iter.text_char, character_transform));
-          }
-          last_position += line_text.size();
-          line_number++;
-        }
-        number_of_lines = line_number;
+    void WrappableText::layoutGlyphs() {
+      //Whether a line breaks depends on the character after it, so start at the line before the change
+      unsigned int restart_line = 0;
+      if(relayout_from > 0) {
+        while(restart_line + 1 < lines.size() && lines[restart_line + 1].first_codepoint <= relayout_from - 1)
+          restart_line++;
       }
 
-      float text_body_height = number_of_lines * (font->getOpenGLSize() + line_spacing) ;
-      float vertical_alignment_y = 0.0;
-      vertical_alignment_transform = Transform();
+      Line line {0, 0, 0.0};
+      if(restart_line < lines.size())
+        line = lines[restart_line];
+      line.width = 0.0;
 
+      lines.resize(restart_line);
+      glyph_vertices.resize(line.first_vertex);
+      glyph_textures.resize(line.first_vertex / 6);
+      first_dirty_vertex = line.first_vertex;
+
+      float vertical_offset = 0.0;
       if(vertical_alignment == VerticalAlignment::TOP) {
-        vertical_alignment_y = (height - font->getOpenGLSize()) / 2.0;
+        vertical_offset = (height - font->getOpenGLSize()) / 2.0;
       }
       else if(vertical_alignment == VerticalAlignment::VCENTER) {
-        vertical_alignment_y = -font->getOpenGLSize() / 2.0;
+        vertical_offset = -font->getOpenGLSize() / 2.0;
       }
       else {
-        vertical_alignment_y = -height / 2.0;
+        vertical_offset = -height / 2.0;
+      }
+
+      //Codepoints of the current line with their pen position from the start of the line
+      std::vector<std::pair<unsigned int, float>> line_glyphs;
+      for(unsigned int i = line.first_codepoint; i < codepoints.size(); i++) {
+        auto codepoint = codepoints[i];
+        if(codepoint == '\n') {
+          finishLine(line, line_glyphs, vertical_offset);
+          line = Line {i + 1, 0, 0.0};
+          line_glyphs.clear();
+          continue;
+        }
+
+        auto advance = font->getCharacter(codepoint).advance + kerning;
+        if(!line_glyphs.empty() && line.width + advance > width) {
+          finishLine(line, line_glyphs, vertical_offset);
+          line = Line {i, 0, 0.0};
+          line_glyphs.clear();
+        }
+
+        line_glyphs.push_back(std::make_pair(codepoint, line.width));
+        line.width += advance;
       }
+      finishLine(line, line_glyphs, vertical_offset);
 
-      vertical_alignment_transform.translate(glm::vec2(0.0, vertical_alignment_y));
+      relayout_from = codepoints.size();
     }
 
+    void WrappableText::finishLine(Line& line, const std::vector<std::pair<unsigned int, float>>& line_glyphs, const float vertical_offset) {
+      float line_x = 0.0;
+      if(horizontal_alignment == HorizontalAlignment::LEFT)
+        line_x = -width / 2.0;
+      else if(horizontal_alignment == HorizontalAlignment::HCENTER)
+        line_x = -line.width / 2.0;
+      else
+        line_x = width / 2.0 - line.width;
+      float line_y = vertical_offset - (font->getOpenGLSize() + line_spacing) * lines.size();
+
+      line.first_vertex = glyph_vertices.size();
+      for(auto& glyph : line_glyphs) {
+        appendGlyph(glyph.first, glm::vec2(line_x + glyph.second, line_y));
+      }
+      lines.push_back(line);
+    }
 
     void WrappableText::onDestroy() {
 
@@ -149,15 +133,7 @@ namespace Graphics {
     bool WrappableText::onUpdate(const double delta) {
       if(isActive()) {
         if(shader != nullptr) {
-          Uniform color_uniform;
-          color_uniform.setData<glm::vec4>("color", color);
-          shader->setUniform(color_uniform);
-
-          shader->useProgram();
-          shader->setUniform<glm::vec4>("color", color);
-          for(auto transform : character_transforms) {
-            renderCharacter(transform.first, vertical_alignment_transform * transform.second);
-          }
+          renderGlyphs();
         }
         else {
           LOG(WARNING)<<"Trying to render renderable with nullptr shader";
@@ -1,13 +1,18 @@
 #ifndef WRAPPABLE_TEXT_H
 #define WRAPPABLE_TEXT_H
 
-#include <map>
+#include <utility>
+#include <vector>
 #include "text.h"
 
 namespace Graphics {
   namespace UI {
     /**
      * @brief      Class for wrappable text.
+     *
+     * @detail     The layout is cached per line. When the text changes, only the lines from the one holding
+     * the first changed character onwards are laid out and uploaded again, so appending to or erasing
+     * from the end of a long text costs as much as the last line.
      */
     class [[scriptable]] WrappableText : public Text {
       public:
@@ -20,16 +25,32 @@ namespace Graphics {
          */
         enum [[scriptable]] VerticalAlignment : unsigned int { TOP, VCENTER, BOTTOM};
       private:
+        /**
+         * @brief      Metrics of a laid out line
+         */
+        struct Line {
+          //Index of the line's first codepoint
+          unsigned int first_codepoint;
+          //Index of the line's first glyph vertex
+          unsigned int first_vertex;
+          float width;
+        };
+
         float width;
         float height;
         VerticalAlignment vertical_alignment;
         HorizontalAlignment horizontal_alignment;
-        Transform horizontal_alignment_transform;
-        Transform vertical_alignment_transform;
-        std::multimap<unsigned char, Transform> character_transforms;
         float line_spacing;
+
+        std::vector<unsigned int> codepoints;
+        std::vector<Line> lines;
+        //Codepoints from here on changed since the last layout
+        unsigned int relayout_from;
+
+        void finishLine(Line& line, const std::vector<std::pair<unsigned int, float>>& line_glyphs, const float vertical_offset);
       protected:
-        std::vector<std::pair<float, std::vector<Character>>> splitTextIntoLines();
+        virtual void layoutGlyphs() override;
+        virtual void invalidateLayout() override;
       public:
 
         /**
@@ -1,258 +1,174 @@
+#ifdef __APPLE__
+#include <OpenGL/gl3.h>
+#else
+#include <glad/glad.h>
+#endif
+#include <cstring>
+#include <sstream>
+#include <type_traits>
+#include <glm/gtc/type_ptr.hpp>
 #include "graphics/uniform.h"
 #include <easylogging++.h>
 
 namespace Graphics {
-  Uniform::Uniform() : name(""), dirty(false) {
+  namespace {
+    //The components of a value, glm types aren't trivially copyable so they're copied through value_ptr
+    template<typename T>
+    auto components(T& value) -> decltype(glm::value_ptr(value)) {
+      return glm::value_ptr(value);
+    }
+
+    template<typename T>
+    typename std::enable_if<std::is_arithmetic<T>::value, T*>::type components(T& value) {
+      return &value;
+    }
   }
 
-  template<>
-  void Uniform::setData<float>(const std::string& name, const float& data) {
-    if(name == this->name && data == float_data)
+  Uniform::Uniform() : uniform_type(UniformTypes::FLOAT), name(""), data(), data_size(0), dirty(false) {
+  }
+
+  template<typename T>
+  void Uniform::store(const std::string& name, const UniformTypes type, const T& value) {
+    static_assert(sizeof(T) <= sizeof(data), "Uniform type is larger than its storage");
+    if(type == uniform_type && name == this->name && std::memcmp(data, components(value), sizeof(T)) == 0)
       return;
-    uniform_type = UniformTypes::FLOAT;
-    float_data = data;
+    uniform_type = type;
+    std::memcpy(data, components(value), sizeof(T));
+    data_size = sizeof(T);
     this->name = name;
     dirty = true;
   }
 
+  template<typename T>
+  T Uniform::load() const noexcept {
+    T value;
+    std::memcpy(components(value), data, sizeof(T));
+    return value;
+  }
+
+  template<>
+  void Uniform::setData<float>(const std::string& name, const float& data) {
+    store(name, UniformTypes::FLOAT, data);
+  }
+
   template<>
   void Uniform::setData<glm::vec2>(const std::string& name, const glm::vec2& data) {
-    if(name == this->name && data == vec2_data)
-      return;
-    uniform_type = UniformTypes::VEC2;
-    vec2_data = data;
-    this->name = name;
-    dirty = true;
+    store(name, UniformTypes::VEC2, data);
   }
 
   template<>
   void Uniform::setData<glm::vec3>(const std::string& name, const glm::vec3& data) {
-    if(name == this->name && data == vec3_data)
-      return;
-    uniform_type = UniformTypes::VEC3;
-    vec3_data = data;
-    this->name = name;
-    dirty = true;
+    store(name, UniformTypes::VEC3, data);
   }
 
   template<>
   void Uniform::setData<glm::vec4>(const std::string& name, const glm::vec4& data) {
-    if(name == this->name && data == vec4_data)
-      return;
-    uniform_type = UniformTypes::VEC4;
-    vec4_data = data;
-    this->name = name;
-    dirty = true;
+    store(name, UniformTypes::VEC4, data);
   }
 
   template<>
   void Uniform::setData<int>(const std::string& name, const int& data) {
-    if(name == this->name && data == int_data)
-      return;
-    uniform_type = UniformTypes::INT;
-    int_data = data;
-    this->name = name;
-    dirty = true;
+    store(name, UniformTypes::INT, data);
   }
 
   template<>
   void Uniform::setData<glm::ivec2>(const std::string& name, const glm::ivec2& data) {
-    if(name == this->name && data == ivec2_data)
-      return;
-    uniform_type = UniformTypes::IVEC2;
-    ivec2_data = data;
-    this->name = name;
-    dirty = true;
+    store(name, UniformTypes::IVEC2, data);
   }
 
   template<>
   void Uniform::setData<glm::ivec3>(const std::string& name, const glm::ivec3& data) {
-    if(name == this->name && data == ivec3_data)
-      return;
-    uniform_type = UniformTypes::IVEC3;
-    ivec3_data = data;
-    this->name = name;
-    dirty = true;
+    store(name, UniformTypes::IVEC3, data);
   }
 
   template<>
   void Uniform::setData<glm::ivec4>(const std::string& name, const glm::ivec4& data) {
-    if(name == this->name && data == ivec4_data)
-      return;
-    uniform_type = UniformTypes::IVEC4;
-    ivec4_data = data;
-    this->name = name;
-    dirty = true;
+    store(name, UniformTypes::IVEC4, data);
   }
 
   template<>
   void Uniform::setData<unsigned int>(const std::string& name, const unsigned int& data) {
-    if(name == this->name && data == uint_data)
-      return;
-    uniform_type = UniformTypes::UINT;
-    uint_data = data;
-    this->name = name;
-    dirty = true;
+    store(name, UniformTypes::UINT, data);
   }
 
   template<>
   void Uniform::setData<glm::uvec2>(const std::string& name, const glm::uvec2& data) {
-    if(name == this->name && data == uvec2_data)
-      return;
-    uniform_type = UniformTypes::UVEC2;
-    uvec2_data = data;
-    this->name = name;
-    dirty = true;
+    store(name, UniformTypes::UVEC2, data);
   }
 
   template<>
   void Uniform::setData<glm::uvec3>(const std::string& name, const glm::uvec3& data) {
-    if(name == this->name && data == uvec3_data)
-      return;
-    uniform_type = UniformTypes::UVEC3;
-    uvec3_data = data;
-    this->name = name;
-    dirty = true;
+    store(name, UniformTypes::UVEC3, data);
   }
 
   template<>
   void Uniform::setData<glm::uvec4>(const std::string& name, const glm::uvec4& data) {
-    if(name == this->name && data == uvec4_data)
-      return;
-    uniform_type = UniformTypes::UVEC4;
-    uvec4_data = data;
-    this->name = name;
-    dirty = true;
+    store(name, UniformTypes::UVEC4, data);
   }
 
   template<>
   void Uniform::setData<bool>(const std::string& name, const bool& data) {
-    if(name == this->name && data == bool_data)
-      return;
-    uniform_type = UniformTypes::BOOL;
-    bool_data = data;
-    this->name = name;
-    dirty = true;
+    store(name, UniformTypes::BOOL, data);
   }
 
   template<>
   void Uniform::setData<glm::bvec2>(const std::string& name, const glm::bvec2& data) {
-    if(name == this->name && data == bvec2_data)
-      return;
-    uniform_type = UniformTypes::VEC2;
-    bvec2_data = data;
-    this->name = name;
-    dirty = true;
+    store(name, UniformTypes::BVEC2, data);
   }
 
   template<>
   void Uniform::setData<glm::bvec3>(const std::string& name, const glm::bvec3& data) {
-    if(name == this->name && data == bvec3_data)
-      return;
-    uniform_type = UniformTypes::VEC3;
-    bvec3_data = data;
-    this->name = name;
-    dirty = true;
+    store(name, UniformTypes::BVEC3, data);
   }
 
   template<>
   void Uniform::setData<glm::bvec4>(const std::string& name, const glm::bvec4& data) {
-    if(name == this->name && data == bvec4_data)
-      return;
-    uniform_type = UniformTypes::BVEC4;
-    bvec4_data = data;
-    this->name = name;
-    dirty = true;
+    store(name, UniformTypes::BVEC4, data);
   }
 
   template<>
   void Uniform::setData<glm::mat2>(const std::string& name, const glm::mat2& data) {
-    if(name == this->name && data == mat2_data)
-      return;
-    uniform_type = UniformTypes::MAT2;
-    mat2_data = data;
-    this->name = name;
-    dirty = true;
+    store(name, UniformTypes::MAT2, data);
   }
 
   template<>
   void Uniform::setData<glm::mat3>(const std::string& name, const glm::mat3& data) {
-    if(name == this->name && data == mat3_data)
-      return;
-    uniform_type = UniformTypes::MAT3;
-    mat3_data = data;
-    this->name = name;
-    dirty = true;
+    store(name, UniformTypes::MAT3, data);
   }
 
   template<>
   void Uniform::setData<glm::mat4>(const std::string& name, const glm::mat4& data) {
-    if(name == this->name && data == mat4_data)
-      return;
-    uniform_type = UniformTypes::MAT4;
-    mat4_data = data;
-    this->name = name;
-    dirty = true;
+    store(name, UniformTypes::MAT4, data);
   }
 
   template<>
   void Uniform::setData<glm::mat2x3>(const std::string& name, const glm::mat2x3& data) {
-    if(name == this->name && data == mat23_data)
-      return;
-    uniform_type = UniformTypes::MAT23;
-    mat23_data = data;
-    this->name = name;
-    dirty = true;
+    store(name, UniformTypes::MAT23, data);
   }
 
   template<>
   void Uniform::setData<glm::mat3x2>(const std::string& name, const glm::mat3x2& data) {
-    if(name == this->name && data == mat32_data)
-      return;
-    uniform_type = UniformTypes::MAT32;
-    mat32_data = data;
-    this->name = name;
-    dirty = true;
+    store(name, UniformTypes::MAT32, data);
   }
 
   template<>
   void Uniform::setData<glm::mat2x4>(const std::string& name, const glm::mat2x4& data) {
-    if(name == this->name && data == mat24_data)
-      return;
-    uniform_type = UniformTypes::MAT24;
-    mat24_data = data;
-    this->name = name;
-    dirty = true;
+    store(name, UniformTypes::MAT24, data);
   }
 
   template<>
   void Uniform::setData<glm::mat4x2>(const std::string& name, const glm::mat4x2& data) {
-    if(name == this->name && data == mat42_data)
-      return;
-    uniform_type = UniformTypes::MAT42;
-    mat42_data = data;
-    this->name = name;
-    dirty = true;
+    store(name, UniformTypes::MAT42, data);
   }
 
   template<>
   void Uniform::setData<glm::mat3x4>(const std::string& name, const glm::mat3x4& data) {
-    if(name == this->name && data == mat34_data)
-      return;
-    uniform_type = UniformTypes::MAT34;
-    mat34_data = data;
-    this->name = name;
-    dirty = true;
+    store(name, UniformTypes::MAT34, data);
   }
 
   template<>
   void Uniform::setData<glm::mat4x3>(const std::string& name, const glm::mat4x3& data) {
-    if(name == this->name && data == mat43_data)
-      return;
-    uniform_type = UniformTypes::MAT43;
-    mat43_data = data;
-    this->name = name;
-    dirty = true;
+    store(name, UniformTypes::MAT43, data);
   }
 
   Uniform::UniformTypes Uniform::getType() const noexcept {
@@ -273,220 +189,222 @@ namespace Graphics {
 
   template<>
   float Uniform::getData<float>() const noexcept {
-    return float_data;
+    return load<float>();
   }
 
   template<>
   glm::vec2 Uniform::getData<glm::vec2>() const noexcept {
-    return vec2_data;
+    return load<glm::vec2>();
   }
 
   template<>
   glm::vec3 Uniform::getData<glm::vec3>() const noexcept {
-    return vec3_data;
+    return load<glm::vec3>();
   }
 
   template<>
   glm::vec4 Uniform::getData<glm::vec4>() const noexcept {
-    return vec4_data;
+    return load<glm::vec4>();
   }
 
   template<>
   int Uniform::getData<int>() const noexcept {
-    return int_data;
+    return load<int>();
   }
 
   template<>
   glm::ivec2 Uniform::getData<glm::ivec2>() const noexcept {
-    return ivec2_data;
+    return load<glm::ivec2>();
   }
 
   template<>
   glm::ivec3 Uniform::getData<glm::ivec3>() const noexcept {
-    return ivec3_data;
+    return load<glm::ivec3>();
   }
 
   template<>
   glm::ivec4 Uniform::getData<glm::ivec4>() const noexcept {
-    return ivec4_data;
+    return load<glm::ivec4>();
   }
 
   template<>
   unsigned int Uniform::getData<unsigned int>() const noexcept {
-    return uint_data;
+    return load<unsigned int>();
   }
 
   template<>
   glm::uvec2 Uniform::getData<glm::uvec2>() const noexcept {
-    return uvec2_data;
+    return load<glm::uvec2>();
   }
 
   template<>
   glm::uvec3 Uniform::getData<glm::uvec3>() const noexcept {
-    return uvec3_data;
+    return load<glm::uvec3>();
   }
 
   template<>
   glm::uvec4 Uniform::getData<glm::uvec4>() const noexcept {
-    return uvec4_data;
+    return load<glm::uvec4>();
   }
 
   template<>
   bool Uniform::getData<bool>() const noexcept {
-    return bool_data;
+    return load<bool>();
   }
 
   template<>
   glm::bvec2 Uniform::getData<glm::bvec2>() const noexcept {
-    return bvec2_data;
+    return load<glm::bvec2>();
   }
 
   template<>
   glm::bvec3 Uniform::getData<glm::bvec3>() const noexcept {
-    return bvec3_data;
+    return load<glm::bvec3>();
   }
 
   template<>
   glm::bvec4 Uniform::getData<glm::bvec4>() const noexcept {
-    return bvec4_data;
+    return load<glm::bvec4>();
   }
 
   template<>
   glm::mat2 Uniform::getData<glm::mat2>() const noexcept {
-    return mat2_data;
+    return load<glm::mat2>();
   }
 
   template<>
   glm::mat3 Uniform::getData<glm::mat3>() const noexcept {
-    return mat3_data;
+    return load<glm::mat3>();
   }
 
   template<>
   glm::mat4 Uniform::getData<glm::mat4>() const noexcept {
-    return mat4_data;
+    return load<glm::mat4>();
   }
 
   template<>
   glm::mat2x3 Uniform::getData<glm::mat2x3>() const noexcept {
-    return mat23_data;
+    return load<glm::mat2x3>();
   }
 
   template<>
   glm::mat3x2 Uniform::getData<glm::mat3x2>() const noexcept {
-    return mat32_data;
+    return load<glm::mat3x2>();
   }
 
   template<>
   glm::mat2x4 Uniform::getData<glm::mat2x4>() const noexcept {
-    return mat24_data;
+    return load<glm::mat2x4>();
   }
 
   template<>
   glm::mat4x2 Uniform::getData<glm::mat4x2>() const noexcept {
-    return mat42_data;
+    return load<glm::mat4x2>();
   }
 
   template<>
   glm::mat3x4 Uniform::getData<glm::mat3x4>() const noexcept {
-    return mat34_data;
+    return load<glm::mat3x4>();
   }
 
   template<>
   glm::mat4x3 Uniform::getData<glm::mat4x3>() const noexcept {
-    return mat43_data;
+    return load<glm::mat4x3>();
   }
 
-  bool Uniform::operator<(const Uniform& right) const noexcept {
-    return name < right.name;
-  }
-
-  bool Uniform::operator!=(const Uniform& right) const noexcept {
-    return !(*this == right);
-  }
+  void Uniform::upload(const int location) const noexcept {
+    if(location < 0)
+      return;
 
-  bool Uniform::operator==(const Uniform& right) const noexcept {
-    bool ret = false;
-    ret &= this->name == right.name;
-    ret &= this->uniform_type == right.uniform_type;
-    switch(this->uniform_type) {
+    switch(uniform_type) {
       case UniformTypes::FLOAT:
-        ret &= this->float_data == right.float_data;
+        glUniform1f(location, load<float>());
         break;
       case UniformTypes::VEC2:
-        ret &= this->vec2_data == right.vec2_data;
+        glUniform2fv(location, 1, glm::value_ptr(load<glm::vec2>()));
         break;
       case UniformTypes::VEC3:
-        ret &= this->vec3_data == right.vec3_data;
+        glUniform3fv(location, 1, glm::value_ptr(load<glm::vec3>()));
         break;
       case UniformTypes::VEC4:
-        ret &= this->vec4_data == right.vec4_data;
+        glUniform4fv(location, 1, glm::value_ptr(load<glm::vec4>()));
         break;
       case UniformTypes::INT:
-        ret &= this->int_data == right.int_data;
+        glUniform1i(location, load<int>());
         break;
       case UniformTypes::IVEC2:
-        ret &= this->ivec2_data == right.ivec2_data;
+        glUniform2iv(location, 1, glm::value_ptr(load<glm::ivec2>()));
         break;
       case UniformTypes::IVEC3:
-        ret &= this->ivec3_data == right.ivec3_data;
+        glUniform3iv(location, 1, glm::value_ptr(load<glm::ivec3>()));
         break;
       case UniformTypes::IVEC4:
-        ret &= this->ivec4_data == right.ivec4_data;
+        glUniform4iv(location, 1, glm::value_ptr(load<glm::ivec4>()));
         break;
       case UniformTypes::UINT:
-        ret &= this->uint_data == right.uint_data;
+        glUniform1ui(location, load<unsigned int>());
         break;
       case UniformTypes::UVEC2:
-        ret &= this->uvec2_data == right.uvec2_data;
+        glUniform2uiv(location, 1, glm::value_ptr(load<glm::uvec2>()));
         break;
       case UniformTypes::UVEC3:
-        ret &= this->uvec3_data == right.uvec3_data;
+        glUniform3uiv(location, 1, glm::value_ptr(load<glm::uvec3>()));
         break;
       case UniformTypes::UVEC4:
-        ret &= this->uvec4_data == right.uvec4_data;
+        glUniform4uiv(location, 1, glm::value_ptr(load<glm::uvec4>()));
         break;
       case UniformTypes::BOOL:
-        ret &= this->bool_data == right.bool_data;
+        glUniform1i(location, load<bool>());
         break;
       case UniformTypes::BVEC2:
-        ret &= this->bvec2_data == right.bvec2_data;
+        glUniform2iv(location, 1, glm::value_ptr(glm::ivec2(load<glm::bvec2>())));
         break;
       case UniformTypes::BVEC3:
-        ret &= this->bvec3_data == right.bvec3_data;
+        glUniform3iv(location, 1, glm::value_ptr(glm::ivec3(load<glm::bvec3>())));
         break;
       case UniformTypes::BVEC4:
-        ret &= this->bvec4_data == right.bvec4_data;
+        glUniform4iv(location, 1, glm::value_ptr(glm::ivec4(load<glm::bvec4>())));
         break;
       case UniformTypes::MAT2:
-        ret &= this->mat2_data == right.mat2_data;
+        glUniformMatrix2fv(location, 1, false, glm::value_ptr(load<glm::mat2>()));
         break;
       case UniformTypes::MAT3:
-        ret &= this->mat3_data == right.mat3_data;
+        glUniformMatrix3fv(location, 1, false, glm::value_ptr(load<glm::mat3>()));
         break;
       case UniformTypes::MAT4:
-        ret &= this->mat4_data == right.mat4_data;
+        glUniformMatrix4fv(location, 1, false, glm::value_ptr(load<glm::mat4>()));
         break;
       case UniformTypes::MAT23:
-        ret &= this->mat23_data == right.mat23_data;
+        glUniformMatrix2x3fv(location, 1, false, glm::value_ptr(load<glm::mat2x3>()));
         break;
       case UniformTypes::MAT32:
-        ret &= this->mat32_data == right.mat32_data;
+        glUniformMatrix3x2fv(location, 1, false, glm::value_ptr(load<glm::mat3x2>()));
         break;
       case UniformTypes::MAT24:
-        ret &= this->mat24_data == right.mat24_data;
+        glUniformMatrix2x4fv(location, 1, false, glm::value_ptr(load<glm::mat2x4>()));
         break;
       case UniformTypes::MAT42:
-        ret &= this->mat42_data == right.mat42_data;
+        glUniformMatrix4x2fv(location, 1, false, glm::value_ptr(load<glm::mat4x2>()));
         break;
       case UniformTypes::MAT34:
-        ret &= this->mat34_data == right.mat34_data;
+        glUniformMatrix3x4fv(location, 1, false, glm::value_ptr(load<glm::mat3x4>()));
         break;
       case UniformTypes::MAT43:
-        ret &= this->mat43_data == right.mat43_data;
+        glUniformMatrix4x3fv(location, 1, false, glm::value_ptr(load<glm::mat4x3>()));
         break;
     }
+  }
 
-    return ret;
+  bool Uniform::operator<(const Uniform& right) const noexcept {
+    return name < right.name;
+  }
+
+  bool Uniform::operator!=(const Uniform& right) const noexcept {
+    return !(*this == right);
+  }
+
+  bool Uniform::operator==(const Uniform& right) const noexcept {
+    return name == right.name && uniform_type == right.uniform_type && data_size == right.data_size && std::memcmp(data, right.data, data_size) == 0;
   }
 
   std::string Uniform::to_string() const noexcept {
@@ -17,33 +17,16 @@ namespace Graphics {
     private:
       UniformTypes uniform_type;
       std::string name;
-      float float_data;
-      glm::vec2 vec2_data;
-      glm::vec3 vec3_data;
-      glm::vec4 vec4_data;
-      int int_data;
-      glm::ivec2 ivec2_data;
-      glm::ivec3 ivec3_data;
-      glm::ivec4 ivec4_data;
-      unsigned int uint_data;
-      glm::uvec2 uvec2_data;
-      glm::uvec3 uvec3_data;
-      glm::uvec4 uvec4_data;
-      bool bool_data;
-      glm::bvec2 bvec2_data;
-      glm::bvec3 bvec3_data;
-      glm::bvec4 bvec4_data;
-      glm::mat2 mat2_data;
-      glm::mat3 mat3_data;
-      glm::mat4 mat4_data;
-      glm::mat2x3 mat23_data;
-      glm::mat3x2 mat32_data;
-      glm::mat2x4 mat24_data;
-      glm::mat4x2 mat42_data;
-      glm::mat3x4 mat34_data;
-      glm::mat4x3 mat43_data;
+      //The value of whichever type the uniform holds, mat4 is the largest
+      alignas(16) unsigned char data[sizeof(glm::mat4)];
+      unsigned char data_size;
 
       bool dirty;
+
+      template<typename T>
+      void store(const std::string& name, const UniformTypes type, const T& value);
+      template<typename T>
+      T load() const noexcept;
     public:
       /**
        * @brief      Uniform constructor.
@@ -100,6 +83,13 @@ namespace Graphics {
                    glm::mat4x2, glm::mat3x4, glm::mat4x3})]]
       T getData() const noexcept;
 
+      /**
+       * @brief      Uploads the data to a location of the program in use.
+       *
+       * @param[in]  location  The uniform location, -1 is ignored the same as by OpenGL
+       */
+      void upload(const int location) const noexcept;
+
       /**
        * @brief      < operator using name
        *
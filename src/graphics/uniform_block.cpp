@@ -0,0 +1,71 @@
+#include <stdexcept>
+#include "uniform_block.h"
+
+namespace Graphics {
+  //0 is left for uniforms set by name
+  unsigned int UniformBlock::next_id = 1;
+
+  UniformBlock::UniformBlock() : id(next_id++), dirty_mask(0) {
+  }
+
+  void UniformBlock::set(const Uniform& uniform) {
+    for(unsigned int index = 0; index < uniforms.size(); index++) {
+      if(uniforms[index].getName() == uniform.getName()) {
+        if(uniforms[index] != uniform) {
+          uniforms[index] = uniform;
+          dirty_mask |= 1U << index;
+        }
+        return;
+      }
+    }
+
+    if(uniforms.size() >= MAX_UNIFORMS)
+      throw std::length_error("Uniform block is full, it can't hold " + uniform.getName());
+    uniforms.push_back(uniform);
+    //Resolved the next time the block is applied
+    resolved_program.reset();
+  }
+
+  void UniformBlock::remove(const std::string& name) noexcept {
+    for(auto uniform = uniforms.begin(); uniform != uniforms.end(); uniform++) {
+      if(uniform->getName() == name) {
+        uniforms.erase(uniform);
+        resolved_program.reset();
+        return;
+      }
+    }
+  }
+
+  unsigned int UniformBlock::findSlot(const std::string& name) const noexcept {
+    unsigned int index = 0;
+    while(index < uniforms.size() && uniforms[index].getName() != name)
+      index++;
+    return index;
+  }
+
+  const std::vector<Uniform>& UniformBlock::getUniforms() const noexcept {
+    return uniforms;
+  }
+
+  void UniformBlock::apply(std::shared_ptr<Shader> program) {
+    if(resolved_program.lock() != program) {
+      locations.clear();
+      for(auto& uniform : uniforms)
+        locations.push_back(program->getUniformLocation(uniform.getName()));
+      resolved_program = program;
+      dirty_mask = ~0U;
+    }
+
+    for(unsigned int index = 0; index < uniforms.size(); index++) {
+      auto location = locations[index];
+      if(location < 0)
+        continue;
+      //Another block, or a set by name, may have changed the location since this block set it
+      if((dirty_mask & (1U << index)) != 0 || program->getUniformWriter(location) != id) {
+        uniforms[index].upload(location);
+        program->setUniformWriter(location, id);
+      }
+    }
+    dirty_mask = 0;
+  }
+}
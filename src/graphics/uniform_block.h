@@ -0,0 +1,113 @@
+#ifndef UNIFORM_BLOCK_H
+#define UNIFORM_BLOCK_H
+#include <memory>
+#include <string>
+#include <vector>
+#include "shader.h"
+#include "uniform.h"
+
+namespace Graphics {
+  /**
+   * @brief      Uniforms a renderable or material sets on its shader, uploaded only when changed.
+   *
+   * @detail     Locations are looked up once per program. A uniform is uploaded when its value
+   * changed since the block last applied it, or when something else set the location since.
+   */
+  class UniformBlock {
+    public:
+      /**
+       * The most uniforms a block holds, one bit of the dirty mask each
+       */
+      static const unsigned int MAX_UNIFORMS = 32;
+
+    private:
+      unsigned int id;
+      std::vector<Uniform> uniforms;
+      std::vector<int> locations;
+      std::weak_ptr<Shader> resolved_program;
+      unsigned int dirty_mask;
+
+      static unsigned int next_id;
+
+      unsigned int findSlot(const std::string& name) const noexcept;
+    public:
+      /**
+       * @brief      UniformBlock constructor
+       */
+      UniformBlock();
+
+      //Remove copy constructor and assignment
+      UniformBlock(const UniformBlock&) = delete;
+      UniformBlock operator=(UniformBlock&) = delete;
+
+      /**
+       * @brief      Sets a uniform, marking it dirty if its value changed.
+       *
+       * @param[in]  uniform  The uniform
+       */
+      void set(const Uniform& uniform);
+      /**
+       * @brief      Removes a uniform.
+       *
+       * @param[in]  name  The name
+       */
+      void remove(const std::string& name) noexcept;
+      /**
+       * @brief      Gets the slot of a uniform, adding the uniform if the block doesn't have it.
+       *
+       * @detail     Slots stay valid until a uniform is removed from the block. The initial value
+       * gives an added uniform its type, so it's uploaded with the right call before it's first set.
+       *
+       * @param[in]  name     The name
+       * @param[in]  initial  The value of an added uniform
+       *
+       * @tparam     T        DataType for uniform
+       *
+       * @return     The slot.
+       */
+      template<typename T>
+      unsigned int getSlot(const std::string& name, const T& initial) {
+        auto slot = findSlot(name);
+        if(slot < uniforms.size())
+          return slot;
+
+        Uniform uniform;
+        uniform.setData(name, initial);
+        set(uniform);
+        return uniforms.size() - 1;
+      }
+      /**
+       * @brief      Sets the value of the uniform in a slot, marking it dirty if it changed.
+       *
+       * @param[in]  slot   The slot
+       * @param[in]  value  The value
+       *
+       * @tparam     T      DataType for uniform
+       */
+      template<typename T>
+      void setSlot(const unsigned int slot, const T& value) {
+        auto& uniform = uniforms[slot];
+        uniform.clean();
+        uniform.setData(uniform.getName(), value);
+        if(uniform.isDirty())
+          dirty_mask |= 1U << slot;
+      }
+      /**
+       * @brief      Gets the uniforms.
+       *
+       * @return     The uniforms.
+       */
+      const std::vector<Uniform>& getUniforms() const noexcept;
+
+      /**
+       * @brief      Uploads the changed uniforms to the program in use.
+       *
+       * @detail     Uniforms the program doesn't have are skipped, so fallbacks can be applied to.
+       *
+       * @param[in]  program  The program, it has to be in use
+       */
+      void apply(std::shared_ptr<Shader> program);
+  };
+}
+
+#endif
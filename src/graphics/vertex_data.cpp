@@ -70,8 +70,8 @@ namespace Graphics {
         {Graphics::VertexData::DATA_TYPE::TEX_COORDS, 2},
         {Graphics::VertexData::DATA_TYPE::TEXTURE_UNIT, 1},
         {Graphics::VertexData::DATA_TYPE::NORMAL_COORDS, 3},
-        {Graphics::VertexData::DATA_TYPE::RESERVED2, 3},
-        {Graphics::VertexData::DATA_TYPE::RESERVED3, 3},
+        {Graphics::VertexData::DATA_TYPE::INSTANCE_OFFSET, 3},
+        {Graphics::VertexData::DATA_TYPE::INSTANCE_TILE_COORD, 2},
         {Graphics::VertexData::DATA_TYPE::RESERVED4, 3},
         {Graphics::VertexData::DATA_TYPE::RESERVED5, 3},
         {Graphics::VertexData::DATA_TYPE::RESERVED6, 3},
@@ -681,6 +681,20 @@ namespace Graphics {
     return highest_z;
   }
 
+  VertexRecord VertexData::getRecord() const noexcept {
+    glm::vec3 low(0.0);
+    glm::vec3 high(0.0, 0.0, highest_z);
+    auto geometry = float_vector3s.find(DATA_TYPE::GEOMETRY);
+    if(geometry != float_vector3s.end() && !geometry->second.empty()) {
+      low = high = geometry->second.front();
+      for(auto& vertex : geometry->second) {
+        low = glm::min(low, vertex);
+        high = glm::max(high, vertex);
+      }
+    }
+    return VertexRecord(primitive_type, vertex_count, index_count, low, high);
+  }
+
   unsigned int VertexData::numberVertexBufferObjects() const noexcept {
     return float_vector1s.size() + float_vector2s.size() + float_vector3s.size() + float_vector4s.size() +
            double_vector1s.size() + double_vector2s.size() + double_vector3s.size() + double_vector4s.size() +
@@ -688,10 +702,9 @@ namespace Graphics {
            unsigned_int_vector1s.size() + unsigned_int_vector2s.size() + unsigned_int_vector3s.size() + unsigned_int_vector4s.size();
   }
 
-  unsigned int VertexData::generateVertexArrayObject() const {
-    unsigned int vertex_array_object = 0;
-    glGenVertexArrays(1, &vertex_array_object);
-    glBindVertexArray(vertex_array_object);
+  std::shared_ptr<GPUResource> VertexData::generateVertexArrayObject() const {
+    auto vertex_array = GPUResourceRegistry::create(GPUResourceType::VERTEX_ARRAY);
+    glBindVertexArray(vertex_array->getObject());
 
     auto float_data = getCollapsedVectors<float>();
     auto double_data = getCollapsedVectors<double>();
@@ -699,51 +712,61 @@ namespace Graphics {
     auto unsigned_int_data = getCollapsedVectors<unsigned int>();
 
     unsigned int num_of_vertex_buffers = numberVertexBufferObjects();
-    unsigned int* vertex_buffer_objects = new unsigned int[num_of_vertex_buffers];
+    std::vector<std::shared_ptr<GPUResource>> vertex_buffers;
     unsigned int index_buffer_object = 0;
 
     std::vector<std::pair<VertexData::DATA_TYPE, GLenum>> data_types;
-    glGenBuffers(num_of_vertex_buffers, vertex_buffer_objects);
+    for(unsigned int i = 0; i < num_of_vertex_buffers; i++) {
+      vertex_buffers.push_back(GPUResourceRegistry::create(GPUResourceType::BUFFER));
+      vertex_array->addDependency(vertex_buffers.back());
+    }
 
     unsigned int current_buffer = 0;
 
     //Do this if we actually have indices
     if(getIndices().size() > 0) {
-      glGenBuffers(1, &index_buffer_object);
+      auto index_buffer = GPUResourceRegistry::create(GPUResourceType::BUFFER);
+      index_buffer_object = index_buffer->getObject();
       glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_object);
       glBufferData(GL_ELEMENT_ARRAY_BUFFER, getIndices().size() * sizeof(unsigned int), &(getIndices())[0], GL_STATIC_DRAW);
+      index_buffer->setBytes(getIndices().size() * sizeof(unsigned int));
+      vertex_array->addDependency(index_buffer);
     }
 
     for(auto i : float_data) {
-      glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_objects[current_buffer++]);
+      glBindBuffer(GL_ARRAY_BUFFER, vertex_buffers[current_buffer]->getObject());
       glBufferData(GL_ARRAY_BUFFER, i.second.size() * sizeof(float), &(i.second)[0], GL_STATIC_DRAW);
+      vertex_buffers[current_buffer++]->setBytes(i.second.size() * sizeof(float));
       data_types.push_back(std::pair<VertexData::DATA_TYPE, GLenum>(i.first, GL_FLOAT));
     }
 
     for(auto i : double_data) {
-      glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_objects[current_buffer++]);
+      glBindBuffer(GL_ARRAY_BUFFER, vertex_buffers[current_buffer]->getObject());
       glBufferData(GL_ARRAY_BUFFER, i.second.size() * sizeof(double), &(i.second)[0], GL_STATIC_DRAW);
+      vertex_buffers[current_buffer++]->setBytes(i.second.size() * sizeof(double));
       data_types.push_back(std::pair<VertexData::DATA_TYPE, GLenum>(i.first, GL_DOUBLE));
     }
 
     for(auto i : int_data) {
-      glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_objects[current_buffer++]);
+      glBindBuffer(GL_ARRAY_BUFFER, vertex_buffers[current_buffer]->getObject());
       glBufferData(GL_ARRAY_BUFFER, i.second.size() * sizeof(int), &(i.second)[0], GL_STATIC_DRAW);
+      vertex_buffers[current_buffer++]->setBytes(i.second.size() * sizeof(int));
       data_types.push_back(std::pair<VertexData::DATA_TYPE, GLenum>(i.first, GL_INT));
     }
 
     for(auto i : unsigned_int_data) {
-      glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_objects[current_buffer++]);
+      glBindBuffer(GL_ARRAY_BUFFER, vertex_buffers[current_buffer]->getObject());
       glBufferData(GL_ARRAY_BUFFER, i.second.size() * sizeof(unsigned int), &(i.second)[0], GL_STATIC_DRAW);
+      vertex_buffers[current_buffer++]->setBytes(i.second.size() * sizeof(unsigned int));
       data_types.push_back(std::pair<VertexData::DATA_TYPE, GLenum>(i.first, GL_UNSIGNED_INT));
     }
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
-    glBindVertexArray(vertex_array_object);
+    glBindVertexArray(vertex_array->getObject());
 
-    for(int i = 0; i < num_of_vertex_buffers; i++) {
-      glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_objects[i]);
+    for(unsigned int i = 0; i < num_of_vertex_buffers; i++) {
+      glBindBuffer(GL_ARRAY_BUFFER, vertex_buffers[i]->getObject());
       if(data_types[i].second == GL_FLOAT || data_types[i].second == GL_DOUBLE)
         glVertexAttribPointer(data_types[i].first, VertexData::DataWidth.at(data_types[i].first), data_types[i].second, GL_FALSE, 0, 0);
       //VERY IMPORTANT, WITHOUT glVertexAttribIPointer, integers will be destroyed!!
@@ -757,7 +780,7 @@ namespace Graphics {
     }
     glBindVertexArray(0);
 
-    return vertex_array_object;
+    return vertex_array;
   }
 
   std::string VertexData::to_string() const noexcept {
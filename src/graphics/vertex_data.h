@@ -10,6 +10,10 @@
 #include <glm/vec2.hpp>
 #include <vector>
 #include <map>
+#include <memory>
+#include <string>
+#include "vertex_record.h"
+#include "gpu_resource.h"
 namespace Graphics {
   /**
    * @brief      Class for vertex data.
@@ -24,8 +28,8 @@ namespace Graphics {
         TEX_COORDS = 1,
         TEXTURE_UNIT = 2,
         NORMAL_COORDS = 3,
-        RESERVED2 = 4,
-        RESERVED3 = 5,
+        INSTANCE_OFFSET = 4,
+        INSTANCE_TILE_COORD = 5,
         RESERVED4 = 6,
         RESERVED5 = 7,
         RESERVED6 = 8,
@@ -198,6 +202,13 @@ namespace Graphics {
        */
       float highestZ() const noexcept;
 
+      /**
+       * @brief      Gets the record of this vertex data, what a renderable keeps once it's uploaded.
+       *
+       * @return     The record.
+       */
+      VertexRecord getRecord() const noexcept;
+
       /**
        * @brief      Returns number of vertex buffer objects needed for this vertex data
        *
@@ -207,9 +218,9 @@ namespace Graphics {
       /**
        * @brief      Generates an opengl vertex array object
        *
-       * @return     A handle to an opengl vao
+       * @return     The vao, its buffers are deleted along with it
        */
-      unsigned int generateVertexArrayObject() const;
+      std::shared_ptr<GPUResource> generateVertexArrayObject() const;
 
       /**
        * @brief      Returns a string representation of the object.
@@ -0,0 +1,85 @@
+#include <limits>
+#include "vertex_layout.h"
+
+namespace Graphics {
+  BaseVertexLayout::BaseVertexLayout(const GLenum primitive_type) : primitive_type(primitive_type),
+    low(std::numeric_limits<float>::infinity()), high(-std::numeric_limits<float>::infinity()) {
+  }
+
+  void BaseVertexLayout::addIndices(const std::vector<unsigned int>& indices) {
+    this->indices.insert(this->indices.end(), indices.begin(), indices.end());
+  }
+
+  std::vector<unsigned int> BaseVertexLayout::quadIndices(const unsigned int quad_count) {
+    std::vector<unsigned int> indices;
+    indices.reserve(quad_count * 6);
+    for(unsigned int quad = 0; quad < quad_count; quad++) {
+      auto first = quad * 4;
+      indices.insert(indices.end(), {first, first + 1, first + 2, first, first + 2, first + 3});
+    }
+    return indices;
+  }
+
+  void BaseVertexLayout::setAttributePointers(const VertexAttribute* attributes, const size_t attribute_count, const size_t stride) {
+    for(size_t i = 0; i < attribute_count; i++) {
+      auto& attribute = attributes[i];
+      switch(attribute.mode) {
+        case AttributeMode::INTEGER:
+          glVertexAttribIPointer(attribute.location, attribute.width, attribute.component_type, stride, (void*)attribute.offset);
+          break;
+        case AttributeMode::NORMALIZED:
+          glVertexAttribPointer(attribute.location, attribute.width, attribute.component_type, GL_TRUE, stride, (void*)attribute.offset);
+          break;
+        default:
+          glVertexAttribPointer(attribute.location, attribute.width, attribute.component_type, GL_FALSE, stride, (void*)attribute.offset);
+          break;
+      }
+      glEnableVertexAttribArray(attribute.location);
+    }
+  }
+
+  const std::vector<unsigned char>& BaseVertexLayout::getVertexBytes() const noexcept {
+    return vertices;
+  }
+
+  const std::vector<unsigned int>& BaseVertexLayout::getIndices() const noexcept {
+    return indices;
+  }
+
+  void BaseVertexLayout::extendBounds(const glm::vec3& position) noexcept {
+    low = glm::min(low, position);
+    high = glm::max(high, position);
+  }
+
+  VertexRecord BaseVertexLayout::getRecord(const size_t stride) const noexcept {
+    if(vertices.empty())
+      return VertexRecord(primitive_type, 0, indices.size());
+    return VertexRecord(primitive_type, vertices.size() / stride, indices.size(), low, high);
+  }
+
+  std::shared_ptr<GPUResource> BaseVertexLayout::generateVertexArrayObject(const VertexAttribute* attributes, const size_t attribute_count, const size_t stride) const {
+    auto vertex_array = GPUResourceRegistry::create(GPUResourceType::VERTEX_ARRAY);
+    glBindVertexArray(vertex_array->getObject());
+
+    auto vertex_buffer = GPUResourceRegistry::create(GPUResourceType::BUFFER);
+    glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer->getObject());
+    glBufferData(GL_ARRAY_BUFFER, vertices.size(), vertices.data(), GL_STATIC_DRAW);
+    vertex_buffer->setBytes(vertices.size());
+    vertex_array->addDependency(vertex_buffer);
+
+    setAttributePointers(attributes, attribute_count, stride);
+
+    if(indices.size() > 0) {
+      auto index_buffer = GPUResourceRegistry::create(GPUResourceType::BUFFER);
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer->getObject());
+      glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+      index_buffer->setBytes(indices.size() * sizeof(unsigned int));
+      vertex_array->addDependency(index_buffer);
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    return vertex_array;
+  }
+}
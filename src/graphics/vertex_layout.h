@@ -0,0 +1,315 @@
+#ifndef VERTEX_LAYOUT_H
+#define VERTEX_LAYOUT_H
+#ifdef __APPLE__
+#include <OpenGL/gl3.h>
+#else
+#include <glad/glad.h>
+#endif
+#include <glm/glm.hpp>
+#include <glm/gtc/type_precision.hpp>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "vertex_data.h"
+#include "vertex_record.h"
+#include "gpu_resource.h"
+
+namespace Graphics {
+  /**
+   * @brief      How the shader sees an attribute's components
+   */
+  enum class AttributeMode : unsigned int {
+    //Converted to float as they are
+    FLOAT,
+    //Converted to float in 0.0, 1.0 or -1.0, 1.0
+    NORMALIZED,
+    //Kept as integers, set up with glVertexAttribIPointer
+    INTEGER
+  };
+
+  /**
+   * @brief      Vertex attributes for VertexLayout.
+   *
+   * @detail     Each attribute names its C++ type, its shader location, the GL type and width of its
+   * components and how the shader sees them.
+   */
+  struct Position3f {
+    typedef glm::vec3 type;
+    static const VertexData::DATA_TYPE location = VertexData::DATA_TYPE::GEOMETRY;
+    static const GLenum component_type = GL_FLOAT;
+    static const int width = 3;
+    static const AttributeMode mode = AttributeMode::FLOAT;
+  };
+
+  struct UV2f {
+    typedef glm::vec2 type;
+    static const VertexData::DATA_TYPE location = VertexData::DATA_TYPE::TEX_COORDS;
+    static const GLenum component_type = GL_FLOAT;
+    static const int width = 2;
+    static const AttributeMode mode = AttributeMode::FLOAT;
+  };
+
+  struct Unit1i {
+    typedef int type;
+    static const VertexData::DATA_TYPE location = VertexData::DATA_TYPE::TEXTURE_UNIT;
+    static const GLenum component_type = GL_INT;
+    static const int width = 1;
+    static const AttributeMode mode = AttributeMode::INTEGER;
+  };
+
+  struct Normal3f {
+    typedef glm::vec3 type;
+    static const VertexData::DATA_TYPE location = VertexData::DATA_TYPE::NORMAL_COORDS;
+    static const GLenum component_type = GL_FLOAT;
+    static const int width = 3;
+    static const AttributeMode mode = AttributeMode::FLOAT;
+  };
+
+  /**
+   * @brief      Map position in 1/subdivisions of a tile, shaders compiled with TILE_VERTEX divide it back.
+   */
+  struct TilePosition2s {
+    typedef glm::i16vec2 type;
+    static const VertexData::DATA_TYPE location = VertexData::DATA_TYPE::GEOMETRY;
+    static const GLenum component_type = GL_SHORT;
+    static const int width = 2;
+    static const AttributeMode mode = AttributeMode::FLOAT;
+    //Exact for tiles that are whole pixels of 16 pixel map tiles, maps up to 2047 tiles across
+    static const int subdivisions = 16;
+  };
+
+  struct UV2us {
+    typedef glm::u16vec2 type;
+    static const VertexData::DATA_TYPE location = VertexData::DATA_TYPE::TEX_COORDS;
+    static const GLenum component_type = GL_UNSIGNED_SHORT;
+    static const int width = 2;
+    static const AttributeMode mode = AttributeMode::NORMALIZED;
+  };
+
+  struct Unit1ub {
+    typedef unsigned char type;
+    static const VertexData::DATA_TYPE location = VertexData::DATA_TYPE::TEXTURE_UNIT;
+    static const GLenum component_type = GL_UNSIGNED_BYTE;
+    static const int width = 1;
+    static const AttributeMode mode = AttributeMode::INTEGER;
+  };
+
+  /**
+   * @brief      Where an attribute is in an interleaved vertex
+   */
+  struct VertexAttribute {
+    unsigned int location;
+    int width;
+    GLenum component_type;
+    AttributeMode mode;
+    size_t offset;
+  };
+
+  /**
+   * @brief      Interleaved vertices without their attribute types, see VertexLayout.
+   */
+  class BaseVertexLayout {
+    protected:
+      GLenum primitive_type;
+      std::vector<unsigned char> vertices;
+      std::vector<unsigned int> indices;
+      glm::vec3 low;
+      glm::vec3 high;
+
+      BaseVertexLayout(const GLenum primitive_type);
+
+      void extendBounds(const glm::vec3& position) noexcept;
+      std::shared_ptr<GPUResource> generateVertexArrayObject(const VertexAttribute* attributes, const size_t attribute_count, const size_t stride) const;
+      VertexRecord getRecord(const size_t stride) const noexcept;
+
+    public:
+      /**
+       * @brief      Adds indices.
+       *
+       * @param[in]  indices  The indices
+       */
+      void addIndices(const std::vector<unsigned int>& indices);
+      /**
+       * @brief      Gets the indices drawing quads as two triangles each.
+       *
+       * @detail     Quads are four vertices, counterclockwise or clockwise from a corner. The same
+       * indices draw any vertices laid out that way, so they can be shared between buffers.
+       *
+       * @param[in]  quad_count  The number of quads
+       *
+       * @return     Six indices per quad.
+       */
+      static std::vector<unsigned int> quadIndices(const unsigned int quad_count);
+      /**
+       * @brief      Sets the attribute pointers of the bound vertex array object.
+       *
+       * @param[in]  attributes       The attributes
+       * @param[in]  attribute_count  The attribute count
+       * @param[in]  stride           The stride
+       */
+      static void setAttributePointers(const VertexAttribute* attributes, const size_t attribute_count, const size_t stride);
+      /**
+       * @brief      Gets the interleaved vertices.
+       *
+       * @return     The vertices as bytes.
+       */
+      const std::vector<unsigned char>& getVertexBytes() const noexcept;
+      /**
+       * @brief      Gets the indices.
+       *
+       * @return     The indices.
+       */
+      const std::vector<unsigned int>& getIndices() const noexcept;
+  };
+
+  /**
+   * @brief      Vertices with a fixed set of attributes, interleaved in one buffer.
+   *
+   * @detail     The stride and the attribute offsets follow from the attribute types, so a layout
+   * is a single vector of bytes instead of a vector per attribute. Uploading it creates one vertex
+   * buffer, and the layout can be dropped afterwards, getRecord keeps what is needed to draw.
+   *
+   * @tparam     Attributes  The attributes in buffer order, see Position3f
+   */
+  template<class... Attributes>
+  class VertexLayout : public BaseVertexLayout {
+    private:
+      static_assert(sizeof...(Attributes) > 0, "A vertex layout needs at least one attribute");
+
+      static constexpr size_t offsetOf(const size_t index) {
+        size_t sizes[] = {sizeof(typename Attributes::type)...};
+        size_t offset = 0;
+        for(size_t i = 0; i < index; i++) {
+          offset += sizes[i];
+        }
+        return offset;
+      }
+
+      template<size_t... Indices>
+      static constexpr std::array<VertexAttribute, sizeof...(Attributes)> getAttributes(std::index_sequence<Indices...>) {
+        return {{VertexAttribute{Attributes::location, Attributes::width, Attributes::component_type, Attributes::mode, offsetOf(Indices)}...}};
+      }
+
+      template<class Attribute, class... Rest>
+      void write(unsigned char* destination, const typename Attribute::type& value, const typename Rest::type&... rest) noexcept {
+        std::memcpy(destination, &value, sizeof(typename Attribute::type));
+        extend(Attribute(), value);
+        write<Rest...>(destination + sizeof(typename Attribute::type), rest...);
+      }
+
+      template<class... None>
+      typename std::enable_if<sizeof...(None) == 0>::type write(unsigned char*) noexcept {
+      }
+
+      template<class Attribute>
+      void extend(const Attribute&, const typename Attribute::type&) noexcept {
+      }
+
+      void extend(const Position3f&, const glm::vec3& position) noexcept {
+        extendBounds(position);
+      }
+
+      void extend(const TilePosition2s&, const glm::i16vec2& position) noexcept {
+        extendBounds(glm::vec3(glm::vec2(position) / (float)TilePosition2s::subdivisions, 0.0));
+      }
+
+    public:
+      /**
+       * Bytes per vertex, padded to 4 bytes so every vertex starts aligned
+       */
+      static constexpr size_t stride = (offsetOf(sizeof...(Attributes)) + 3) / 4 * 4;
+
+      /**
+       * @brief      VertexLayout constructor
+       *
+       * @param[in]  primitive_type  The primitive type
+       */
+      VertexLayout(const GLenum primitive_type = GL_TRIANGLES) : BaseVertexLayout(primitive_type) {
+      }
+
+      /**
+       * @brief      Interleaves separate attribute vectors.
+       *
+       * @param[in]  primitive_type  The primitive type
+       * @param[in]  attributes      A vector per attribute, all the same size
+       *
+       * @return     The layout.
+       */
+      static VertexLayout fromVectors(const GLenum primitive_type, const std::vector<typename Attributes::type>&... attributes) {
+        size_t sizes[] = {attributes.size()...};
+        for(auto size : sizes) {
+          if(size != sizes[0])
+            throw std::invalid_argument("Vertex attribute vectors differ in size");
+        }
+
+        VertexLayout layout(primitive_type);
+        layout.reserve(sizes[0]);
+        for(size_t i = 0; i < sizes[0]; i++) {
+          layout.addVertex(attributes[i]...);
+        }
+        return layout;
+      }
+
+      /**
+       * @brief      Reserves space for vertices.
+       *
+       * @param[in]  count  The vertex count
+       */
+      void reserve(const size_t count) {
+        vertices.reserve(count * stride);
+      }
+
+      /**
+       * @brief      Adds a vertex.
+       *
+       * @param[in]  values  A value per attribute
+       */
+      void addVertex(const typename Attributes::type&... values) {
+        auto offset = vertices.size();
+        vertices.resize(offset + stride);
+        write<Attributes...>(&vertices[offset], values...);
+      }
+
+      /**
+       * @brief      Gets the vertex count.
+       *
+       * @return     The vertex count.
+       */
+      unsigned int getVertexCount() const noexcept {
+        return vertices.size() / stride;
+      }
+
+      /**
+       * @brief      Gets the record of the vertices, what is kept after uploading.
+       *
+       * @return     The record.
+       */
+      VertexRecord getRecord() const noexcept {
+        return BaseVertexLayout::getRecord(stride);
+      }
+
+      /**
+       * @brief      Gets the attributes, in buffer order.
+       *
+       * @return     The attributes.
+       */
+      static constexpr std::array<VertexAttribute, sizeof...(Attributes)> getAttributes() {
+        return getAttributes(std::index_sequence_for<Attributes...>());
+      }
+
+      /**
+       * @brief      Uploads the vertices to one interleaved buffer.
+       *
+       * @return     The vertex array object, its buffers are deleted along with it.
+       */
+      std::shared_ptr<GPUResource> generateVertexArrayObject() const {
+        auto attributes = getAttributes();
+        return BaseVertexLayout::generateVertexArrayObject(attributes.data(), attributes.size(), stride);
+      }
+  };
+}
+
+#endif
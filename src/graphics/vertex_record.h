@@ -0,0 +1,91 @@
+#ifndef VERTEX_RECORD_H
+#define VERTEX_RECORD_H
+#ifdef __APPLE__
+#include <OpenGL/gl3.h>
+#else
+#include <glad/glad.h>
+#endif
+#include <glm/glm.hpp>
+#include <limits>
+
+namespace Graphics {
+  /**
+   * @brief      What is kept on the CPU of vertex data once it's uploaded.
+   */
+  class VertexRecord {
+    private:
+      GLenum primitive_type;
+      unsigned int vertex_count;
+      unsigned int index_count;
+      glm::vec3 low;
+      glm::vec3 high;
+      unsigned int first_vertex;
+      unsigned int first_index;
+
+    public:
+      /**
+       * @brief      VertexRecord constructor
+       *
+       * @param[in]  primitive_type  The primitive type
+       * @param[in]  vertex_count    The vertex count
+       * @param[in]  index_count     The index count
+       * @param[in]  low             The lowest corner of the geometry
+       * @param[in]  high            The highest corner of the geometry, z is -infinity without geometry
+       * @param[in]  first_vertex    The first vertex in the vertex buffer
+       * @param[in]  first_index     The first index in the index buffer
+       */
+      VertexRecord(const GLenum primitive_type = GL_TRIANGLES, const unsigned int vertex_count = 0, const unsigned int index_count = 0, const glm::vec3& low = glm::vec3(0.0), const glm::vec3& high = glm::vec3(0.0, 0.0, -std::numeric_limits<float>::infinity()), const unsigned int first_vertex = 0, const unsigned int first_index = 0) :
+        primitive_type(primitive_type), vertex_count(vertex_count), index_count(index_count), low(low), high(high), first_vertex(first_vertex), first_index(first_index) {}
+
+      /**
+       * @brief      Gets the primitive type.
+       *
+       * @return     The primitive type.
+       */
+      GLenum getPrimitiveType() const noexcept { return primitive_type; }
+      /**
+       * @brief      Gets the vertex count.
+       *
+       * @return     The vertex count.
+       */
+      unsigned int getVertexCount() const noexcept { return vertex_count; }
+      /**
+       * @brief      Gets the index count.
+       *
+       * @return     The index count.
+       */
+      unsigned int getIndexCount() const noexcept { return index_count; }
+      /**
+       * @brief      Gets the lowest corner of the geometry.
+       *
+       * @return     The lowest x, y and z.
+       */
+      glm::vec3 getLow() const noexcept { return low; }
+      /**
+       * @brief      Gets the highest corner of the geometry.
+       *
+       * @return     The highest x, y and z.
+       */
+      glm::vec3 getHigh() const noexcept { return high; }
+      /**
+       * @brief      Gets the highest z.
+       *
+       * @return     The highest z, -infinity without geometry.
+       */
+      float highestZ() const noexcept { return high.z; }
+      /**
+       * @brief      Gets the first vertex, where the vertices start in a shared buffer.
+       *
+       * @return     The first vertex.
+       */
+      unsigned int getFirstVertex() const noexcept { return first_vertex; }
+      /**
+       * @brief      Gets the first index, where the indices start in a shared buffer.
+       *
+       * @return     The first index.
+       */
+      unsigned int getFirstIndex() const noexcept { return first_index; }
+  };
+}
+
+#endif
@@ -9,4 +9,62 @@ namespace Utility {
                      atof(str.substr(first_comma + 1, second_comma - first_comma).c_str()),
                      atof(str.substr(second_comma + 1, str.size() - second_comma).c_str()));
   }
+
+  std::vector<unsigned int> decodeUTF8(const std::string& str) {
+    const unsigned int replacement = 0xFFFD;
+    std::vector<unsigned int> codepoints;
+    codepoints.reserve(str.size());
+
+    for(std::size_t i = 0; i < str.size();) {
+      auto lead = (unsigned char)str[i];
+      unsigned int codepoint = 0;
+      unsigned int continuation_bytes = 0;
+      unsigned int minimum = 0;
+
+      if(lead < 0x80) {
+        codepoints.push_back(lead);
+        i++;
+        continue;
+      }
+      else if((lead & 0xE0) == 0xC0) {
+        codepoint = lead & 0x1F;
+        continuation_bytes = 1;
+        minimum = 0x80;
+      }
+      else if((lead & 0xF0) == 0xE0) {
+        codepoint = lead & 0x0F;
+        continuation_bytes = 2;
+        minimum = 0x800;
+      }
+      else if((lead & 0xF8) == 0xF0) {
+        codepoint = lead & 0x07;
+        continuation_bytes = 3;
+        minimum = 0x10000;
+      }
+      else {
+        codepoints.push_back(replacement);
+        i++;
+        continue;
+      }
+
+      std::size_t consumed = 1;
+      bool valid = true;
+      for(; consumed <= continuation_bytes; consumed++) {
+        if(i + consumed >= str.size() || ((unsigned char)str[i + consumed] & 0xC0) != 0x80) {
+          valid = false;
+          break;
+        }
+        codepoint = (codepoint << 6) | ((unsigned char)str[i + consumed] & 0x3F);
+      }
+
+      //Overlong forms, surrogates and values past the unicode range are all malformed
+      if(!valid || codepoint < minimum || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF))
+        codepoints.push_back(replacement);
+      else
+        codepoints.push_back(codepoint);
+      i += consumed;
+    }
+
+    return codepoints;
+  }
 }
@@ -2,9 +2,18 @@
 #define UTILITY_FUNCTIONS_H
 #include <glm/glm.hpp>
 #include <string>
+#include <vector>
 
 namespace Utility {
   glm::vec3 stringToVec3(const std::string str); 
+  /**
+   * @brief      Decodes a UTF-8 string into codepoints.
+   *
+   * @param[in]  str   The UTF-8 string
+   *
+   * @return     The codepoints, malformed sequences decode to U+FFFD
+   */
+  std::vector<unsigned int> decodeUTF8(const std::string& str);
 }
 
 #endif